@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "LoadGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "jaegertracing/net/Socket.h"
+#include "jaegertracing/net/http/Response.h"
+
+namespace jaegertracing {
+namespace crossdock {
+namespace {
+
+nlohmann::json makeDownstream(const net::IPAddress& serverAddress,
+                              int hop,
+                              int numHops)
+{
+    nlohmann::json downstream = {
+        { "serviceName", "crossdock-cpp" },
+        { "serverRole", "S" + std::to_string(hop + 2) },
+        { "host", serverAddress.host() },
+        { "port", std::to_string(serverAddress.port()) },
+        { "transport", "HTTP" }
+    };
+    if (hop + 1 < numHops) {
+        downstream["downstream"] =
+            makeDownstream(serverAddress, hop + 1, numHops);
+    }
+    return downstream;
+}
+
+int64_t toMicroseconds(const LoadGenerator::Clock::duration& duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+}  // anonymous namespace
+
+LoadGenerator::Clock::duration LoadGenerator::Result::mean() const
+{
+    if (_latencies.empty()) {
+        return Clock::duration();
+    }
+    auto total = Clock::duration();
+    for (auto&& latency : _latencies) {
+        total += latency;
+    }
+    return total / _latencies.size();
+}
+
+LoadGenerator::Clock::duration
+LoadGenerator::Result::percentile(double quantile) const
+{
+    if (_latencies.empty()) {
+        return Clock::duration();
+    }
+    const auto index = static_cast<size_t>(quantile * (_latencies.size() - 1));
+    return _latencies[index];
+}
+
+double LoadGenerator::Result::requestsPerSecond() const
+{
+    const auto seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(_elapsed)
+            .count();
+    return (seconds > 0) ? (_latencies.size() + _numErrors) / seconds : 0;
+}
+
+LoadGenerator::LoadGenerator(const net::IPAddress& clientAddress,
+                             const net::IPAddress& serverAddress,
+                             int concurrency,
+                             int numRequests,
+                             int numHops)
+    : _clientAddress(clientAddress)
+    , _request()
+    , _concurrency(std::max(1, concurrency))
+    , _numRequests(numRequests)
+{
+    // A started trace always calls at least one downstream.
+    const nlohmann::json request = {
+        { "serverRole", "S1" },
+        { "sampled", true },
+        { "baggage", "load" },
+        { "downstream", makeDownstream(serverAddress, 0, std::max(1, numHops)) }
+    };
+    const auto body = request.dump();
+    std::ostringstream oss;
+    oss << "POST /start_trace HTTP/1.1\r\n"
+           "Host: "
+        << _clientAddress.authority()
+        << "\r\n"
+           "Connection: close\r\n"
+           "Content-Type: application/json\r\n"
+           "Content-Length: "
+        << body.size() << "\r\n\r\n"
+        << body;
+    _request = oss.str();
+}
+
+LoadGenerator::Result LoadGenerator::run() const
+{
+    std::atomic<int> nextRequest(0);
+    std::vector<std::vector<Clock::duration>> latencies(_concurrency);
+    std::vector<int> numErrors(_concurrency, 0);
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (auto i = 0; i < _concurrency; ++i) {
+        threads.emplace_back([this, i, &nextRequest, &latencies, &numErrors]() {
+            while (nextRequest++ < _numRequests) {
+                const auto requestStart = Clock::now();
+                if (sendRequest()) {
+                    latencies[i].push_back(Clock::now() - requestStart);
+                }
+                else {
+                    ++numErrors[i];
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    Result result;
+    result._elapsed = Clock::now() - start;
+    result._numErrors = 0;
+    for (auto i = 0; i < _concurrency; ++i) {
+        result._latencies.insert(std::end(result._latencies),
+                                 std::begin(latencies[i]),
+                                 std::end(latencies[i]));
+        result._numErrors += numErrors[i];
+    }
+    std::sort(std::begin(result._latencies), std::end(result._latencies));
+    return result;
+}
+
+bool LoadGenerator::sendRequest() const
+{
+    try {
+        net::Socket socket;
+        socket.open(AF_INET, SOCK_STREAM);
+        socket.connect(_clientAddress);
+        auto numWritten = static_cast<size_t>(0);
+        while (numWritten < _request.size()) {
+            const auto result = ::write(socket.handle(),
+                                        &_request[numWritten],
+                                        _request.size() - numWritten);
+            if (result <= 0) {
+                return false;
+            }
+            numWritten += result;
+        }
+
+        // The server closes the connection after the response.
+        std::array<char, 4096> buffer;
+        std::string responseStr;
+        auto numRead = ::read(socket.handle(), &buffer[0], buffer.size());
+        while (numRead > 0) {
+            responseStr.append(&buffer[0], numRead);
+            numRead = ::read(socket.handle(), &buffer[0], buffer.size());
+        }
+        std::istringstream iss(responseStr);
+        return net::http::Response::parse(iss).statusCode() == 200;
+    } catch (...) {
+        return false;
+    }
+}
+
+void LoadGenerator::printHeader(std::ostream& out)
+{
+    out << std::left << std::setw(10) << "tracer" << std::right
+        << std::setw(10) << "requests" << std::setw(8) << "errors"
+        << std::setw(10) << "req/s" << std::setw(10) << "mean(us)"
+        << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)"
+        << std::setw(14) << "overhead(us)" << '\n';
+}
+
+void LoadGenerator::print(std::ostream& out,
+                          const std::string& name,
+                          const Result& result,
+                          const Result* baseline)
+{
+    out << std::left << std::setw(10) << name << std::right
+        << std::setw(10) << result._latencies.size() << std::setw(8)
+        << result._numErrors << std::setw(10) << std::fixed
+        << std::setprecision(0) << result.requestsPerSecond()
+        << std::setw(10) << toMicroseconds(result.mean()) << std::setw(10)
+        << toMicroseconds(result.percentile(0.5)) << std::setw(10)
+        << toMicroseconds(result.percentile(0.99)) << std::setw(14);
+    if (baseline) {
+        out << toMicroseconds(result.mean() - baseline->mean());
+    }
+    else {
+        out << '-';
+    }
+    out << '\n';
+}
+
+}  // namespace crossdock
+}  // namespace jaegertracing
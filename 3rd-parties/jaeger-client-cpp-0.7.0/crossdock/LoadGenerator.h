@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_CROSSDOCK_LOADGENERATOR_H
+#define JAEGERTRACING_CROSSDOCK_LOADGENERATOR_H
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "jaegertracing/net/IPAddress.h"
+
+namespace jaegertracing {
+namespace crossdock {
+
+// Drives concurrent traced requests through a crossdock server. Every
+// request starts a trace at /start_trace on the client address, which is
+// then joined by `numHops` nested /join_trace calls on the server address,
+// so each hop injects and extracts the span context over HTTP.
+class LoadGenerator {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        Clock::duration mean() const;
+
+        // `quantile` in [0, 1].
+        Clock::duration percentile(double quantile) const;
+
+        double requestsPerSecond() const;
+
+        int _numErrors;
+        Clock::duration _elapsed;
+        // Latencies of successful requests, sorted.
+        std::vector<Clock::duration> _latencies;
+    };
+
+    LoadGenerator(const net::IPAddress& clientAddress,
+                  const net::IPAddress& serverAddress,
+                  int concurrency,
+                  int numRequests,
+                  int numHops);
+
+    Result run() const;
+
+    static void printHeader(std::ostream& out);
+
+    // Tracing overhead is the difference to `baseline` when given.
+    static void print(std::ostream& out,
+                      const std::string& name,
+                      const Result& result,
+                      const Result* baseline);
+
+  private:
+    bool sendRequest() const;
+
+    net::IPAddress _clientAddress;
+    std::string _request;
+    int _concurrency;
+    int _numRequests;
+};
+
+}  // namespace crossdock
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_CROSSDOCK_LOADGENERATOR_H
@@ -19,16 +19,22 @@
 #include <atomic>
 #include <cstdlib>
 #include <future>
+#include <iostream>
 #include <sstream>
 #include <thread>
 
 #include <nlohmann/json.hpp>
 
+#include "LoadGenerator.h"
 #include "jaegertracing/Tracer.h"
+#include "jaegertracing/metrics/NullStatsFactory.h"
 #include "jaegertracing/net/IPAddress.h"
 #include "jaegertracing/net/Socket.h"
 #include "jaegertracing/net/http/Request.h"
 #include "jaegertracing/net/http/Response.h"
+#include "jaegertracing/reporters/NullReporter.h"
+#include "jaegertracing/testutils/MockAgent.h"
+#include "jaegertracing/utils/EnvVariable.h"
 
 namespace jaegertracing {
 namespace crossdock {
@@ -203,10 +209,12 @@ std::string bufferedRead(net::Socket& socket)
     std::array<char, kBufferSize> buffer;
     std::string data;
     auto numRead = ::read(socket.handle(), &buffer[0], buffer.size());
-    data.append(&buffer[0], numRead);
-    while (numRead == kBufferSize) {
-        numRead = ::read(socket.handle(), &buffer[0], buffer.size());
+    while (numRead > 0) {
         data.append(&buffer[0], numRead);
+        if (numRead < kBufferSize) {
+            break;
+        }
+        numRead = ::read(socket.handle(), &buffer[0], buffer.size());
     }
     return data;
 }
@@ -257,8 +265,13 @@ class RequestWriter : public opentracing::HTTPHeadersWriter {
 
 thrift::ObservedSpan observeSpan(const opentracing::SpanContext& ctx)
 {
-    const auto& sc = static_cast<const SpanContext&>(ctx);
     thrift::ObservedSpan observedSpan;
+    // Untraced in the load mode baseline, which uses a no-op tracer.
+    const auto* scPtr = dynamic_cast<const SpanContext*>(&ctx);
+    if (!scPtr) {
+        return observedSpan;
+    }
+    const auto& sc = *scPtr;
     std::ostringstream oss;
     oss << sc.traceID();
     observedSpan.__set_traceId(oss.str());
@@ -401,6 +414,8 @@ class Server::SocketListener {
     {
         if (_running) {
             _running = false;
+            // Wakes the listener thread blocked in accept().
+            ::shutdown(_socket.handle(), SHUT_RDWR);
             _thread.join();
             _socket.close();
         }
@@ -425,7 +440,24 @@ class Server::SocketListener {
         TaskList tasks;
 
         while (_running) {
-            auto client = _socket.accept();
+            // Requests that are done are dropped so a long load run does not
+            // accumulate them.
+            while (!tasks.empty() &&
+                   tasks.front().wait_for(std::chrono::seconds(0)) ==
+                       std::future_status::ready) {
+                tasks.front().get();
+                tasks.pop_front();
+            }
+
+            net::Socket client;
+            try {
+                client = _socket.accept();
+            } catch (const std::system_error&) {
+                if (!_running) {
+                    break;
+                }
+                throw;
+            }
             auto future = std::async(
                 std::launch::async,
                 [this](net::Socket&& socket) {
@@ -509,6 +541,7 @@ class Server::EndToEndHandler {
     Config makeEndToEndConfig(const std::string& samplerType) const
     {
         return Config(false,
+                      false,
                       samplers::Config(samplerType,
                                        1.0,
                                        _samplingServerURL,
@@ -559,6 +592,28 @@ Server::Server(const net::IPAddress& clientIP,
 {
 }
 
+Server::Server(const net::IPAddress& clientIP,
+               const net::IPAddress& serverIP,
+               const std::shared_ptr<opentracing::Tracer>& tracer,
+               const std::shared_ptr<logging::Logger>& logger)
+    : _logger(logger)
+    , _tracer(tracer)
+    , _clientListener(
+          new SocketListener(clientIP,
+                             _logger,
+                             [this](const net::http::Request& request) {
+                                 return handleRequest(request);
+                             }))
+    , _serverListener(
+          new SocketListener(serverIP,
+                             _logger,
+                             [this](const net::http::Request& request) {
+                                 return handleRequest(request);
+                             }))
+    , _handler()
+{
+}
+
 Server::~Server() = default;
 
 void Server::serve()
@@ -586,6 +641,7 @@ std::string Server::handleJSON(
                "Content-Length: "
             << message.size() << "\r\n\r\n"
             << message;
+        return oss.str();
     }
 
     std::unique_ptr<opentracing::SpanContext> ctx(result->release());
@@ -742,7 +798,8 @@ std::string Server::generateTraces(const net::http::Request& requestHTTP)
         return oss.str();
     }
 
-    auto tracer = _handler->findOrMakeTracer(request._type);
+    auto tracer =
+        _handler ? _handler->findOrMakeTracer(request._type) : nullptr;
     if (!tracer) {
         const std::string message("Tracer is not initialized");
         std::ostringstream oss;
@@ -764,11 +821,101 @@ std::string Server::generateTraces(const net::http::Request& requestHTTP)
     return "HTTP/1.1 200 OK\r\n\r\n";
 }
 
+namespace {
+
+int loadParameter(const char* envVar, int defaultValue)
+{
+    const auto value = utils::EnvVariable::getIntVariable(envVar);
+    return (!value.first && value.second > 0) ? value.second : defaultValue;
+}
+
+}  // anonymous namespace
+
+int runLoad()
+{
+    const auto concurrency = loadParameter("LOAD_CONCURRENCY", 8);
+    const auto numRequests = loadParameter("LOAD_REQUESTS", 2000);
+    const auto numHops = loadParameter("LOAD_HOPS", 2);
+    const auto basePort = loadParameter("LOAD_PORT", 18080);
+
+    auto mockAgent = testutils::MockAgent::make();
+    mockAgent->start();
+    const Config config(
+        false,
+        false,
+        samplers::Config("const",
+                         1,
+                         "",
+                         0,
+                         samplers::Config::Clock::duration()),
+        reporters::Config(reporters::Config::kDefaultQueueSize,
+                          std::chrono::milliseconds(100),
+                          false,
+                          mockAgent->spanServerAddress().authority()));
+    const std::shared_ptr<logging::Logger> logger(logging::nullLogger());
+    metrics::NullStatsFactory factory;
+
+    // The same load runs untraced, traced without reporting and traced with
+    // spans sent to the mock agent. The untraced run is the baseline.
+    const std::vector<std::pair<std::string, std::shared_ptr<opentracing::Tracer>>>
+        tracers = {
+            { "none", opentracing::MakeNoopTracer() },
+            { "null",
+              Tracer::make(kDefaultTracerServiceName,
+                           config,
+                           logger,
+                           factory,
+                           0,
+                           std::make_shared<reporters::NullReporter>()) },
+            { "remote", Tracer::make(kDefaultTracerServiceName, config, logger) }
+        };
+
+    std::cout << "concurrency=" << concurrency << " requests=" << numRequests
+              << " hops=" << numHops << '\n';
+    LoadGenerator::printHeader(std::cout);
+    std::unique_ptr<LoadGenerator::Result> baseline;
+    for (auto i = 0; i < static_cast<int>(tracers.size()); ++i) {
+        const auto clientIP = net::IPAddress::v4("127.0.0.1", basePort + 2 * i);
+        const auto serverIP =
+            net::IPAddress::v4("127.0.0.1", basePort + 2 * i + 1);
+        Server server(clientIP, serverIP, tracers[i].second, logger);
+        server.serve();
+
+        // Warms up the server threads and the tracer before measuring.
+        LoadGenerator(clientIP, serverIP, concurrency, concurrency, numHops)
+            .run();
+        const auto result =
+            LoadGenerator(clientIP, serverIP, concurrency, numRequests, numHops)
+                .run();
+        LoadGenerator::print(
+            std::cout, tracers[i].first, result, baseline.get());
+        if (!baseline) {
+            baseline.reset(new LoadGenerator::Result(result));
+        }
+        tracers[i].second->Close();
+    }
+
+    // Closing the tracer flushed its reporter, give the datagrams time to
+    // arrive.
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    auto numSpans = 0;
+    for (auto&& batch : mockAgent->batches()) {
+        numSpans += batch.spans.size();
+    }
+    std::cout << "spans received by the mock agent: " << numSpans << '\n';
+    return 0;
+}
+
 }  // namespace crossdock
 }  // namespace jaegertracing
 
 int main()
 {
+    const auto rawMode = std::getenv("MODE");
+    if (rawMode && std::string(rawMode) == "load") {
+        return jaegertracing::crossdock::runLoad();
+    }
+
     const auto rawSenderType = std::getenv("SENDER");
     const std::string senderType(rawSenderType ? rawSenderType : "");
 
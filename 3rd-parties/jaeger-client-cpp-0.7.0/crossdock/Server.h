@@ -51,6 +51,13 @@ class Server {
            const std::string& collectorEndpoint,
            const std::string& samplingServerURL);
 
+    // Serves requests traced by `tracer`, without the end to end handler
+    // behind /create_traces. Used by the load mode.
+    Server(const net::IPAddress& clientIP,
+           const net::IPAddress& serverIP,
+           const std::shared_ptr<opentracing::Tracer>& tracer,
+           const std::shared_ptr<logging::Logger>& logger);
+
     ~Server();
 
     void serve();
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/BaggageMap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <stdexcept>
+
+namespace jaegertracing {
+
+BaggageMap::BaggageMap(std::initializer_list<value_type> items)
+    : _items()
+{
+    reserve(items.size());
+    for (auto&& item : items) {
+        // Like a map, keep the first value given for a key.
+        if (find(item.first) == end()) {
+            _items->push_back(item);
+        }
+    }
+}
+
+BaggageMap::BaggageMap(const StrMap& map)
+    : _items()
+{
+    if (!map.empty()) {
+        _items = std::make_shared<Items>(std::begin(map), std::end(map));
+    }
+}
+
+BaggageMap::const_iterator
+BaggageMap::find(opentracing::string_view key) const
+{
+    const auto& values = items();
+    return std::find_if(
+        std::begin(values), std::end(values), [key](const value_type& item) {
+            return opentracing::string_view(item.first) == key;
+        });
+}
+
+const std::string& BaggageMap::at(opentracing::string_view key) const
+{
+    const auto itr = find(key);
+    if (itr == end()) {
+        throw std::out_of_range("BaggageMap::at");
+    }
+    return itr->second;
+}
+
+std::string& BaggageMap::operator[](opentracing::string_view key)
+{
+    auto& values = mutableItems();
+    for (auto&& item : values) {
+        if (opentracing::string_view(item.first) == key) {
+            return item.second;
+        }
+    }
+    values.emplace_back(key, std::string());
+    return values.back().second;
+}
+
+void BaggageMap::reserve(size_t size)
+{
+    if (size > 0) {
+        mutableItems().reserve(size);
+    }
+}
+
+bool BaggageMap::operator==(const BaggageMap& rhs) const
+{
+    if (_items == rhs._items) {
+        return true;
+    }
+    if (size() != rhs.size()) {
+        return false;
+    }
+    for (auto&& item : items()) {
+        const auto itr = rhs.find(item.first);
+        if (itr == rhs.end() || itr->second != item.second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const BaggageMap::Items& BaggageMap::items() const
+{
+    static const Items kEmptyItems;
+    return _items ? *_items : kEmptyItems;
+}
+
+BaggageMap::Items& BaggageMap::mutableItems()
+{
+    if (!_items) {
+        _items = std::make_shared<Items>();
+    }
+    else if (_items.use_count() > 1) {
+        _items = std::make_shared<Items>(*_items);
+    }
+    else {
+        // use_count() is a relaxed load. Pairs with the release decrement of
+        // a copy destroyed on another thread, so its reads of the items
+        // happen before the writes made through this reference.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *_items;
+}
+
+}  // namespace jaegertracing
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_BAGGAGEMAP_H
+#define JAEGERTRACING_BAGGAGEMAP_H
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <opentracing/string_view.h>
+
+namespace jaegertracing {
+
+// Baggage items of a span context. Traces usually carry a handful of items
+// at most, so they are kept in a flat vector searched linearly instead of a
+// hash map. The vector is shared between copies and only copied when one of
+// them is modified, so child spans reuse their parent's baggage.
+class BaggageMap {
+  public:
+    using value_type = std::pair<std::string, std::string>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+    using iterator = const_iterator;
+    using StrMap = std::unordered_map<std::string, std::string>;
+
+    BaggageMap()
+        : _items()
+    {
+    }
+
+    BaggageMap(std::initializer_list<value_type> items);
+
+    // Implicit so callers can keep passing the map type used previously.
+    BaggageMap(const StrMap& map);
+
+    const_iterator begin() const { return items().begin(); }
+
+    const_iterator end() const { return items().end(); }
+
+    size_t size() const { return _items ? _items->size() : 0; }
+
+    bool empty() const { return size() == 0; }
+
+    const_iterator find(opentracing::string_view key) const;
+
+    size_t count(opentracing::string_view key) const
+    {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    // Throws std::out_of_range if key is missing.
+    const std::string& at(opentracing::string_view key) const;
+
+    // Inserts an empty value if key is missing. Copies shared storage first.
+    std::string& operator[](opentracing::string_view key);
+
+    void reserve(size_t size);
+
+    void clear() { _items.reset(); }
+
+    bool operator==(const BaggageMap& rhs) const;
+
+    bool operator!=(const BaggageMap& rhs) const { return !(*this == rhs); }
+
+  private:
+    using Items = std::vector<value_type>;
+
+    const Items& items() const;
+
+    Items& mutableItems();
+
+    std::shared_ptr<Items> _items;
+};
+
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_BAGGAGEMAP_H
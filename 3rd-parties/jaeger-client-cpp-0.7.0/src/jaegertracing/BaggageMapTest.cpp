@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/BaggageMap.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace jaegertracing {
+
+TEST(BaggageMap, testLookup)
+{
+    BaggageMap baggage{ { "key1", "value1" }, { "key2", "value2" } };
+    ASSERT_EQ(2, static_cast<int>(baggage.size()));
+    ASSERT_EQ("value1", baggage.at("key1"));
+    ASSERT_EQ(1, static_cast<int>(baggage.count("key2")));
+    ASSERT_EQ(std::end(baggage), baggage.find("key3"));
+    ASSERT_THROW(baggage.at("key3"), std::out_of_range);
+
+    baggage["key1"] = "value3";
+    baggage["key3"] = "value4";
+    ASSERT_EQ(3, static_cast<int>(baggage.size()));
+    ASSERT_EQ("value3", baggage.at("key1"));
+    ASSERT_EQ("value4", baggage.at("key3"));
+
+    baggage.clear();
+    ASSERT_TRUE(baggage.empty());
+    ASSERT_EQ(std::end(baggage), std::begin(baggage));
+}
+
+TEST(BaggageMap, testCopyOnWrite)
+{
+    BaggageMap parent{ { "key", "value" } };
+    BaggageMap child(parent);
+    ASSERT_EQ(&*std::begin(parent), &*std::begin(child));
+
+    child["key"] = "other";
+    ASSERT_NE(&*std::begin(parent), &*std::begin(child));
+    ASSERT_EQ("value", parent.at("key"));
+    ASSERT_EQ("other", child.at("key"));
+}
+
+TEST(BaggageMap, testEquality)
+{
+    const BaggageMap lhs{ { "a", "1" }, { "b", "2" } };
+    const BaggageMap rhs(BaggageMap::StrMap({ { "b", "2" }, { "a", "1" } }));
+    ASSERT_EQ(lhs, rhs);
+    ASSERT_NE(lhs, BaggageMap({ { "a", "1" } }));
+    ASSERT_NE(lhs, BaggageMap({ { "a", "1" }, { "b", "3" } }));
+    ASSERT_EQ(BaggageMap(), BaggageMap(BaggageMap::StrMap()));
+}
+
+}  // namespace jaegertracing
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/ClockSource.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define JAEGERTRACING_HAVE_TSC
+#endif
+
+namespace jaegertracing {
+namespace {
+
+// Coarse clock sources whose threads must be restarted after fork(). Leaked
+// so the atfork handlers never see it destroyed.
+struct CoarseClockRegistry {
+    std::mutex _mutex;
+    std::vector<CoarseClockSource*> _sources;
+    std::once_flag _handlersInstalled;
+};
+
+CoarseClockRegistry& coarseClockRegistry()
+{
+    static auto* registry = new CoarseClockRegistry();
+    return *registry;
+}
+
+}  // anonymous namespace
+
+constexpr int CoarseClockSource::kDefaultIntervalMicroseconds;
+
+ClockSource::Type ClockSource::parseType(const std::string& name)
+{
+    if (name == "coarse") {
+        return Type::kCoarse;
+    }
+    if (name == "tsc") {
+        return Type::kTSC;
+    }
+    return Type::kSystem;
+}
+
+std::unique_ptr<ClockSource>
+ClockSource::make(Type type,
+                  const std::chrono::microseconds& coarseInterval,
+                  logging::Logger& logger)
+{
+    switch (type) {
+    case Type::kCoarse:
+        return std::unique_ptr<ClockSource>(
+            new CoarseClockSource(coarseInterval));
+    case Type::kTSC: {
+        if (TSCClockSource::isAvailable()) {
+            return std::unique_ptr<ClockSource>(new TSCClockSource());
+        }
+        logger.error("Invariant TSC not available, using the system clock");
+    } break;
+    default:
+        break;
+    }
+    return std::unique_ptr<ClockSource>(new SystemClockSource());
+}
+
+CoarseClockSource::CoarseClockSource(
+    const std::chrono::microseconds& interval)
+    : _interval(interval.count() > 0
+                    ? interval
+                    : std::chrono::microseconds(kDefaultIntervalMicroseconds))
+    , _systemNow(0)
+    , _steadyNow(0)
+    , _forked(false)
+    , _running(true)
+    , _mutex()
+    , _cv()
+    , _thread()
+{
+    update();
+    _thread.reset(new std::thread([this]() { run(); }));
+
+    auto& registry = coarseClockRegistry();
+    std::lock_guard<std::mutex> lock(registry._mutex);
+    std::call_once(registry._handlersInstalled, []() {
+        ::pthread_atfork(&prepareFork, &parentAfterFork, &childAfterFork);
+    });
+    registry._sources.push_back(this);
+}
+
+CoarseClockSource::~CoarseClockSource()
+{
+    {
+        auto& registry = coarseClockRegistry();
+        std::lock_guard<std::mutex> lock(registry._mutex);
+        registry._sources.erase(std::remove(std::begin(registry._sources),
+                                            std::end(registry._sources),
+                                            this),
+                                std::end(registry._sources));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _cv.notify_one();
+    if (_thread) {
+        _thread->join();
+    }
+}
+
+void CoarseClockSource::prepareFork()
+{
+    auto& registry = coarseClockRegistry();
+    registry._mutex.lock();
+    for (auto* source : registry._sources) {
+        source->_mutex.lock();
+    }
+}
+
+void CoarseClockSource::parentAfterFork()
+{
+    auto& registry = coarseClockRegistry();
+    for (auto* source : registry._sources) {
+        source->_mutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void CoarseClockSource::childAfterFork()
+{
+    auto& registry = coarseClockRegistry();
+    for (auto* source : registry._sources) {
+        // The thread was not copied into the child, so its std::thread can
+        // be neither joined nor destroyed and is leaked.
+        source->_thread.release();
+        source->_forked.store(true, std::memory_order_relaxed);
+        source->_mutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void CoarseClockSource::restartAfterFork() const noexcept
+{
+    try {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_forked.load(std::memory_order_relaxed)) {
+            update();
+            if (_running) {
+                _thread.reset(new std::thread([this]() { run(); }));
+            }
+            _forked.store(false, std::memory_order_relaxed);
+        }
+    } catch (...) {
+        // Timestamps stay frozen at the last update.
+        _forked.store(false, std::memory_order_relaxed);
+    }
+}
+
+void CoarseClockSource::update() const
+{
+    _systemNow.store(SystemClock::now().time_since_epoch().count(),
+                     std::memory_order_relaxed);
+    _steadyNow.store(SteadyClock::now().time_since_epoch().count(),
+                     std::memory_order_relaxed);
+}
+
+void CoarseClockSource::run() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_cv.wait_for(lock, _interval, [this]() { return !_running; })) {
+        update();
+    }
+}
+
+bool TSCClockSource::isAvailable()
+{
+#ifdef JAEGERTRACING_HAVE_TSC
+    // CPUID leaf 0x80000007 reports an invariant TSC in bit 8 of EDX.
+    constexpr auto kAdvancedPowerManagementLeaf = 0x80000007u;
+    constexpr auto kInvariantTSCBit = 1u << 8;
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < kAdvancedPowerManagementLeaf) {
+        return false;
+    }
+    __get_cpuid(kAdvancedPowerManagementLeaf, &eax, &ebx, &ecx, &edx);
+    return (edx & kInvariantTSCBit) != 0;
+#else
+    return false;
+#endif  // JAEGERTRACING_HAVE_TSC
+}
+
+uint64_t TSCClockSource::readTSC()
+{
+#ifdef JAEGERTRACING_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif  // JAEGERTRACING_HAVE_TSC
+}
+
+TSCClockSource::TSCClockSource(const std::chrono::microseconds& calibrationTime)
+    : _tscBase(0)
+    , _systemBase()
+    , _steadyBase()
+    , _nanosecondsPerTick(0)
+{
+    if (!isAvailable()) {
+        throw std::logic_error("Invariant TSC not available");
+    }
+
+    _systemBase = SystemClock::now();
+    _steadyBase = SteadyClock::now();
+    _tscBase = readTSC();
+
+    // Sleeping rather than spinning keeps calibration off the CPU. The rate
+    // only needs the endpoints to be read close together.
+    std::this_thread::sleep_for(calibrationTime);
+    const auto steadyEnd = SteadyClock::now();
+    const auto tscEnd = readTSC();
+
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(steadyEnd -
+                                                             _steadyBase);
+    _nanosecondsPerTick = static_cast<double>(elapsed.count()) /
+                          static_cast<double>(tscEnd - _tscBase);
+}
+
+}  // namespace jaegertracing
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_CLOCKSOURCE_H
+#define JAEGERTRACING_CLOCKSOURCE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <opentracing/util.h>
+
+#include "jaegertracing/Compilers.h"
+#include "jaegertracing/Logging.h"
+
+namespace jaegertracing {
+
+// Source of span start, finish and log timestamps. The tracer reads it
+// several times per span, so the cheaper sources trade precision for speed.
+class ClockSource {
+  public:
+    using SystemClock = opentracing::SystemClock;
+    using SteadyClock = opentracing::SteadyClock;
+
+    enum class Type {
+        // Reads std::chrono clocks on every call.
+        kSystem,
+        // Returns a cached time refreshed by a background thread, so
+        // timestamps are only as precise as the refresh interval.
+        kCoarse,
+        // Scales the CPU timestamp counter. Falls back to kSystem on CPUs
+        // without an invariant TSC.
+        kTSC
+    };
+
+    static Type parseType(const std::string& name);
+
+    static std::unique_ptr<ClockSource>
+    make(Type type,
+         const std::chrono::microseconds& coarseInterval,
+         logging::Logger& logger);
+
+    virtual ~ClockSource() = default;
+
+    virtual SystemClock::time_point systemNow() const = 0;
+
+    virtual SteadyClock::time_point steadyNow() const = 0;
+};
+
+class SystemClockSource : public ClockSource {
+  public:
+    SystemClock::time_point systemNow() const override
+    {
+        return SystemClock::now();
+    }
+
+    SteadyClock::time_point steadyNow() const override
+    {
+        return SteadyClock::now();
+    }
+};
+
+// The refresh thread is restarted on the first read in a child process,
+// since fork() only copies the calling thread.
+class CoarseClockSource : public ClockSource {
+  public:
+    static constexpr auto kDefaultIntervalMicroseconds = 1000;
+
+    explicit CoarseClockSource(const std::chrono::microseconds& interval);
+
+    ~CoarseClockSource();
+
+    SystemClock::time_point systemNow() const override
+    {
+        restartIfForked();
+        return SystemClock::time_point(SystemClock::duration(
+            _systemNow.load(std::memory_order_relaxed)));
+    }
+
+    SteadyClock::time_point steadyNow() const override
+    {
+        restartIfForked();
+        return SteadyClock::time_point(SteadyClock::duration(
+            _steadyNow.load(std::memory_order_relaxed)));
+    }
+
+    const std::chrono::microseconds& interval() const { return _interval; }
+
+  private:
+    // pthread_atfork handlers. The child only marks the sources, the
+    // threads are started again by restartIfForked().
+    static void prepareFork();
+
+    static void parentAfterFork();
+
+    static void childAfterFork();
+
+    void restartIfForked() const
+    {
+        if (_forked.load(std::memory_order_relaxed)) {
+            restartAfterFork();
+        }
+    }
+
+    void restartAfterFork() const noexcept;
+
+    void update() const;
+
+    void run() const;
+
+    std::chrono::microseconds _interval;
+    mutable std::atomic<SystemClock::rep> _systemNow;
+    mutable std::atomic<SteadyClock::rep> _steadyNow;
+    // The refresh thread is restarted from the const readers after fork().
+    mutable std::atomic<bool> _forked;
+    mutable bool _running;
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _cv;
+    mutable std::unique_ptr<std::thread> _thread;
+};
+
+// Converts TSC readings to time with a rate measured at construction.
+// Wall clock time is anchored at calibration, so later adjustments to the
+// system clock are not seen by this source.
+class TSCClockSource : public ClockSource {
+  public:
+    // True on x86 CPUs whose TSC runs at a constant rate across frequency
+    // and power state changes.
+    static bool isAvailable();
+
+    static std::chrono::microseconds defaultCalibrationTime()
+    {
+        return std::chrono::milliseconds(10);
+    }
+
+    // Throws std::logic_error if !isAvailable().
+    explicit TSCClockSource(const std::chrono::microseconds& calibrationTime =
+                                defaultCalibrationTime());
+
+    SystemClock::time_point systemNow() const override
+    {
+        return _systemBase + std::chrono::duration_cast<SystemClock::duration>(
+                                 sinceCalibration());
+    }
+
+    SteadyClock::time_point steadyNow() const override
+    {
+        return _steadyBase + std::chrono::duration_cast<SteadyClock::duration>(
+                                 sinceCalibration());
+    }
+
+    double nanosecondsPerTick() const { return _nanosecondsPerTick; }
+
+  private:
+    static uint64_t readTSC();
+
+    std::chrono::nanoseconds sinceCalibration() const
+    {
+        return std::chrono::nanoseconds(static_cast<int64_t>(
+            static_cast<double>(readTSC() - _tscBase) * _nanosecondsPerTick));
+    }
+
+    uint64_t _tscBase;
+    SystemClock::time_point _systemBase;
+    SteadyClock::time_point _steadyBase;
+    double _nanosecondsPerTick;
+};
+
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_CLOCKSOURCE_H
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/ClockSource.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace jaegertracing {
+
+TEST(ClockSource, testParseType)
+{
+    ASSERT_EQ(ClockSource::Type::kSystem, ClockSource::parseType("system"));
+    ASSERT_EQ(ClockSource::Type::kCoarse, ClockSource::parseType("coarse"));
+    ASSERT_EQ(ClockSource::Type::kTSC, ClockSource::parseType("tsc"));
+    ASSERT_EQ(ClockSource::Type::kSystem, ClockSource::parseType("hpet"));
+}
+
+TEST(ClockSource, testCoarseClock)
+{
+    const auto interval = std::chrono::milliseconds(1);
+    CoarseClockSource clock(interval);
+    const auto steadyStart = clock.steadyNow();
+    const auto systemStart = clock.systemNow();
+    ASSERT_LE(steadyStart, ClockSource::SteadyClock::now());
+    ASSERT_LE(systemStart, ClockSource::SystemClock::now());
+
+    std::this_thread::sleep_for(interval * 20);
+    ASSERT_LT(steadyStart, clock.steadyNow());
+    ASSERT_LT(systemStart, clock.systemNow());
+    ASSERT_LE(clock.steadyNow(), ClockSource::SteadyClock::now());
+}
+
+TEST(ClockSource, testCoarseClockAfterFork)
+{
+    const auto interval = std::chrono::milliseconds(1);
+    CoarseClockSource clock(interval);
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        // The parent's refresh thread is gone, the child needs its own.
+        const auto steadyStart = clock.steadyNow();
+        std::this_thread::sleep_for(interval * 20);
+        std::_Exit(steadyStart < clock.steadyNow() ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    const auto steadyStart = clock.steadyNow();
+    std::this_thread::sleep_for(interval * 20);
+    ASSERT_LT(steadyStart, clock.steadyNow());
+}
+
+TEST(ClockSource, testTSCClock)
+{
+    if (!TSCClockSource::isAvailable()) {
+        ASSERT_THROW(TSCClockSource(), std::logic_error);
+        return;
+    }
+
+    TSCClockSource clock;
+    ASSERT_LT(0, clock.nanosecondsPerTick());
+    const auto tolerance = std::chrono::milliseconds(5);
+    for (auto i = 0; i < 3; ++i) {
+        const auto steadyNow = ClockSource::SteadyClock::now();
+        const auto tscNow = clock.steadyNow();
+        ASSERT_LT(steadyNow - tolerance, tscNow);
+        ASSERT_GT(steadyNow + tolerance, tscNow);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+TEST(ClockSource, testMake)
+{
+    auto logger = logging::nullLogger();
+    auto clock = ClockSource::make(
+        ClockSource::Type::kCoarse, std::chrono::microseconds(100), *logger);
+    ASSERT_NE(nullptr, dynamic_cast<CoarseClockSource*>(clock.get()));
+
+    clock = ClockSource::make(
+        ClockSource::Type::kTSC, std::chrono::microseconds(0), *logger);
+    if (TSCClockSource::isAvailable()) {
+        ASSERT_NE(nullptr, dynamic_cast<TSCClockSource*>(clock.get()));
+    }
+    else {
+        ASSERT_NE(nullptr, dynamic_cast<SystemClockSource*>(clock.get()));
+    }
+}
+
+}  // namespace jaegertracing
@@ -23,6 +23,9 @@ namespace jaegertracing {
 constexpr const char* Config::kJAEGER_SERVICE_NAME_ENV_PROP;
 constexpr const char* Config::kJAEGER_TAGS_ENV_PROP;
 constexpr const char* Config::kJAEGER_JAEGER_DISABLED_ENV_PROP;
+constexpr const char* Config::kJAEGER_CLOCK_ENV_PROP;
+constexpr const char* Config::kJAEGER_CLOCK_COARSE_INTERVAL_ENV_PROP;
+constexpr const char* Config::kJAEGER_SINGLE_OWNER_SPANS_ENV_PROP;
 
 void Config::fromEnv()
 {
@@ -44,6 +47,27 @@ void Config::fromEnv()
         _propagationFormat = parsePropagationFormat(propagationFormat);
     }
 
+    const auto clockType =
+        utils::EnvVariable::getStringVariable(kJAEGER_CLOCK_ENV_PROP);
+    if (!clockType.empty()) {
+        _clockType = ClockSource::parseType(clockType);
+    }
+
+    const auto clockCoarseInterval = utils::EnvVariable::getIntVariable(
+        kJAEGER_CLOCK_COARSE_INTERVAL_ENV_PROP);
+    if (!clockCoarseInterval.first) {
+        if (clockCoarseInterval.second > 0) {
+            _clockCoarseInterval =
+                std::chrono::microseconds(clockCoarseInterval.second);
+        }
+    }
+
+    const auto singleOwnerSpans = utils::EnvVariable::getBoolVariable(
+        kJAEGER_SINGLE_OWNER_SPANS_ENV_PROP);
+    if (singleOwnerSpans.first) {
+        _singleOwnerSpans = singleOwnerSpans.second;
+    }
+
     const auto serviceName =
         utils::EnvVariable::getStringVariable(kJAEGER_SERVICE_NAME_ENV_PROP);
     if (!serviceName.empty()) {
@@ -74,6 +98,7 @@ void Config::fromEnv()
     }
     _reporter.fromEnv();
     _sampler.fromEnv();
+    _logLimits.fromEnv();
 }
 
 propagation::Format
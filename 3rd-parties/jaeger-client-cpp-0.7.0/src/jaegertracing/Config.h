@@ -17,8 +17,10 @@
 #ifndef JAEGERTRACING_CONFIG_H
 #define JAEGERTRACING_CONFIG_H
 
+#include "jaegertracing/ClockSource.h"
 #include "jaegertracing/Compilers.h"
 #include "jaegertracing/Constants.h"
+#include "jaegertracing/LogLimits.h"
 #include "jaegertracing/Tag.h"
 #include "jaegertracing/baggage/RestrictionsConfig.h"
 #include "jaegertracing/propagation/HeadersConfig.h"
@@ -37,6 +39,9 @@ class Config {
     static constexpr auto kJAEGER_JAEGER_DISABLED_ENV_PROP = "JAEGER_DISABLED";
     static constexpr auto kJAEGER_JAEGER_TRACEID_128BIT_ENV_PROP = "JAEGER_TRACEID_128BIT";
     static constexpr auto kJAEGER_PROPAGATION_ENV_PROP = "JAEGER_PROPAGATION";
+    static constexpr auto kJAEGER_CLOCK_ENV_PROP = "JAEGER_CLOCK";
+    static constexpr auto kJAEGER_CLOCK_COARSE_INTERVAL_ENV_PROP = "JAEGER_CLOCK_COARSE_INTERVAL";
+    static constexpr auto kJAEGER_SINGLE_OWNER_SPANS_ENV_PROP = "JAEGER_SINGLE_OWNER_SPANS";
 
 #ifdef JAEGERTRACING_WITH_YAML_CPP
 
@@ -59,6 +64,16 @@ class Config {
             parsePropagationFormat(utils::yaml::findOrDefault<std::string>(
                 configYAML, "propagation_format", "jaeger"));
 
+        const auto clockType =
+            ClockSource::parseType(utils::yaml::findOrDefault<std::string>(
+                configYAML, "clock", "system"));
+        const auto clockCoarseInterval =
+            std::chrono::microseconds(utils::yaml::findOrDefault<int>(
+                configYAML, "clock_coarse_interval", 0));
+
+        const auto singleOwnerSpans = utils::yaml::findOrDefault<bool>(
+            configYAML, "single_owner_spans", false);
+
         const auto samplerNode = configYAML["sampler"];
         const auto sampler = samplers::Config::parse(samplerNode);
         const auto reporterNode = configYAML["reporter"];
@@ -68,6 +83,8 @@ class Config {
         const auto baggageRestrictionsNode = configYAML["baggage_restrictions"];
         const auto baggageRestrictions =
             baggage::RestrictionsConfig::parse(baggageRestrictionsNode);
+        const auto logLimitsNode = configYAML["log_limits"];
+        const auto logLimits = LogLimits::parse(logLimitsNode);
         return Config(disabled,
                       traceId128Bit,
                       sampler,
@@ -76,7 +93,11 @@ class Config {
                       baggageRestrictions,
                       serviceName,
                       std::vector<Tag>(),
-                      propagationFormat);
+                      propagationFormat,
+                      clockType,
+                      clockCoarseInterval,
+                      singleOwnerSpans,
+                      logLimits);
     }
 
 #endif  // JAEGERTRACING_WITH_YAML_CPP
@@ -92,7 +113,13 @@ class Config {
                     const std::string& serviceName = "",
                     const std::vector<Tag>&  tags = std::vector<Tag>(),
                     const propagation::Format propagationFormat =
-                        propagation::Format::JAEGER)
+                        propagation::Format::JAEGER,
+                    ClockSource::Type clockType = ClockSource::Type::kSystem,
+                    const std::chrono::microseconds& clockCoarseInterval =
+                        std::chrono::microseconds(
+                            CoarseClockSource::kDefaultIntervalMicroseconds),
+                    bool singleOwnerSpans = false,
+                    const LogLimits& logLimits = LogLimits())
         : _disabled(disabled)
         , _traceId128Bit(traceId128Bit)
         , _propagationFormat(propagationFormat)
@@ -102,6 +129,14 @@ class Config {
         , _reporter(reporter)
         , _headers(headers)
         , _baggageRestrictions(baggageRestrictions)
+        , _clockType(clockType)
+        , _clockCoarseInterval(
+              clockCoarseInterval.count() > 0
+                  ? clockCoarseInterval
+                  : std::chrono::microseconds(
+                        CoarseClockSource::kDefaultIntervalMicroseconds))
+        , _singleOwnerSpans(singleOwnerSpans)
+        , _logLimits(logLimits)
     {
     }
 
@@ -126,6 +161,21 @@ class Config {
 
     const std::vector<Tag>& tags() const { return _tags; }
 
+    // Source of span timestamps, chosen when the tracer is made.
+    ClockSource::Type clockType() const { return _clockType; }
+
+    // Refresh interval of ClockSource::Type::kCoarse.
+    const std::chrono::microseconds& clockCoarseInterval() const
+    {
+        return _clockCoarseInterval;
+    }
+
+    // Whether spans skip their mutex because each is only used by one
+    // thread at a time.
+    bool singleOwnerSpans() const { return _singleOwnerSpans; }
+
+    const LogLimits& logLimits() const { return _logLimits; }
+
     void fromEnv();
 
   private:
@@ -141,6 +191,10 @@ class Config {
     reporters::Config _reporter;
     propagation::HeadersConfig _headers;
     baggage::RestrictionsConfig _baggageRestrictions;
+    ClockSource::Type _clockType;
+    std::chrono::microseconds _clockCoarseInterval;
+    bool _singleOwnerSpans;
+    LogLimits _logLimits;
 };
 
 }  // namespace jaegertracing
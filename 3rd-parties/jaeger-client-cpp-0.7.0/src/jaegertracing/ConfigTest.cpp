@@ -107,6 +107,38 @@ propagation_format: w3c
     }
 }
 
+TEST(Config, testClock)
+{
+    constexpr auto kConfigYAML = R"cfg(
+clock: coarse
+clock_coarse_interval: 250
+)cfg";
+    const auto config = Config::parse(YAML::Load(kConfigYAML));
+    ASSERT_EQ(ClockSource::Type::kCoarse, config.clockType());
+    ASSERT_EQ(std::chrono::microseconds(250), config.clockCoarseInterval());
+}
+
+TEST(Config, testSingleOwnerSpans)
+{
+    ASSERT_FALSE(Config::parse(YAML::Load("disabled: false"))
+                     .singleOwnerSpans());
+    ASSERT_TRUE(Config::parse(YAML::Load("single_owner_spans: true"))
+                    .singleOwnerSpans());
+}
+
+TEST(Config, testLogLimits)
+{
+    constexpr auto kConfigYAML = R"cfg(
+log_limits:
+    maxLogs: 50
+    repeatedEventRate: 4
+)cfg";
+    const auto config = Config::parse(YAML::Load(kConfigYAML));
+    ASSERT_EQ(50, config.logLimits().maxLogs());
+    ASSERT_EQ(LogLimits::kDefaultMaxLogBytes, config.logLimits().maxLogBytes());
+    ASSERT_EQ(4, config.logLimits().repeatedEventRate());
+}
+
 #endif  // JAEGERTRACING_WITH_YAML_CPP
 
 TEST(Config, testFromEnv)
@@ -202,6 +234,25 @@ TEST(Config, testFromEnv)
     config.fromEnv();
     ASSERT_EQ(propagation::Format::W3C, config.propagationFormat());
 
+    testutils::EnvVariable::setEnv("JAEGER_CLOCK", "tsc");
+    testutils::EnvVariable::setEnv("JAEGER_CLOCK_COARSE_INTERVAL", "500");
+
+    config.fromEnv();
+    ASSERT_EQ(ClockSource::Type::kTSC, config.clockType());
+    ASSERT_EQ(std::chrono::microseconds(500), config.clockCoarseInterval());
+
+    testutils::EnvVariable::setEnv("JAEGER_SINGLE_OWNER_SPANS", "true");
+
+    config.fromEnv();
+    ASSERT_TRUE(config.singleOwnerSpans());
+
+    testutils::EnvVariable::setEnv("JAEGER_SPAN_MAX_LOGS", "20");
+    testutils::EnvVariable::setEnv("JAEGER_SPAN_REPEATED_LOG_RATE", "5");
+
+    config.fromEnv();
+    ASSERT_EQ(20, config.logLimits().maxLogs());
+    ASSERT_EQ(5, config.logLimits().repeatedEventRate());
+
     testutils::EnvVariable::setEnv("JAEGER_AGENT_HOST", "");
     testutils::EnvVariable::setEnv("JAEGER_AGENT_PORT", "");
     testutils::EnvVariable::setEnv("JAEGER_ENDPOINT", "");
@@ -215,6 +266,11 @@ TEST(Config, testFromEnv)
     testutils::EnvVariable::setEnv("JAEGER_DISABLED", "");
     testutils::EnvVariable::setEnv("JAEGER_TRACE_ID_128BIT", "");
     testutils::EnvVariable::setEnv("JAEGER_PROPAGATION", "");
+    testutils::EnvVariable::setEnv("JAEGER_CLOCK", "");
+    testutils::EnvVariable::setEnv("JAEGER_CLOCK_COARSE_INTERVAL", "");
+    testutils::EnvVariable::setEnv("JAEGER_SINGLE_OWNER_SPANS", "");
+    testutils::EnvVariable::setEnv("JAEGER_SPAN_MAX_LOGS", "");
+    testutils::EnvVariable::setEnv("JAEGER_SPAN_REPEATED_LOG_RATE", "");
 }
 
 }  // namespace jaegertracing
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/LogLimits.h"
+#include "jaegertracing/utils/EnvVariable.h"
+
+namespace jaegertracing {
+
+constexpr const char* LogLimits::kJAEGER_SPAN_MAX_LOGS_ENV_PROP;
+constexpr const char* LogLimits::kJAEGER_SPAN_MAX_LOG_BYTES_ENV_PROP;
+constexpr const char* LogLimits::kJAEGER_SPAN_REPEATED_LOG_BURST_ENV_PROP;
+constexpr const char* LogLimits::kJAEGER_SPAN_REPEATED_LOG_RATE_ENV_PROP;
+constexpr uint32_t LogLimits::kDefaultMaxLogs;
+constexpr uint32_t LogLimits::kDefaultMaxLogBytes;
+constexpr uint32_t LogLimits::kDefaultRepeatedEventBurst;
+
+void LogLimits::fromEnv()
+{
+    const auto maxLogs =
+        utils::EnvVariable::getIntVariable(kJAEGER_SPAN_MAX_LOGS_ENV_PROP);
+    if (!maxLogs.first) {
+        if (maxLogs.second > 0) {
+            _maxLogs = maxLogs.second;
+        }
+    }
+
+    const auto maxLogBytes =
+        utils::EnvVariable::getIntVariable(kJAEGER_SPAN_MAX_LOG_BYTES_ENV_PROP);
+    if (!maxLogBytes.first) {
+        if (maxLogBytes.second > 0) {
+            _maxLogBytes = maxLogBytes.second;
+        }
+    }
+
+    const auto repeatedEventBurst = utils::EnvVariable::getIntVariable(
+        kJAEGER_SPAN_REPEATED_LOG_BURST_ENV_PROP);
+    if (!repeatedEventBurst.first) {
+        if (repeatedEventBurst.second > 0) {
+            _repeatedEventBurst = repeatedEventBurst.second;
+        }
+    }
+
+    const auto repeatedEventRate = utils::EnvVariable::getIntVariable(
+        kJAEGER_SPAN_REPEATED_LOG_RATE_ENV_PROP);
+    if (!repeatedEventRate.first) {
+        if (repeatedEventRate.second > 0) {
+            _repeatedEventRate = repeatedEventRate.second;
+        }
+    }
+}
+
+}  // namespace jaegertracing
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_LOGLIMITS_H
+#define JAEGERTRACING_LOGLIMITS_H
+
+#include "jaegertracing/Constants.h"
+#include "jaegertracing/utils/YAML.h"
+#include <cstdint>
+
+namespace jaegertracing {
+
+// Bounds the logs a single span keeps, so a runaway loop logging to a
+// long-lived span cannot exhaust memory. Logs past `maxLogs` or
+// `maxLogBytes` are dropped and counted in the `kDroppedLogsTagKey` tag.
+// When `repeatedEventRate` is set, a span also keeps only the first
+// `repeatedEventBurst` logs with the same "event" field and one in every
+// `repeatedEventRate` after that.
+class LogLimits {
+  public:
+    static constexpr auto kJAEGER_SPAN_MAX_LOGS_ENV_PROP =
+        "JAEGER_SPAN_MAX_LOGS";
+    static constexpr auto kJAEGER_SPAN_MAX_LOG_BYTES_ENV_PROP =
+        "JAEGER_SPAN_MAX_LOG_BYTES";
+    static constexpr auto kJAEGER_SPAN_REPEATED_LOG_BURST_ENV_PROP =
+        "JAEGER_SPAN_REPEATED_LOG_BURST";
+    static constexpr auto kJAEGER_SPAN_REPEATED_LOG_RATE_ENV_PROP =
+        "JAEGER_SPAN_REPEATED_LOG_RATE";
+
+    static constexpr uint32_t kDefaultMaxLogs = 1000;
+    static constexpr uint32_t kDefaultMaxLogBytes = 1024 * 1024;
+    static constexpr uint32_t kDefaultRepeatedEventBurst = 10;
+
+#ifdef JAEGERTRACING_WITH_YAML_CPP
+
+    static LogLimits parse(const YAML::Node& configYAML)
+    {
+        if (!configYAML.IsDefined() || !configYAML.IsMap()) {
+            return LogLimits();
+        }
+
+        const auto maxLogs = utils::yaml::findOrDefault<uint32_t>(
+            configYAML, "maxLogs", kDefaultMaxLogs);
+        const auto maxLogBytes = utils::yaml::findOrDefault<uint32_t>(
+            configYAML, "maxLogBytes", kDefaultMaxLogBytes);
+        const auto repeatedEventBurst = utils::yaml::findOrDefault<uint32_t>(
+            configYAML, "repeatedEventBurst", kDefaultRepeatedEventBurst);
+        const auto repeatedEventRate = utils::yaml::findOrDefault<uint32_t>(
+            configYAML, "repeatedEventRate", 0);
+        return LogLimits(
+            maxLogs, maxLogBytes, repeatedEventBurst, repeatedEventRate);
+    }
+
+#endif  // JAEGERTRACING_WITH_YAML_CPP
+
+    explicit LogLimits(uint32_t maxLogs = kDefaultMaxLogs,
+                       uint32_t maxLogBytes = kDefaultMaxLogBytes,
+                       uint32_t repeatedEventBurst = kDefaultRepeatedEventBurst,
+                       uint32_t repeatedEventRate = 0)
+        : _maxLogs(maxLogs)
+        , _maxLogBytes(maxLogBytes)
+        , _repeatedEventBurst(repeatedEventBurst)
+        , _repeatedEventRate(repeatedEventRate)
+    {
+    }
+
+    uint32_t maxLogs() const { return _maxLogs; }
+
+    // Measured with `LogRecord::estimatedSize`.
+    uint32_t maxLogBytes() const { return _maxLogBytes; }
+
+    uint32_t repeatedEventBurst() const { return _repeatedEventBurst; }
+
+    // Zero disables sampling of repeated events.
+    uint32_t repeatedEventRate() const { return _repeatedEventRate; }
+
+    // Whether the `count`-th log of one event is kept, counting from 1.
+    bool sampleRepeatedEvent(uint32_t count) const
+    {
+        if (_repeatedEventRate == 0 || count <= _repeatedEventBurst) {
+            return true;
+        }
+        return (count - _repeatedEventBurst) % _repeatedEventRate == 0;
+    }
+
+    void fromEnv();
+
+  private:
+    uint32_t _maxLogs;
+    uint32_t _maxLogBytes;
+    uint32_t _repeatedEventBurst;
+    uint32_t _repeatedEventRate;
+};
+
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_LOGLIMITS_H
@@ -16,6 +16,7 @@
 
 #include "jaegertracing/LogRecord.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 
 namespace jaegertracing {
 void LogRecord::thrift(thrift::Log& log) const
@@ -36,4 +37,20 @@ void LogRecord::thrift(thrift::Log& log) const
                    });
     log.__set_fields(fields);
 }
+
+void LogRecord::encode(utils::ThriftWriter& writer) const
+{
+    using Type = utils::ThriftWriter::Type;
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kI64, 1);
+    writer.writeI64(std::chrono::duration_cast<std::chrono::microseconds>(
+                        _timestamp.time_since_epoch())
+                        .count());
+    writer.writeFieldBegin(Type::kList, 2);
+    writer.writeListBegin(Type::kStruct, _fields.size());
+    for (auto&& field : _fields) {
+        field.encode(writer);
+    }
+    writer.writeStructEnd();
+}
 }  // namespace jaegertracing
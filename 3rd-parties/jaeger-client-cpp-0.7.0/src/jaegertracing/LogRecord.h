@@ -32,6 +32,10 @@ namespace thrift {
 class Log;
 }
 
+namespace utils {
+class ThriftWriter;
+}
+
 class LogRecord {
   public:
     using Clock = std::chrono::system_clock;
@@ -62,6 +66,17 @@ class LogRecord {
 
     void thrift(thrift::Log& log) const;
 
+    void encode(utils::ThriftWriter& writer) const;
+
+    size_t estimatedSize() const
+    {
+        auto size = sizeof(LogRecord);
+        for (auto&& field : _fields) {
+            size += field.estimatedSize();
+        }
+        return size;
+    }
+
   private:
     Clock::time_point _timestamp;
     std::vector<Tag> _fields;
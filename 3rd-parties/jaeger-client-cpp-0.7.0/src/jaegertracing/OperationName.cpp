@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/OperationName.h"
+
+#include <tuple>
+
+namespace jaegertracing {
+
+utils::StringPool& OperationName::pool()
+{
+    // Intentionally leaked so spans finished during static destruction can
+    // still refer to their names.
+    static auto* pool = new utils::StringPool();
+    return *pool;
+}
+
+OperationName::OperationName(opentracing::string_view name)
+    : _id(utils::StringPool::kNotInterned)
+    , _interned(nullptr)
+    , _name()
+{
+    std::tie(_id, _interned) = pool().intern(name);
+    if (!_interned) {
+        _name = name;
+    }
+}
+
+}  // namespace jaegertracing
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_OPERATIONNAME_H
+#define JAEGERTRACING_OPERATIONNAME_H
+
+#include <string>
+
+#include <opentracing/string_view.h>
+
+#include "jaegertracing/utils/StringPool.h"
+
+namespace jaegertracing {
+
+// Handle to an operation name interned in a process-wide pool. Copying a
+// handle never copies the name, and samplers can key on `id()` instead of
+// hashing the string for every span. Names that do not fit in the pool are
+// held by value and report `isInterned() == false`.
+class OperationName {
+  public:
+    using ID = utils::StringPool::ID;
+
+    static utils::StringPool& pool();
+
+    OperationName()
+        : _id(utils::StringPool::kNotInterned)
+        , _interned(nullptr)
+        , _name()
+    {
+    }
+
+    explicit OperationName(opentracing::string_view name);
+
+    ID id() const { return _id; }
+
+    bool isInterned() const { return _interned != nullptr; }
+
+    const std::string& str() const { return _interned ? *_interned : _name; }
+
+    opentracing::string_view view() const
+    {
+        const auto& name = str();
+        return opentracing::string_view(name.data(), name.size());
+    }
+
+    void swap(OperationName& operationName)
+    {
+        using std::swap;
+        swap(_id, operationName._id);
+        swap(_interned, operationName._interned);
+        swap(_name, operationName._name);
+    }
+
+    friend void swap(OperationName& lhs, OperationName& rhs) { lhs.swap(rhs); }
+
+    bool operator==(const OperationName& rhs) const
+    {
+        if (_interned && rhs._interned) {
+            return _id == rhs._id;
+        }
+        return str() == rhs.str();
+    }
+
+    bool operator!=(const OperationName& rhs) const { return !(*this == rhs); }
+
+  private:
+    ID _id;
+    const std::string* _interned;
+    std::string _name;
+};
+
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_OPERATIONNAME_H
@@ -16,26 +16,50 @@
 
 #include "jaegertracing/Reference.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 
 namespace jaegertracing {
-void Reference::thrift(thrift::SpanRef& spanRef) const
+namespace {
+
+thrift::SpanRefType::type refType(const Reference& reference)
 {
-    switch (_type) {
-    case Type::ChildOfRef: {
-        spanRef.__set_refType(thrift::SpanRefType::CHILD_OF);
-    } break;
-    case Type::FollowsFromRef: {
-        spanRef.__set_refType(thrift::SpanRefType::FOLLOWS_FROM);
-    } break;
+    switch (reference.type()) {
+    case Reference::Type::ChildOfRef:
+        return thrift::SpanRefType::CHILD_OF;
+    case Reference::Type::FollowsFromRef:
+        return thrift::SpanRefType::FOLLOWS_FROM;
     default: {
         std::ostringstream oss;
-        oss << "Invalid span reference type " << static_cast<int>(_type)
-            << ", context " << _spanContext;
+        oss << "Invalid span reference type "
+            << static_cast<int>(reference.type()) << ", context "
+            << reference.spanContext();
         throw std::invalid_argument(oss.str());
-    } break;
     }
+    }
+}
+
+}  // anonymous namespace
+
+void Reference::thrift(thrift::SpanRef& spanRef) const
+{
+    spanRef.__set_refType(refType(*this));
     spanRef.__set_traceIdHigh(_spanContext.traceID().high());
     spanRef.__set_traceIdLow(_spanContext.traceID().low());
     spanRef.__set_spanId(_spanContext.spanID());
 }
+
+void Reference::encode(utils::ThriftWriter& writer) const
+{
+    using Type = utils::ThriftWriter::Type;
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kI32, 1);
+    writer.writeI32(refType(*this));
+    writer.writeFieldBegin(Type::kI64, 2);
+    writer.writeI64(_spanContext.traceID().low());
+    writer.writeFieldBegin(Type::kI64, 3);
+    writer.writeI64(_spanContext.traceID().high());
+    writer.writeFieldBegin(Type::kI64, 4);
+    writer.writeI64(_spanContext.spanID());
+    writer.writeStructEnd();
+}
 }  // namespace jaegertracing
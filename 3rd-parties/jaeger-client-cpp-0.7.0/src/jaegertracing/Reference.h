@@ -30,6 +30,10 @@ namespace thrift {
 class SpanRef;
 }
 
+namespace utils {
+class ThriftWriter;
+}
+
 class Reference {
   public:
     using Type = opentracing::SpanReferenceType;
@@ -46,6 +50,8 @@ class Reference {
 
     void thrift(thrift::SpanRef& spanRef) const;
 
+    void encode(utils::ThriftWriter& writer) const;
+
   private:
     SpanContext _spanContext;
     Type _type;
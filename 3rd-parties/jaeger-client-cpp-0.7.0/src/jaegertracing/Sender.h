@@ -42,12 +42,40 @@ class Sender {
         int _numFailed;
     };
 
+    // Thrown by append() when the span itself cannot be sent, e.g. it does
+    // not fit in a batch. The span was not added, every other one is intact.
+    class RejectedSpan : public Exception {
+      public:
+        explicit RejectedSpan(const std::string& what)
+            : Exception(what, 1)
+        {
+        }
+    };
+
     virtual ~Sender() = default;
 
     virtual int append(const Span& span) = 0;
 
     virtual int flush() = 0;
 
+    // Number of the spans returned by the last append() or flush() that were
+    // stored for a later retry instead of being sent.
+    virtual int numDeferred() const { return 0; }
+
+    // fork() handlers, called with the sender not in use. prepareFork()
+    // must leave it consistent for the child. childAfterFork() runs in the
+    // child before any other call and must not allocate or start threads.
+    virtual void prepareFork() {}
+
+    virtual void parentAfterFork() {}
+
+    virtual void childAfterFork() {}
+
+    // Called in a forked child before the sender is used again. Drops the
+    // spans the parent still sends, and connections or files shared with
+    // the parent.
+    virtual void resetAfterFork() {}
+
     virtual void close() = 0;
 };
 
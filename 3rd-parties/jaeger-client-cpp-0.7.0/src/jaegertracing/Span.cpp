@@ -18,6 +18,8 @@
 #include "jaegertracing/Tracer.h"
 #include "jaegertracing/baggage/BaggageSetter.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/ThriftWriter.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <istream>
@@ -62,12 +64,35 @@ struct SamplingPriorityVisitor {
     }
 };
 
+// The string of an event value, or a view without data for other values.
+struct EventVisitor {
+    using result_type = opentracing::string_view;
+
+    result_type operator()(const std::string& str) const { return str; }
+
+    result_type operator()(opentracing::string_view str) const { return str; }
+
+    result_type operator()(const char* str) const
+    {
+        return str ? result_type(str) : result_type();
+    }
+
+    template <typename OtherType>
+    result_type operator()(OtherType) const
+    {
+        return result_type();
+    }
+};
+
 }  // anonymous namespace
 
 void Span::SetBaggageItem(opentracing::string_view restrictedKey,
                           opentracing::string_view value) noexcept
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto lock = writeLock();
+    if (isFinished()) {
+        return;
+    }
     const auto& baggageSetter = _tracer->baggageSetter();
     auto baggage = _context.baggage();
     baggageSetter.setBaggage(*this,
@@ -76,7 +101,7 @@ void Span::SetBaggageItem(opentracing::string_view restrictedKey,
                              value,
                              [this](std::vector<Tag>::const_iterator first,
                                     std::vector<Tag>::const_iterator last) {
-                                 logFieldsNoLocking(SystemClock::now(), first, last);
+                                 logFieldsNoLocking(systemNow(), first, last);
                              });
     _context = _context.withBaggage(baggage);
 }
@@ -86,39 +111,43 @@ void Span::FinishWithOptions(
 {
     const auto finishTimeSteady =
         (finishSpanOptions.finish_steady_timestamp == SteadyClock::time_point())
-            ? SteadyClock::now()
+            ? steadyNow()
             : finishSpanOptions.finish_steady_timestamp;
-    std::shared_ptr<const Tracer> tracer;
     {
-
-        std::lock_guard<std::mutex> lock(_mutex);
+        // Orders the finish after any write in flight on another thread.
+        const auto lock = writeLock();
         if (isFinished()) {
             // Already finished, so return immediately.
             return;
         }
         _duration = finishTimeSteady - _startTimeSteady;
         if (_duration <= SteadyClock::duration()) {
-            // Enforce minimum duration of 1 tick (1ns on Linux),
-            // so isFinished() returns true
+            // Enforce minimum duration of 1 tick (1ns on Linux).
             _duration = SteadyClock::duration(1);
         }
 
-        tracer = _tracer;
-
-        std::copy(finishSpanOptions.log_records.begin(),
-                  finishSpanOptions.log_records.end(),
-                  std::back_inserter(_logs));
+        for (auto&& record : finishSpanOptions.log_records) {
+            logFieldsNoLocking(record.timestamp,
+                               std::begin(record.fields),
+                               std::end(record.fields));
+        }
+        if (_droppedLogs > 0) {
+            _tags.push_back(
+                Tag(kDroppedLogsTagKey, static_cast<int64_t>(_droppedLogs)));
+        }
+        _finished.store(true, std::memory_order_release);
     }
 
-    // Call `reportSpan` even for non-sampled traces.
-    if (tracer) {
-        tracer->reportSpan(*this);
+    // The span is immutable from here on, so the tracer and reporters read
+    // it without locking. Call `reportSpan` even for non-sampled traces.
+    if (_tracer) {
+        _tracer->reportSpan(*this);
     }
 }
 
 const opentracing::Tracer& Span::tracer() const noexcept
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto lock = readLock();
     if (_tracer) {
         return *_tracer;
     }
@@ -127,9 +156,77 @@ const opentracing::Tracer& Span::tracer() const noexcept
     return *tracer;
 }
 
+const LogLimits& Span::logLimits() const noexcept
+{
+    static const LogLimits defaultLimits;
+    return _tracer ? _tracer->logLimits() : defaultLimits;
+}
+
+void Span::admitLastLogNoLocking() noexcept
+{
+    const auto& limits = logLimits();
+    const auto size = _logs.back().estimatedSize();
+    if (!sampleEventNoLocking(_logs.back(), limits) ||
+        _logBytes + size > limits.maxLogBytes()) {
+        _logs.pop_back();
+        ++_droppedLogs;
+        return;
+    }
+    _logBytes += size;
+}
+
+bool Span::sampleEventNoLocking(const LogRecord& log, const LogLimits& limits)
+{
+    if (limits.repeatedEventRate() == 0) {
+        return true;
+    }
+    static const auto eventKeyID = Tag::keyPool().intern("event").first;
+    const auto& fields = log.fields();
+    const auto field = std::find_if(
+        std::begin(fields), std::end(fields), [](const Tag& tag) {
+            // A full pool leaves "event" without an ID, so every key that is
+            // not interned would share it; compare by name instead.
+            if (eventKeyID == utils::StringPool::kNotInterned) {
+                return tag.key() == "event";
+            }
+            return tag.keyID() == eventKeyID;
+        });
+    if (field == std::end(fields)) {
+        return true;
+    }
+    // Compared by string, since runtime values are not interned.
+    const auto event =
+        opentracing::util::apply_visitor(EventVisitor(), field->value());
+    if (!event.data()) {
+        return true;
+    }
+
+    auto itr = std::find_if(
+        std::begin(_logEvents),
+        std::end(_logEvents),
+        [&event](const std::pair<std::string, uint32_t>& loggedEvent) {
+            return opentracing::string_view(loggedEvent.first) == event;
+        });
+    if (itr == std::end(_logEvents)) {
+        _logEvents.emplace_back(std::string(event.data(), event.size()), 1);
+        return limits.sampleRepeatedEvent(1);
+    }
+    return limits.sampleRepeatedEvent(++itr->second);
+}
+
+Span::SystemClock::time_point Span::systemNow() const noexcept
+{
+    return _tracer ? _tracer->clock().systemNow() : SystemClock::now();
+}
+
+Span::SteadyClock::time_point Span::steadyNow() const noexcept
+{
+    return _tracer ? _tracer->clock().steadyNow() : SteadyClock::now();
+}
+
 std::string Span::serviceName() const noexcept
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto lock = readLock();
     return serviceNameNoLock();
 }
 
@@ -146,7 +243,10 @@ void Span::setSamplingPriority(const opentracing::Value& value)
     SamplingPriorityVisitor visitor;
     const auto priority = opentracing::Value::visit(value, visitor);
 
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto lock = writeLock();
+    if (isFinished()) {
+        return;
+    }
     auto newFlags = _context.flags();
     if (priority) {
         newFlags |= static_cast<unsigned char>(SpanContext::Flag::kSampled) |
@@ -166,12 +266,12 @@ void Span::setSamplingPriority(const opentracing::Value& value)
 
 void Span::thrift(thrift::Span& span) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto lock = readLock();
     span.__set_traceIdHigh(_context.traceID().high());
     span.__set_traceIdLow(_context.traceID().low());
     span.__set_spanId(_context.spanID());
     span.__set_parentSpanId(_context.parentID());
-    span.__set_operationName(_operationName);
+    span.__set_operationName(_operationName.str());
 
     std::vector<thrift::SpanRef> refs;
     refs.reserve(_references.size());
@@ -218,4 +318,72 @@ void Span::thrift(thrift::Span& span) const
     span.__set_logs(logs);
 }
 
+size_t Span::estimatedSize() const
+{
+    const auto lock = readLock();
+    auto size = sizeof(Span) + _references.size() * sizeof(Reference);
+    if (!_operationName.isInterned()) {
+        size += _operationName.str().size();
+    }
+    _context.forEachBaggageItem(
+        [&size](const std::string& key, const std::string& value) {
+            size += key.size() + value.size();
+            return true;
+        });
+    for (auto&& tag : _tags) {
+        size += tag.estimatedSize();
+    }
+    for (auto&& log : _logs) {
+        size += log.estimatedSize();
+    }
+    return size;
+}
+
+void Span::encode(utils::ThriftWriter& writer) const
+{
+    using Type = utils::ThriftWriter::Type;
+    const auto lock = readLock();
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kI64, 1);
+    writer.writeI64(_context.traceID().low());
+    writer.writeFieldBegin(Type::kI64, 2);
+    writer.writeI64(_context.traceID().high());
+    writer.writeFieldBegin(Type::kI64, 3);
+    writer.writeI64(_context.spanID());
+    writer.writeFieldBegin(Type::kI64, 4);
+    writer.writeI64(_context.parentID());
+    writer.writeFieldBegin(Type::kString, 5);
+    writer.writeString(_operationName.view());
+
+    writer.writeFieldBegin(Type::kList, 6);
+    writer.writeListBegin(Type::kStruct, _references.size());
+    for (auto&& reference : _references) {
+        reference.encode(writer);
+    }
+
+    writer.writeFieldBegin(Type::kI32, 7);
+    writer.writeI32(_context.flags());
+    writer.writeFieldBegin(Type::kI64, 8);
+    writer.writeI64(std::chrono::duration_cast<std::chrono::microseconds>(
+                        _startTimeSystem.time_since_epoch())
+                        .count());
+    writer.writeFieldBegin(Type::kI64, 9);
+    writer.writeI64(
+        std::chrono::duration_cast<std::chrono::microseconds>(_duration)
+            .count());
+
+    writer.writeFieldBegin(Type::kList, 10);
+    writer.writeListBegin(Type::kStruct, _tags.size());
+    for (auto&& tag : _tags) {
+        tag.encode(writer);
+    }
+
+    writer.writeFieldBegin(Type::kList, 11);
+    writer.writeListBegin(Type::kStruct, _logs.size());
+    for (auto&& log : _logs) {
+        log.encode(writer);
+    }
+    writer.writeStructEnd();
+}
+
 }  // namespace jaegertracing
@@ -17,13 +17,16 @@
 #ifndef JAEGERTRACING_SPAN_H
 #define JAEGERTRACING_SPAN_H
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
 
 #include <opentracing/span.h>
 
+#include "jaegertracing/LogLimits.h"
 #include "jaegertracing/LogRecord.h"
+#include "jaegertracing/OperationName.h"
 #include "jaegertracing/Reference.h"
 #include "jaegertracing/SpanContext.h"
 #include "jaegertracing/Tag.h"
@@ -36,11 +39,20 @@ namespace thrift {
 class Span;
 }
 
+namespace utils {
+class ThriftWriter;
+}
+
 class Span : public opentracing::Span {
   public:
     using SteadyClock = opentracing::SteadyClock;
     using SystemClock = opentracing::SystemClock;
 
+    // A kSingleOwner span is only used by one thread at a time, so it never
+    // takes the span mutex. Either way a finished span is immutable and is
+    // read without locking.
+    enum class Concurrency { kThreadSafe, kSingleOwner };
+
     explicit Span(
         const std::shared_ptr<const Tracer>& tracer = nullptr,
         const SpanContext& context = SpanContext(),
@@ -48,7 +60,27 @@ class Span : public opentracing::Span {
         const SystemClock::time_point& startTimeSystem = SystemClock::now(),
         const SteadyClock::time_point& startTimeSteady = SteadyClock::now(),
         const std::vector<Tag>& tags = {},
-        const std::vector<Reference>& references = {})
+        const std::vector<Reference>& references = {},
+        Concurrency concurrency = Concurrency::kThreadSafe)
+        : Span(tracer,
+               context,
+               OperationName(operationName),
+               startTimeSystem,
+               startTimeSteady,
+               tags,
+               references,
+               concurrency)
+    {
+    }
+
+    Span(const std::shared_ptr<const Tracer>& tracer,
+         const SpanContext& context,
+         const OperationName& operationName,
+         const SystemClock::time_point& startTimeSystem = SystemClock::now(),
+         const SteadyClock::time_point& startTimeSteady = SteadyClock::now(),
+         const std::vector<Tag>& tags = {},
+         const std::vector<Reference>& references = {},
+         Concurrency concurrency = Concurrency::kThreadSafe)
         : _tracer(tracer)
         , _context(context)
         , _operationName(operationName)
@@ -56,15 +88,23 @@ class Span : public opentracing::Span {
         , _startTimeSteady(startTimeSteady)
         , _duration()
         , _tags(tags)
+        , _logs()
+        , _logBytes(0)
+        , _droppedLogs(0)
+        , _logEvents()
         , _references(references)
+        , _concurrency(concurrency)
+        , _localRoot(context.parentID() == 0)
+        , _finished(false)
+        , _mutex()
     {
     }
 
+    // Reporters copy spans once they are finished, which takes no lock.
     Span(const Span& span)
+        : _finished(false)
     {
-        std::lock(_mutex, span._mutex);
-        std::lock_guard<std::mutex> lock(_mutex, std::adopt_lock);
-        std::lock_guard<std::mutex> spanLock(span._mutex, std::adopt_lock);
+        const auto spanLock = span.readLock();
 
         _tracer = span._tracer;
         _context = span._context;
@@ -74,7 +114,14 @@ class Span : public opentracing::Span {
         _duration = span._duration;
         _tags = span._tags;
         _logs = span._logs;
+        _logBytes = span._logBytes;
+        _droppedLogs = span._droppedLogs;
+        _logEvents = span._logEvents;
         _references = span._references;
+        _concurrency = span._concurrency;
+        _localRoot = span._localRoot;
+        _finished.store(span._finished.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
     }
 
     // Pass-by-value intentional to implement copy-and-swap.
@@ -102,50 +149,92 @@ class Span : public opentracing::Span {
         swap(_duration, span._duration);
         swap(_tags, span._tags);
         swap(_logs, span._logs);
+        swap(_logBytes, span._logBytes);
+        swap(_droppedLogs, span._droppedLogs);
+        swap(_logEvents, span._logEvents);
         swap(_references, span._references);
+        swap(_concurrency, span._concurrency);
+        swap(_localRoot, span._localRoot);
+        const auto finished = _finished.load(std::memory_order_relaxed);
+        _finished.store(span._finished.load(std::memory_order_relaxed),
+                        std::memory_order_release);
+        span._finished.store(finished, std::memory_order_release);
     }
 
     friend void swap(Span& lhs, Span& rhs) { lhs.swap(rhs); }
 
+    // Set by the tracer before the span is handed out.
+    void setLocalRoot(bool localRoot) { _localRoot = localRoot; }
+
     void thrift(thrift::Span& span) const;
 
+    void encode(utils::ThriftWriter& writer) const;
+
+    // Approximate number of bytes a copy of this span holds, used to budget
+    // reporter queues.
+    size_t estimatedSize() const;
+
     template <typename Stream>
     void print(Stream& out) const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         out << _context;
     }
 
     std::string operationName() const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
+        return _operationName.str();
+    }
+
+    OperationName internedOperationName() const
+    {
+        const auto lock = readLock();
         return _operationName;
     }
 
     SystemClock::time_point startTimeSystem() const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         return _startTimeSystem;
     }
 
     SteadyClock::time_point startTimeSteady() const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         return _startTimeSteady;
     }
 
     SteadyClock::duration duration() const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         return _duration;
     }
 
     std::vector<Tag> tags() const
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         return _tags;
     }
 
+    // Visits the tags in place rather than copying them like tags().
+    template <typename Function>
+    void forEachTag(Function f) const
+    {
+        const auto lock = readLock();
+        for (auto&& tag : _tags) {
+            if (!f(tag)) {
+                break;
+            }
+        }
+    }
+
+    Concurrency concurrency() const { return _concurrency; }
+
+    // True for the first span of the trace in this process: a span without
+    // a parent, or whose parent was extracted from another process.
+    bool isLocalRoot() const { return _localRoot; }
+
     template <typename... Arg>
     void setOperationName(Arg&&... args)
     {
@@ -157,11 +246,12 @@ class Span : public opentracing::Span {
 
     void SetOperationName(opentracing::string_view name) noexcept override
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        OperationName operationName(name);
+        const auto lock = writeLock();
         if (isFinished()) {
             return;
         }
-        _operationName = name;
+        _operationName.swap(operationName);
     }
 
     void SetTag(opentracing::string_view key,
@@ -171,7 +261,7 @@ class Span : public opentracing::Span {
             setSamplingPriority(value);
             return;
         }
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = writeLock();
         if (isFinished() || !_context.isSampled()) {
             return;
         }
@@ -184,7 +274,7 @@ class Span : public opentracing::Span {
     std::string BaggageItem(opentracing::string_view restrictedKey) const
         noexcept override
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         auto itr = _context.baggage().find(restrictedKey);
         return (itr == std::end(_context.baggage())) ? std::string()
                                                      : itr->second;
@@ -210,12 +300,12 @@ class Span : public opentracing::Span {
              std::pair<opentracing::string_view, opentracing::Value>>
                  fieldPairs) noexcept override
     {
-        doLog(SystemClock::now(), fieldPairs);
+        doLog(systemNow(), fieldPairs);
     }
 
     const SpanContext& context() const noexcept override
     {
-        std::lock_guard<std::mutex> lock(_mutex);
+        const auto lock = readLock();
         return _context;
     }
 
@@ -228,45 +318,89 @@ class Span : public opentracing::Span {
     std::string serviceNameNoLock() const noexcept;
 
   private:
-    bool isFinished() const { return _duration != SteadyClock::duration(); }
+    using Lock = std::unique_lock<std::mutex>;
+
+    bool isFinished() const
+    {
+        return _finished.load(std::memory_order_acquire);
+    }
+
+    // Held while mutating the span, a no-op for single owner spans.
+    Lock writeLock() const
+    {
+        return (_concurrency == Concurrency::kThreadSafe) ? Lock(_mutex)
+                                                          : Lock();
+    }
+
+    // Finishing publishes every write with a release store to _finished, so
+    // a reader that observes it needs no lock.
+    Lock readLock() const
+    {
+        return (_concurrency == Concurrency::kThreadSafe && !isFinished())
+                   ? Lock(_mutex)
+                   : Lock();
+    }
 
+    // Read the tracer's clock source, or std::chrono without a tracer.
+    SystemClock::time_point systemNow() const noexcept;
+
+    SteadyClock::time_point steadyNow() const noexcept;
+
+    // The tracer's limits, or the defaults for a span without a tracer.
+    const LogLimits& logLimits() const noexcept;
+
+    // Builds the log in place from the fields, which are Tags or key/value
+    // pairs, unless it would exceed the log limits.
     template <typename FieldIterator>
-    void logFieldsNoLocking(const std::chrono::system_clock::time_point& timestamp, FieldIterator first, FieldIterator last) noexcept
+    void logFieldsNoLocking(
+        const std::chrono::system_clock::time_point& timestamp,
+        FieldIterator first,
+        FieldIterator last) noexcept
     {
-        LogRecord log(timestamp, first, last);
-        _logs.push_back(log);
+        if (_logs.size() >= logLimits().maxLogs()) {
+            ++_droppedLogs;
+            return;
+        }
+        _logs.emplace_back(timestamp, first, last);
+        admitLastLogNoLocking();
     }
 
+    // Drops the log just appended if it exceeds the byte limit or is a
+    // repeated event the limits sample out.
+    void admitLastLogNoLocking() noexcept;
+
+    bool sampleEventNoLocking(const LogRecord& log, const LogLimits& limits);
+
     template <typename Container>
-    void doLog(opentracing::SystemTime timestamp, Container fieldPairs) noexcept
+    void doLog(opentracing::SystemTime timestamp,
+               const Container& fieldPairs) noexcept
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        if (!_context.isSampled()) {
+        const auto lock = writeLock();
+        if (isFinished() || !_context.isSampled()) {
             return;
         }
-
-        std::vector<Tag> fields;
-        fields.reserve(fieldPairs.size());
-        std::transform(
-            std::begin(fieldPairs),
-            std::end(fieldPairs),
-            std::back_inserter(fields),
-            [](const std::pair<opentracing::string_view, opentracing::Value>&
-                   pair) { return Tag(pair.first, pair.second); });
-        logFieldsNoLocking(timestamp, std::begin(fields), std::end(fields));
+        logFieldsNoLocking(
+            timestamp, std::begin(fieldPairs), std::end(fieldPairs));
     }
 
     void setSamplingPriority(const opentracing::Value& value);
 
     std::shared_ptr<const Tracer> _tracer;
     SpanContext _context;
-    std::string _operationName;
+    OperationName _operationName;
     SystemClock::time_point _startTimeSystem;
     SteadyClock::time_point _startTimeSteady;
     SteadyClock::duration _duration;
     std::vector<Tag> _tags;
     std::vector<LogRecord> _logs;
+    size_t _logBytes;
+    uint32_t _droppedLogs;
+    // Number of logs seen per interned "event" value, for sampling.
+    std::vector<std::pair<std::string, uint32_t>> _logEvents;
     std::vector<Reference> _references;
+    Concurrency _concurrency;
+    bool _localRoot;
+    std::atomic<bool> _finished;
     mutable std::mutex _mutex;
 };
 
@@ -20,6 +20,8 @@
 
 namespace jaegertracing {
 
+constexpr int SpanContext::kMaxStringLength;
+
 SpanContext SpanContext::fromStream(std::istream& in)
 {
     SpanContext spanContext;
@@ -65,4 +67,68 @@ SpanContext SpanContext::fromStream(std::istream& in)
     return spanContext;
 }
 
+SpanContext SpanContext::fromString(opentracing::string_view str)
+{
+    constexpr auto kMaxTraceIDChars = static_cast<size_t>(32);
+    constexpr auto kMaxUInt64Chars = static_cast<size_t>(16);
+    constexpr auto kMaxByteChars = static_cast<size_t>(2);
+
+    auto pos = static_cast<size_t>(0);
+    // Reads the next segment and, unless it is the last one, the ':' after
+    // it. Leaves `pos` at the start of the following segment.
+    auto nextSegment = [&str, &pos](size_t maxChars, bool last) {
+        const auto segment = utils::HexParsing::readSegment(
+            opentracing::string_view(str.data() + pos, str.size() - pos),
+            maxChars,
+            ':');
+        pos += segment.size();
+        if (segment.empty() || last) {
+            return segment;
+        }
+        if (pos >= str.size() || str[pos] != ':') {
+            return opentracing::string_view();
+        }
+        ++pos;
+        return segment;
+    };
+
+    SpanContext spanContext;
+    spanContext._traceID =
+        TraceID::fromHex(nextSegment(kMaxTraceIDChars, false));
+    if (!spanContext._traceID.isValid()) {
+        return SpanContext();
+    }
+
+    auto segment = nextSegment(kMaxUInt64Chars, false);
+    if (segment.empty()) {
+        return SpanContext();
+    }
+    spanContext._spanID = utils::HexParsing::decodeHex<uint64_t>(segment);
+
+    segment = nextSegment(kMaxUInt64Chars, false);
+    if (segment.empty()) {
+        return SpanContext();
+    }
+    spanContext._parentID = utils::HexParsing::decodeHex<uint64_t>(segment);
+
+    segment = nextSegment(kMaxByteChars, true);
+    if (segment.empty()) {
+        return SpanContext();
+    }
+    spanContext._flags = utils::HexParsing::decodeHex<unsigned char>(segment);
+
+    return spanContext;
+}
+
+char* SpanContext::toChars(char* first) const
+{
+    first = _traceID.toChars(first);
+    *first++ = ':';
+    first = utils::HexParsing::encodeHex16(_spanID, first);
+    *first++ = ':';
+    first = utils::HexParsing::encodeHex16(_parentID, first);
+    *first++ = ':';
+    return utils::HexParsing::encodeHex(_flags, first);
+}
+
 }  // namespace jaegertracing
@@ -28,6 +28,7 @@
 
 #include "jaegertracing/Compilers.h"
 
+#include "jaegertracing/BaggageMap.h"
 #include "jaegertracing/TraceID.h"
 
 namespace jaegertracing {
@@ -38,13 +39,23 @@ class SpanContext : public opentracing::SpanContext {
 
     enum class Flag : unsigned char { kSampled = 1, kDebug = 2 };
 
+    // Longest output of toChars: a 128-bit trace ID, two 64-bit IDs, a
+    // byte of flags and three separators.
+    static constexpr auto kMaxStringLength = TraceID::kMaxHexLength + 16 + 16 +
+                                             2 + 3;
+
     static SpanContext fromStream(std::istream& in);
 
+    // Parses the same "traceID:spanID:parentID:flags" format as fromStream
+    // directly from memory, without a stream or temporary strings.
+    static SpanContext fromString(opentracing::string_view str);
+
     SpanContext()
         : _traceID(0, 0)
         , _spanID(0)
         , _parentID(0)
         , _flags(0)
+        , _remote(false)
         , _mutex()
     {
     }
@@ -53,16 +64,20 @@ class SpanContext : public opentracing::SpanContext {
                 uint64_t spanID,
                 uint64_t parentID,
                 unsigned char flags,
-                const StrMap& baggage,
+                const BaggageMap& baggage,
                 const std::string& debugID = "",
-                const std::string& traceState = "")
+                std::string traceState = std::string())
         : _traceID(traceID)
         , _spanID(spanID)
         , _parentID(parentID)
         , _flags(flags)
         , _baggage(baggage)
         , _debugID(debugID)
-        , _traceState(traceState)
+        , _traceState(traceState.empty()
+                          ? nullptr
+                          : std::make_shared<const std::string>(
+                                std::move(traceState)))
+        , _remote(false)
         , _mutex()
     {
     }
@@ -75,6 +90,7 @@ class SpanContext : public opentracing::SpanContext {
         , _baggage(ctx._baggage)
         , _debugID(ctx._debugID)
         , _traceState(ctx._traceState)
+        , _remote(ctx._remote)
     {
     }
 
@@ -94,6 +110,7 @@ class SpanContext : public opentracing::SpanContext {
         swap(_baggage, ctx._baggage);
         swap(_debugID, ctx._debugID);
         swap(_traceState, ctx._traceState);
+        swap(_remote, ctx._remote);
     }
 
     friend void swap(SpanContext& lhs, SpanContext& rhs) { lhs.swap(rhs); }
@@ -104,18 +121,16 @@ class SpanContext : public opentracing::SpanContext {
 
     uint64_t parentID() const { return _parentID; }
 
-    const StrMap& baggage() const { return _baggage; }
+    const BaggageMap& baggage() const { return _baggage; }
 
-    SpanContext withBaggage(const StrMap& baggage) const
+    SpanContext withBaggage(const BaggageMap& baggage) const
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        return SpanContext(_traceID,
-                           _spanID,
-                           _parentID,
-                           _flags,
-                           baggage,
-                           _debugID,
-                           _traceState);
+        SpanContext ctx(
+            _traceID, _spanID, _parentID, _flags, baggage, _debugID);
+        ctx._traceState = _traceState;
+        ctx._remote = _remote;
+        return ctx;
     }
 
     template <typename Function>
@@ -149,7 +164,11 @@ class SpanContext : public opentracing::SpanContext {
         return _flags & static_cast<unsigned char>(Flag::kSampled);
     }
 
-    const std::string& traceState() const { return _traceState; }
+    const std::string& traceState() const
+    {
+        static const std::string kEmptyTraceState;
+        return _traceState ? *_traceState : kEmptyTraceState;
+    }
 
     bool isDebug() const
     {
@@ -163,13 +182,22 @@ class SpanContext : public opentracing::SpanContext {
 
     bool isValid() const { return _traceID.isValid() && _spanID != 0; }
 
+    // True for contexts extracted from a carrier, i.e. spans of another
+    // process. Not propagated and not part of equality.
+    bool isRemote() const { return _remote; }
+
+    void setRemote(bool remote) { _remote = remote; }
+
+    // Writes "traceID:spanID:parentID:flags" and returns the end of the
+    // written range, like std::to_chars. `first` must have room for
+    // kMaxStringLength characters.
+    char* toChars(char* first) const;
+
     template <typename Stream>
     void print(Stream& out) const
     {
-        _traceID.print(out);
-        out << ':' << std::setw(16) << std::setfill('0') << std::hex << _spanID
-            << ':' << std::setw(16) << std::setfill('0') << std::hex << _parentID
-            << ':' << std::hex << static_cast<size_t>(_flags);
+        char buffer[kMaxStringLength];
+        out.write(buffer, toChars(buffer) - buffer);
     }
 
     void ForeachBaggageItem(
@@ -199,7 +227,7 @@ class SpanContext : public opentracing::SpanContext {
         return lhs._traceID == rhs._traceID && lhs._spanID == rhs._spanID &&
                lhs._parentID == rhs._parentID && lhs._flags == rhs._flags &&
                lhs._debugID == rhs._debugID &&
-               lhs._traceState == rhs._traceState;
+               lhs.traceState() == rhs.traceState();
     }
 
     friend bool operator!=(const SpanContext& lhs, const SpanContext& rhs)
@@ -212,9 +240,12 @@ class SpanContext : public opentracing::SpanContext {
     uint64_t _spanID;
     uint64_t _parentID;
     unsigned char _flags;
-    StrMap _baggage;
+    BaggageMap _baggage;
     std::string _debugID;
-    std::string _traceState;
+    // The W3C tracestate header is passed through without being parsed or
+    // modified, so copies of a context share one immutable value.
+    std::shared_ptr<const std::string> _traceState;
+    bool _remote;
     mutable std::mutex _mutex;  // Protects _baggage.
 };
 
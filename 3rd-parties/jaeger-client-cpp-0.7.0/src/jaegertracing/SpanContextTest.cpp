@@ -70,6 +70,8 @@ TEST(SpanContext, testFromStream)
         }
 
         ASSERT_EQ(spanContext, spanContextFromStreamOp);
+        ASSERT_EQ(spanContext, SpanContext::fromString(testCase._input))
+            << "input=" << testCase._input;
     }
 }
 
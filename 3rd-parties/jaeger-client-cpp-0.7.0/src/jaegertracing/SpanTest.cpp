@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "jaegertracing/Constants.h"
 #include "jaegertracing/Span.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
 #include <gtest/gtest.h>
@@ -30,4 +31,71 @@ TEST(Span, testThriftConversion)
     ASSERT_NO_THROW(span.thrift(thriftSpan));
 }
 
+TEST(Span, testSingleOwner)
+{
+    const SpanContext context(
+        TraceID(0, 1),
+        1,
+        0,
+        static_cast<unsigned char>(SpanContext::Flag::kSampled),
+        SpanContext::StrMap());
+    Span span(nullptr,
+              context,
+              "op",
+              Span::SystemClock::now(),
+              Span::SteadyClock::now(),
+              {},
+              {},
+              Span::Concurrency::kSingleOwner);
+    span.SetTag("error", true);
+    span.SetTag("key", "value");
+    span.Log({ { "event", "test" } });
+    span.Finish();
+
+    // A finished span ignores further writes.
+    span.SetTag("late", 1);
+    span.Log({ { "late", 1 } });
+    span.SetOperationName("late");
+
+    auto numTags = 0;
+    span.forEachTag([&numTags](const Tag&) {
+        ++numTags;
+        return true;
+    });
+    ASSERT_EQ(2, numTags);
+    ASSERT_EQ("op", span.operationName());
+
+    const Span copy(span);
+    ASSERT_EQ(Span::Concurrency::kSingleOwner, copy.concurrency());
+    ASSERT_EQ(2, static_cast<int>(copy.tags().size()));
+    thrift::Span thriftSpan;
+    copy.thrift(thriftSpan);
+    ASSERT_EQ(1, static_cast<int>(thriftSpan.logs.size()));
+}
+
+TEST(Span, testLogLimits)
+{
+    const SpanContext context(
+        TraceID(0, 1),
+        1,
+        0,
+        static_cast<unsigned char>(SpanContext::Flag::kSampled),
+        SpanContext::StrMap());
+    Span span(nullptr, context, "op");
+    const auto numLogs = LogLimits::kDefaultMaxLogs + 2;
+    for (auto i = 0u; i < numLogs; ++i) {
+        span.Log({ { "iteration", static_cast<uint64_t>(i) } });
+    }
+    span.Finish();
+
+    int64_t droppedLogs = 0;
+    span.forEachTag([&droppedLogs](const Tag& tag) {
+        if (tag.key() == kDroppedLogsTagKey) {
+            droppedLogs = tag.value().get<int64_t>();
+        }
+        return true;
+    });
+    ASSERT_EQ(2, droppedLogs);
+}
+
 }  // namespace jaegertracing
@@ -16,8 +16,49 @@
 
 #include "jaegertracing/Tag.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/EncodingCache.h"
+#include "jaegertracing/utils/ThriftWriter.h"
+#include <cstring>
+#include <tuple>
 
 namespace jaegertracing {
+namespace {
+
+// Interns `const char*` values, which are nearly always literals from a
+// bounded set. Other values, including `std::string` and `string_view`,
+// may be unique per request and would fill the process-wide pool for good.
+class InternVisitor {
+  public:
+    using result_type = utils::StringPool::Entry;
+
+    result_type operator()(const char* value) const
+    {
+        return value ? intern(value) : notInterned();
+    }
+
+    template <typename Arg>
+    result_type operator()(Arg&& value) const
+    {
+        return notInterned();
+    }
+
+  private:
+    static result_type notInterned()
+    {
+        return std::make_pair(utils::StringPool::kNotInterned, nullptr);
+    }
+
+    static result_type intern(opentracing::string_view value)
+    {
+        if (value.size() > Tag::kMaxInternedValueSize) {
+            return notInterned();
+        }
+        return Tag::valuePool().intern(value);
+    }
+};
+
+}  // anonymous namespace
+
 class ThriftVisitor {
   public:
     using result_type = void;
@@ -69,11 +110,163 @@ class ThriftVisitor {
     thrift::Tag& _tag;
 };
 
+class EncodeVisitor {
+  public:
+    using result_type = void;
+    using Type = utils::ThriftWriter::Type;
+
+    explicit EncodeVisitor(utils::ThriftWriter& writer)
+        : _writer(writer)
+    {
+    }
+
+    void operator()(const std::string& value) const { writeString(value); }
+
+    void operator()(const char* value) const { writeString(value); }
+
+    void operator()(double value) const
+    {
+        writeType(thrift::TagType::DOUBLE);
+        _writer.writeFieldBegin(Type::kDouble, 4);
+        _writer.writeDouble(value);
+    }
+
+    void operator()(bool value) const
+    {
+        writeType(thrift::TagType::BOOL);
+        _writer.writeBoolField(5, value);
+    }
+
+    void operator()(int64_t value) const { writeLong(value); }
+
+    void operator()(uint64_t value) const { writeLong(value); }
+
+    template <typename Arg>
+    void operator()(Arg&& value) const
+    {
+        // Same as ThriftVisitor: only the default type is set.
+        writeType(thrift::TagType::STRING);
+    }
+
+  private:
+    void writeType(thrift::TagType::type type) const
+    {
+        _writer.writeFieldBegin(Type::kI32, 2);
+        _writer.writeI32(static_cast<int32_t>(type));
+    }
+
+    void writeString(opentracing::string_view value) const
+    {
+        writeType(thrift::TagType::STRING);
+        _writer.writeFieldBegin(Type::kString, 3);
+        _writer.writeString(value);
+    }
+
+    void writeLong(int64_t value) const
+    {
+        writeType(thrift::TagType::LONG);
+        _writer.writeFieldBegin(Type::kI64, 6);
+        _writer.writeI64(value);
+    }
+
+    utils::ThriftWriter& _writer;
+};
+
+class SizeVisitor {
+  public:
+    using result_type = size_t;
+
+    size_t operator()(const std::string& value) const { return value.size(); }
+
+    size_t operator()(const char* value) const { return std::strlen(value); }
+
+    template <typename Arg>
+    size_t operator()(Arg&& value) const
+    {
+        return 0;
+    }
+};
+
+constexpr size_t Tag::kMaxInternedValueSize;
+
+utils::StringPool& Tag::keyPool()
+{
+    // Intentionally leaked, like `OperationName::pool()`.
+    static auto* pool = new utils::StringPool();
+    return *pool;
+}
+
+utils::StringPool& Tag::valuePool()
+{
+    static auto* pool = new utils::StringPool();
+    return *pool;
+}
+
+void Tag::intern(opentracing::string_view key)
+{
+    std::tie(_keyID, _internedKey) = keyPool().intern(key);
+    if (!_internedKey) {
+        _key = std::make_shared<const std::string>(key.data(), key.size());
+    }
+
+    const std::string* pooledValue = nullptr;
+    std::tie(_valueID, pooledValue) =
+        opentracing::util::apply_visitor(InternVisitor(), _value);
+    if (pooledValue && _value.is<const char*>()) {
+        // The caller's pointer need not outlive the tag; the pool's does.
+        _value = ValueType(pooledValue->c_str());
+    }
+}
+
 void Tag::thrift(thrift::Tag& tag) const
 {
-    tag.__set_key(_key);
+    tag.__set_key(key());
     ThriftVisitor visitor(tag);
     opentracing::util::apply_visitor(visitor, _value);
 }
 
+size_t Tag::estimatedSize() const
+{
+    auto size = sizeof(Tag);
+    if (!_internedKey) {
+        size += _key->size();
+    }
+    if (_valueID == utils::StringPool::kNotInterned ||
+        _value.is<std::string>()) {
+        size += opentracing::util::apply_visitor(SizeVisitor(), _value);
+    }
+    return size;
+}
+
+void Tag::encode(utils::ThriftWriter& writer) const
+{
+    auto* cache = writer.cache();
+    if (!cache || !_internedKey ||
+        _valueID == utils::StringPool::kNotInterned) {
+        encodeFields(writer);
+        return;
+    }
+
+    const auto cacheKey = (static_cast<uint64_t>(_keyID) << 32) | _valueID;
+    auto& buffer = writer.buffer();
+    const auto* bytes = cache->find(cacheKey);
+    if (bytes) {
+        buffer.append(*bytes);
+        return;
+    }
+    const auto start = buffer.size();
+    encodeFields(writer);
+    cache->insert(cacheKey, buffer.substr(start));
+}
+
+void Tag::encodeFields(utils::ThriftWriter& writer) const
+{
+    writer.writeStructBegin();
+    writer.writeFieldBegin(utils::ThriftWriter::Type::kString, 1);
+    writer.writeString(key());
+    EncodeVisitor visitor(writer);
+    opentracing::util::apply_visitor(visitor, _value);
+    writer.writeStructEnd();
+}
+
 }  // namespace jaegertracing
\ No newline at end of file
@@ -18,9 +18,11 @@
 #define JAEGERTRACING_TAG_H
 
 #include "jaegertracing/Compilers.h"
+#include "jaegertracing/utils/StringPool.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <opentracing/string_view.h>
 #include <opentracing/value.h>
 #include <opentracing/variant/variant.hpp>
@@ -31,37 +33,85 @@ namespace thrift {
 class Tag;
 }
 
+namespace utils {
+class ThriftWriter;
+}
+
+// Tag keys are interned in a process-wide pool, since spans repeat a small
+// set of them. Short `const char*` values, usually literals, are interned in
+// a second pool and redirected to the pooled copy; values built at runtime
+// are not, so request IDs and the like do not stay in memory for good. Tags
+// with an interned key and value are encoded once per sender and replayed
+// from its `utils::EncodingCache`.
 class Tag {
   public:
     using ValueType = opentracing::Value;
 
+    using ID = utils::StringPool::ID;
+
+    // Longer string values are likely unique, so they are not interned.
+    static constexpr size_t kMaxInternedValueSize = 64;
+
+    static utils::StringPool& keyPool();
+
+    static utils::StringPool& valuePool();
+
     template <typename ValueArg>
-    Tag(const std::string& key, ValueArg&& value)
-        : _key(key)
+    Tag(opentracing::string_view key, ValueArg&& value)
+        : _keyID(utils::StringPool::kNotInterned)
+        , _valueID(utils::StringPool::kNotInterned)
+        , _internedKey(nullptr)
+        , _key()
         , _value(std::forward<ValueArg>(value))
     {
+        intern(key);
     }
 
-    template <typename ValueArg>
-    Tag(const std::pair<std::string, ValueArg>& tag_pair)
-        : _key(tag_pair.first)
-        , _value(tag_pair.second)
+    template <typename KeyArg, typename ValueArg>
+    Tag(const std::pair<KeyArg, ValueArg>& tag_pair)
+        : Tag(tag_pair.first, tag_pair.second)
     {
     }
 
     bool operator==(const Tag& rhs) const
     {
-        return _key == rhs._key && _value == rhs._value;
+        if (_internedKey && rhs._internedKey) {
+            return _keyID == rhs._keyID && _value == rhs._value;
+        }
+        return key() == rhs.key() && _value == rhs._value;
     }
 
-    const std::string& key() const { return _key; }
+    const std::string& key() const
+    {
+        return _internedKey ? *_internedKey : *_key;
+    }
 
     const ValueType& value() const { return _value; }
 
+    ID keyID() const { return _keyID; }
+
+    // Pool ID of a `const char*` value, or `kNotInterned` for any other
+    // value.
+    ID valueID() const { return _valueID; }
+
     void thrift(thrift::Tag& tag) const;
 
+    void encode(utils::ThriftWriter& writer) const;
+
+    // Approximate number of bytes this tag occupies in memory. Pooled
+    // strings are shared and not counted.
+    size_t estimatedSize() const;
+
   private:
-    std::string _key;
+    void intern(opentracing::string_view key);
+
+    void encodeFields(utils::ThriftWriter& writer) const;
+
+    ID _keyID;
+    ID _valueID;
+    const std::string* _internedKey;
+    // Keys rejected by a full pool. Shared so copying a tag stays cheap.
+    std::shared_ptr<const std::string> _key;
     ValueType _value;
 };
 
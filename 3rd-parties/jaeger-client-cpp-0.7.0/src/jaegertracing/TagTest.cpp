@@ -16,6 +16,8 @@
 
 #include "jaegertracing/Tag.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/EncodingCache.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 #include <gtest/gtest.h>
 #include <string>
 
@@ -37,4 +39,46 @@ TEST(Tag, testThriftConversion)
     }
 }
 
+TEST(Tag, testInterning)
+{
+    const Tag first("component", "http");
+    const Tag second(std::string("component"), "http");
+    ASSERT_NE(utils::StringPool::kNotInterned, first.keyID());
+    ASSERT_EQ(first.keyID(), second.keyID());
+    ASSERT_EQ(&first.key(), &second.key());
+    ASSERT_NE(utils::StringPool::kNotInterned, first.valueID());
+    ASSERT_EQ(first.valueID(), second.valueID());
+    ASSERT_TRUE(second.value().is<const char*>());
+    ASSERT_EQ(std::string("http"), second.value().get<const char*>());
+
+    // Values built at runtime may be unique, so they are not pooled.
+    const Tag runtimeValue("component", std::string("http"));
+    ASSERT_EQ(utils::StringPool::kNotInterned, runtimeValue.valueID());
+    ASSERT_TRUE(runtimeValue.value().is<std::string>());
+    const std::string longValue(Tag::kMaxInternedValueSize + 1, 'x');
+    ASSERT_EQ(utils::StringPool::kNotInterned,
+              Tag("component", longValue.c_str()).valueID());
+    ASSERT_EQ(utils::StringPool::kNotInterned, Tag("count", 1).valueID());
+}
+
+TEST(Tag, testEncodeCache)
+{
+    const Tag tag("peer.service", "backend");
+    for (auto protocol : { utils::ThriftWriter::Protocol::kBinary,
+                           utils::ThriftWriter::Protocol::kCompact }) {
+        std::string expected;
+        utils::ThriftWriter plainWriter(protocol, expected);
+        tag.encode(plainWriter);
+
+        std::string buffer;
+        utils::EncodingCache cache;
+        utils::ThriftWriter writer(protocol, buffer);
+        writer.setCache(&cache);
+        tag.encode(writer);
+        ASSERT_EQ(1, cache.size());
+        tag.encode(writer);
+        ASSERT_EQ(expected + expected, buffer);
+    }
+}
+
 }  // namespace jaegertracing
@@ -19,11 +19,14 @@
 #include "jaegertracing/Span.h"
 #include "jaegertracing/Tag.h"
 #include "jaegertracing/Tracer.h"
+#include "jaegertracing/metrics/Counter.h"
+#include "jaegertracing/metrics/Metrics.h"
 #include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <iterator>
-#include <thrift/transport/TBufferTransports.h>
+#include <limits>
+#include <sstream>
 
 #ifdef _MSC_VER
 #pragma warning(disable : 4267)  // Conversion from unsigned to signed. It
@@ -31,102 +34,170 @@
 #endif
 
 namespace jaegertracing {
-namespace net {
-class IPAddress;
-}  // namespace net
 
-namespace {
-
-constexpr auto kEmitBatchOverhead = 30;
-
-}  // anonymous namespace
-
-ThriftSender::ThriftSender(std::unique_ptr<utils::Transport>&& transporter)
+ThriftSender::ThriftSender(std::unique_ptr<utils::Transport>&& transporter,
+                           metrics::Metrics* metrics)
     : _transporter(std::move(transporter))
-    , _maxSpanBytes(0)
-    , _byteBufferSize(0)
-    , _processByteSize(0)
-    , _protocolFactory(_transporter->protocolFactory())
-    , _thriftBuffer(new apache::thrift::transport::TMemoryBuffer())
+    , _buffer()
+    , _tagCache()
+    , _writer(_transporter->encodedProtocol(), _buffer)
+    , _prefix()
+    , _suffix()
+    , _headroom(0)
+    , _numSpans(0)
+    , _listHeader()
+    , _overflow()
+    , _minSpanSize(std::numeric_limits<size_t>::max())
+    , _batchMinSpanSize(std::numeric_limits<size_t>::max())
+    , _numDeferred(0)
+    , _metrics(metrics)
 {
+    _writer.setCache(&_tagCache);
 }
 
 int ThriftSender::append(const Span& span)
 {
-    if (_process.serviceName.empty()) {
-        const auto& tracer = static_cast<const Tracer&>(span.tracer());
-        _process.serviceName = tracer.serviceName();
-
-        const auto& tracerTags = tracer.tags();
-        std::vector<thrift::Tag> thriftTags;
-        thriftTags.reserve(tracerTags.size());
-        std::transform(std::begin(tracerTags),
-                       std::end(tracerTags),
-                       std::back_inserter(thriftTags),
-                       [](const Tag& tag) {
-                           thrift::Tag thriftTag;
-                           tag.thrift(thriftTag);
-                           return thriftTag;
-                       });
-        _process.__set_tags(thriftTags);
-
-        _processByteSize = calcSizeOfSerializedThrift(_process);
-        _maxSpanBytes =
-            _transporter->maxPacketSize() - _processByteSize - kEmitBatchOverhead;
+    _numDeferred = 0;
+    if (_prefix.empty()) {
+        encodeFraming(span);
     }
-    thrift::Span jaegerSpan;
-    span.thrift(jaegerSpan);
-    const auto spanSize = calcSizeOfSerializedThrift(jaegerSpan);
-    if (spanSize > _maxSpanBytes) {
-        std::ostringstream oss;
-        throw Sender::Exception("Span is too large", 1);
+
+    const auto spanStart = _buffer.size();
+    try {
+        span.encode(_writer);
+    } catch (...) {
+        _buffer.resize(spanStart);
+        throw;
+    }
+    const auto spanSize = _buffer.size() - spanStart;
+    const auto maxPacketSize =
+        static_cast<size_t>(_transporter->maxPacketSize());
+    if (batchSize(1, spanSize) > maxPacketSize) {
+        _buffer.resize(spanStart);
+        throw Sender::RejectedSpan("Span is too large");
     }
 
-    _byteBufferSize += spanSize;
-    if (_byteBufferSize <= _maxSpanBytes) {
-        _spanBuffer.push_back(jaegerSpan);
-        if (_byteBufferSize < _maxSpanBytes) {
+    const auto newBatchSize =
+        batchSize(_numSpans + 1, _buffer.size() - _headroom);
+    if (newBatchSize <= maxPacketSize) {
+        ++_numSpans;
+        _batchMinSpanSize = std::min(_batchMinSpanSize, spanSize);
+        const auto minSpanSize = std::min(_minSpanSize, _batchMinSpanSize);
+        if (batchSize(_numSpans + 1,
+                      _buffer.size() - _headroom + minSpanSize) <=
+            maxPacketSize) {
             return 0;
         }
-        return flush();
+        return flushBatch(true);
     }
 
-    // Flush currently full buffer, then append this span to buffer.
-    const auto flushed = flush();
-    _spanBuffer.push_back(jaegerSpan);
-    _byteBufferSize = spanSize + _processByteSize;
+    // Flush currently full buffer, then start the next batch with this span.
+    _overflow.assign(_buffer, spanStart, spanSize);
+    _buffer.resize(spanStart);
+    int flushed = 0;
+    try {
+        flushed = flushBatch(true);
+    } catch (...) {
+        _buffer.append(_overflow);
+        _numSpans = 1;
+        _batchMinSpanSize = spanSize;
+        throw;
+    }
+    _buffer.append(_overflow);
+    _numSpans = 1;
+    _batchMinSpanSize = spanSize;
     return flushed;
 }
 
-int ThriftSender::flush()
+int ThriftSender::flushBatch(bool full)
 {
-    if (_spanBuffer.empty()) {
+    _numDeferred = 0;
+    if (_numSpans == 0) {
         return 0;
     }
 
-    thrift::Batch batch;
-    batch.__set_process(_process);
-    batch.__set_spans(_spanBuffer);
-
+    const auto numSpans = _numSpans;
+    _listHeader.clear();
+    utils::ThriftWriter(_writer.protocol(), _listHeader)
+        .writeListBegin(utils::ThriftWriter::Type::kStruct, numSpans);
+    const auto start = _headroom - _listHeader.size() - _prefix.size();
+    std::copy(std::begin(_prefix), std::end(_prefix), &_buffer[start]);
+    std::copy(std::begin(_listHeader),
+              std::end(_listHeader),
+              &_buffer[start + _prefix.size()]);
+    _buffer += _suffix;
+
+    const auto size = _buffer.size() - start;
     try {
-      _transporter->emitBatch(batch);
+        _transporter->emitEncodedBatch(&_buffer[start], size);
     } catch (const std::system_error& ex) {
+        resetBuffers();
         std::ostringstream oss;
         oss << "Could not send span " << ex.what()
             << ", code=" << ex.code().value();
-        throw Sender::Exception(oss.str(), _spanBuffer.size());
+        throw Sender::Exception(oss.str(), numSpans);
     } catch (const std::exception& ex) {
+        resetBuffers();
         std::ostringstream oss;
         oss << "Could not send span " << ex.what();
-        throw Sender::Exception(oss.str(), _spanBuffer.size());
+        throw Sender::Exception(oss.str(), numSpans);
     } catch (...) {
+        resetBuffers();
         throw Sender::Exception("Could not send span, unknown error",
-                                _spanBuffer.size());
+                                numSpans);
     }
 
     resetBuffers();
+    if (_transporter->lastBatchDeferred()) {
+        _numDeferred = numSpans;
+    }
 
-    return batch.spans.size();
+    if (_metrics) {
+        (full ? _metrics->reporterBatchesFull()
+              : _metrics->reporterBatchesPartial())
+            .inc(1);
+        _metrics->reporterSentBytes().inc(size);
+        const auto maxPacketSize =
+            static_cast<size_t>(_transporter->maxPacketSize());
+        if (size < maxPacketSize) {
+            _metrics->reporterUnusedBytes().inc(maxPacketSize - size);
+        }
+    }
+    return numSpans;
+}
+
+void ThriftSender::encodeFraming(const Span& span)
+{
+    using Type = utils::ThriftWriter::Type;
+
+    const auto& tracer = static_cast<const Tracer&>(span.tracer());
+    const auto& tracerTags = tracer.tags();
+
+    std::string frame;
+    utils::ThriftWriter writer(_writer.protocol(), frame);
+    _transporter->writeBatchPrefix(writer);
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kStruct, 1);
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kString, 1);
+    writer.writeString(tracer.serviceName());
+    writer.writeFieldBegin(Type::kList, 2);
+    writer.writeListBegin(Type::kStruct, tracerTags.size());
+    for (auto&& tag : tracerTags) {
+        tag.encode(writer);
+    }
+    writer.writeStructEnd();
+    writer.writeFieldBegin(Type::kList, 2);
+    const auto prefixSize = frame.size();
+    writer.writeStructEnd();
+    _transporter->writeBatchSuffix(writer);
+
+    _prefix = frame.substr(0, prefixSize);
+    _suffix = frame.substr(prefixSize);
+    _headroom = _prefix.size() +
+                _writer.listHeaderSize(std::numeric_limits<int>::max());
+    _buffer.assign(_headroom, '\0');
+    _numSpans = 0;
 }
 
 }  // namespace jaegertracing
@@ -20,21 +20,43 @@
 #include "jaegertracing/Compilers.h"
 #include "jaegertracing/Span.h"
 #include "jaegertracing/Sender.h"
-#include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/EncodingCache.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 #include "jaegertracing/utils/Transport.h"
-#include <thrift/transport/TBufferTransports.h>
+#include <limits>
 
 namespace jaegertracing {
 
+namespace metrics {
+class Metrics;
+}
+
 class ThriftSender : public Sender {
   public:
-    ThriftSender(std::unique_ptr<utils::Transport>&& transporter);
+    // Batch packing is recorded in `metrics` when given, which must outlive
+    // the sender.
+    explicit ThriftSender(std::unique_ptr<utils::Transport>&& transporter,
+                          metrics::Metrics* metrics = nullptr);
 
     ~ThriftSender() { close(); }
 
     int append(const Span& span) override;
 
-    int flush() override;
+    int flush() override { return flushBatch(false); }
+
+    int numDeferred() const override { return _numDeferred; }
+
+    void prepareFork() override { _transporter->prepareFork(); }
+
+    void parentAfterFork() override { _transporter->parentAfterFork(); }
+
+    void childAfterFork() override { _transporter->childAfterFork(); }
+
+    void resetAfterFork() override
+    {
+        resetBuffers();
+        _transporter->resetAfterFork();
+    }
 
     void close() override { _transporter->close(); }
 
@@ -42,37 +64,63 @@ class ThriftSender : public Sender {
     void setClient(std::unique_ptr<utils::Transport>&& client)
     {
       _transporter = std::move(client);
+      _writer = utils::ThriftWriter(_transporter->encodedProtocol(), _buffer);
+      // The new transport may use another protocol.
+      _tagCache.clear();
+      _writer.setCache(&_tagCache);
+      _prefix.clear();
+      _suffix.clear();
+      _headroom = 0;
+      _buffer.clear();
+      _numSpans = 0;
+      _minSpanSize = std::numeric_limits<size_t>::max();
+      _batchMinSpanSize = std::numeric_limits<size_t>::max();
     }
 
   private:
-    void resetBuffers()
+    void encodeFraming(const Span& span);
+
+    int flushBatch(bool full);
+
+    size_t batchSize(int numSpans, size_t spanBytes) const
     {
-        _spanBuffer.clear();
-        _byteBufferSize = _processByteSize;
+        return _prefix.size() + _writer.listHeaderSize(numSpans) + spanBytes +
+               _suffix.size();
     }
 
-    template <typename ThriftType>
-    int calcSizeOfSerializedThrift(const ThriftType& base)
+    void resetBuffers()
     {
-        _thriftBuffer->resetBuffer();
-        auto _protocol = _protocolFactory->getProtocol(_thriftBuffer);
-        base.write(_protocol.get());
-        uint8_t* data = nullptr;
-        uint32_t size = 0;
-        _thriftBuffer->getBuffer(&data, &size);
-        return size;
+        _buffer.resize(_headroom);
+        _numSpans = 0;
+        if (_batchMinSpanSize != std::numeric_limits<size_t>::max()) {
+            _minSpanSize = _batchMinSpanSize;
+            _batchMinSpanSize = std::numeric_limits<size_t>::max();
+        }
     }
 
     std::unique_ptr<utils::Transport> _transporter;
-    int _maxSpanBytes;
-    int _byteBufferSize;
-    std::vector<thrift::Span> _spanBuffer;
-    thrift::Process _process;
-    int _processByteSize;
-    std::unique_ptr<apache::thrift::protocol::TProtocolFactory> _protocolFactory;
-    // reuse buffer across serializations of different ThriftType for size
-    // calculation
-    std::shared_ptr<apache::thrift::transport::TMemoryBuffer> _thriftBuffer;
+    // Spans are encoded right after `_headroom` reserved bytes. The batch
+    // framing and span list header are copied in front of them on flush, so
+    // the encoded spans are never moved.
+    std::string _buffer;
+    // Encoded bytes of repeated tags, keyed by their interned key and value.
+    utils::EncodingCache _tagCache;
+    utils::ThriftWriter _writer;
+    // Everything up to the span list header: transport framing, the start of
+    // the Batch struct and the encoded Process.
+    std::string _prefix;
+    std::string _suffix;
+    size_t _headroom;
+    int _numSpans;
+    std::string _listHeader;
+    std::string _overflow;
+    // The smallest span of the previous and the current batch. Once it would
+    // no longer fit, the batch is as full as it gets and is sent right away
+    // rather than after the next span overflows it.
+    size_t _minSpanSize;
+    size_t _batchMinSpanSize;
+    int _numDeferred;
+    metrics::Metrics* _metrics;
 };
 
 }  // namespace jaegertracing
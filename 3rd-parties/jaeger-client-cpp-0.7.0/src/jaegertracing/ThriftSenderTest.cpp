@@ -18,8 +18,12 @@
 
 #include "jaegertracing/Tracer.h"
 #include "jaegertracing/ThriftSender.h"
+#include "jaegertracing/metrics/Metrics.h"
+#include "jaegertracing/metrics/ShardedStatsFactory.h"
 #include "jaegertracing/testutils/TracerUtil.h"
 #include "jaegertracing/utils/ErrorUtil.h"
+#include <chrono>
+#include <thread>
 
 namespace jaegertracing {
 namespace {
@@ -37,7 +41,7 @@ class MockUDPSender : public utils::UDPTransporter {
     }
 
   private:
-    void emitBatch(const thrift::Batch& batch) override
+    void emitEncodedBatch(const char* data, size_t size) override
     {
         switch (_type) {
         case ExceptionType::kSystemError:
@@ -64,6 +68,25 @@ class MockThriftSender : public ThriftSender {
     }
 };
 
+class RecordingUDPSender : public utils::UDPTransporter {
+  public:
+    RecordingUDPSender(const net::IPAddress& serverAddr,
+                       int maxPacketSize,
+                       std::vector<size_t>& batchSizes)
+        : UDPTransporter(serverAddr, maxPacketSize)
+        , _batchSizes(batchSizes)
+    {
+    }
+
+  private:
+    void emitEncodedBatch(const char* data, size_t size) override
+    {
+        _batchSizes.push_back(size);
+    }
+
+    std::vector<size_t>& _batchSizes;
+};
+
 }  // anonymous namespace
 
 TEST(ThriftSender, testManyMessages)
@@ -85,6 +108,93 @@ TEST(ThriftSender, testManyMessages)
     }
 }
 
+TEST(ThriftSender, testBatchesDecodedByAgent)
+{
+    const auto handle = testutils::TracerUtil::installGlobalTracer();
+    const auto tracer =
+        std::static_pointer_cast<const Tracer>(opentracing::Tracer::Global());
+    handle->_mockAgent->resetBatches();
+
+    ThriftSender sender(handle->_mockAgent->spanServerClient());
+    constexpr auto kNumSpans = 20;
+    for (auto i = 0; i < kNumSpans; ++i) {
+        Span span(tracer);
+        span.SetOperationName("test" + std::to_string(i));
+        span.SetTag("index", i);
+        ASSERT_EQ(0, sender.append(span));
+    }
+    ASSERT_EQ(kNumSpans, sender.flush());
+
+    constexpr auto kNumTries = 100;
+    for (auto i = 0; i < kNumTries; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!handle->_mockAgent->batches().empty()) {
+            break;
+        }
+    }
+    const auto batches = handle->_mockAgent->batches();
+    ASSERT_EQ(1, static_cast<int>(batches.size()));
+    ASSERT_EQ(tracer->serviceName(), batches[0].process.serviceName);
+    ASSERT_EQ(tracer->tags().size(), batches[0].process.tags.size());
+    ASSERT_EQ(kNumSpans, static_cast<int>(batches[0].spans.size()));
+    for (auto i = 0; i < kNumSpans; ++i) {
+        const auto& span = batches[0].spans[i];
+        ASSERT_EQ("test" + std::to_string(i), span.operationName);
+        ASSERT_EQ(1, static_cast<int>(span.tags.size()));
+        ASSERT_EQ(i, span.tags[0].vLong);
+    }
+}
+
+TEST(ThriftSender, testFullBatchesSentEagerly)
+{
+    const auto handle = testutils::TracerUtil::installGlobalTracer();
+    const auto tracer =
+        std::static_pointer_cast<const Tracer>(opentracing::Tracer::Global());
+
+    constexpr auto kMaxPacketSize = 1000;
+    std::vector<size_t> batchSizes;
+    metrics::ShardedStatsFactory factory;
+    metrics::Metrics metrics(factory);
+    ThriftSender sender(
+        std::unique_ptr<utils::Transport>(new RecordingUDPSender(
+            handle->_mockAgent->spanServerAddress(),
+            kMaxPacketSize,
+            batchSizes)),
+        &metrics);
+
+    // Equally sized spans, so a batch is full as soon as one more span
+    // would not fit. It is sent with the span that filled it rather than
+    // when the next span overflows it.
+    auto numSpans = 0;
+    auto flushed = 0;
+    while (flushed == 0) {
+        Span span(tracer);
+        span.SetOperationName("test" + std::to_string(1000 + numSpans));
+        flushed = sender.append(span);
+        ++numSpans;
+        ASSERT_GT(kMaxPacketSize, numSpans);
+    }
+    ASSERT_EQ(numSpans, flushed);
+    ASSERT_EQ(1, static_cast<int>(batchSizes.size()));
+    ASSERT_GE(static_cast<size_t>(kMaxPacketSize), batchSizes[0]);
+
+    Span span(tracer);
+    span.SetOperationName("test");
+    ASSERT_EQ(0, sender.append(span));
+    ASSERT_EQ(1, sender.flush());
+    ASSERT_EQ(2, static_cast<int>(batchSizes.size()));
+
+    const auto snapshot = factory.snapshot();
+    const auto& counters = snapshot._counters;
+    ASSERT_EQ(1, counters.at("jaeger.reporter-batches.state=full")._value);
+    ASSERT_EQ(1, counters.at("jaeger.reporter-batches.state=partial")._value);
+    ASSERT_EQ(static_cast<int64_t>(batchSizes[0] + batchSizes[1]),
+              counters.at("jaeger.reporter-bytes.state=sent")._value);
+    ASSERT_EQ(static_cast<int64_t>(2 * kMaxPacketSize - batchSizes[0] -
+                                   batchSizes[1]),
+              counters.at("jaeger.reporter-bytes.state=unused")._value);
+}
+
 TEST(ThriftSender, testExceptions)
 {
     const auto handle = testutils::TracerUtil::installGlobalTracer();
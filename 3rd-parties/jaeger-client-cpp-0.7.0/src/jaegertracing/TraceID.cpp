@@ -22,28 +22,50 @@
 
 namespace jaegertracing {
 
+constexpr int TraceID::kMaxHexLength;
+
 TraceID TraceID::fromStream(std::istream& in)
 {
-    TraceID traceID;
     constexpr auto kMaxChars = static_cast<size_t>(32);
-    auto buffer = utils::HexParsing::readSegment(in, kMaxChars, ':');
+    const auto buffer = utils::HexParsing::readSegment(in, kMaxChars, ':');
+    return fromHex(buffer);
+}
 
-    if (buffer.empty()) {
+TraceID TraceID::fromHex(opentracing::string_view hex)
+{
+    constexpr auto kMaxUInt64Chars = static_cast<size_t>(16);
+    if (hex.empty()) {
         return TraceID();
     }
 
-    if (buffer.size() < kMaxChars / 2) {
-        traceID._low = utils::HexParsing::decodeHex<uint64_t>(buffer);
+    TraceID traceID;
+    if (hex.size() == kMaxHexLength &&
+        utils::HexParsing::decodeHex16(hex.data(), traceID._high) &&
+        utils::HexParsing::decodeHex16(hex.data() + kMaxUInt64Chars,
+                                       traceID._low)) {
+        return traceID;
+    }
+
+    if (hex.size() < kMaxUInt64Chars) {
+        traceID._low = utils::HexParsing::decodeHex<uint64_t>(hex);
     }
     else {
-        auto beginLowStr = std::end(buffer) - kMaxChars / 2;
-        const std::string highStr(std::begin(buffer), beginLowStr);
-        traceID._high = utils::HexParsing::decodeHex<uint64_t>(highStr);
-        const std::string lowStr(beginLowStr, std::end(buffer));
-        traceID._low = utils::HexParsing::decodeHex<uint64_t>(lowStr);
+        const auto highSize = hex.size() - kMaxUInt64Chars;
+        traceID._high = utils::HexParsing::decodeHex<uint64_t>(
+            opentracing::string_view(hex.data(), highSize));
+        traceID._low = utils::HexParsing::decodeHex<uint64_t>(
+            opentracing::string_view(hex.data() + highSize, kMaxUInt64Chars));
     }
 
     return traceID;
 }
 
+char* TraceID::toChars(char* first) const
+{
+    if (_high != 0) {
+        first = utils::HexParsing::encodeHex16(_high, first);
+    }
+    return utils::HexParsing::encodeHex16(_low, first);
+}
+
 }  // namespace jaegertracing
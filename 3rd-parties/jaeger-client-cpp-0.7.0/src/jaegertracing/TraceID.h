@@ -21,12 +21,20 @@
 #include <iomanip>
 #include <iostream>
 
+#include <opentracing/string_view.h>
+
 namespace jaegertracing {
 
 class TraceID {
   public:
+    // Longest output of toChars, a 128-bit ID.
+    static constexpr auto kMaxHexLength = 32;
+
     static TraceID fromStream(std::istream& in);
 
+    // Decodes up to 32 hex digits, as returned by HexParsing::readSegment.
+    static TraceID fromHex(opentracing::string_view hex);
+
     TraceID()
         : TraceID(0, 0)
     {
@@ -40,16 +48,15 @@ class TraceID {
 
     bool isValid() const { return _high != 0 || _low != 0; }
 
+    // Writes 16 hex digits, or 32 if the high bits are set, and returns the
+    // end of the written range, like std::to_chars.
+    char* toChars(char* first) const;
+
     template <typename Stream>
     void print(Stream& out) const
     {
-        if (_high == 0) {
-            out << std::setw(16) << std::setfill('0') << std::hex << _low;
-        }
-        else {
-            out << std::setw(16) << std::setfill('0') << std::hex << _high
-                << std::setw(16) << std::setfill('0') << std::hex << _low;
-        }
+        char buffer[kMaxHexLength];
+        out.write(buffer, toChars(buffer) - buffer);
     }
 
     uint64_t high() const { return _high; }
@@ -38,11 +38,12 @@ using TimePoints = std::tuple<SystemClock::time_point, SteadyClock::time_point>;
 // An extension of opentracing::SpanReferenceType enum. See jaegertracing::SelfRef().
 const static int SpanReferenceType_JaegerSpecific_SelfRef = 99;
 
-TimePoints determineStartTimes(const opentracing::StartSpanOptions& options)
+TimePoints determineStartTimes(const opentracing::StartSpanOptions& options,
+                               const ClockSource& clock)
 {
     if (options.start_system_timestamp == SystemClock::time_point() &&
         options.start_steady_timestamp == SteadyClock::time_point()) {
-        return std::make_tuple(SystemClock::now(), SteadyClock::now());
+        return std::make_tuple(clock.systemNow(), clock.steadyNow());
     }
     if (options.start_system_timestamp == SystemClock::time_point()) {
         return std::make_tuple(opentracing::convert_time_point<SystemClock>(
@@ -63,6 +64,7 @@ TimePoints determineStartTimes(const opentracing::StartSpanOptions& options)
 using StrMap = SpanContext::StrMap;
 
 constexpr int Tracer::kGen128BitOption;
+constexpr int Tracer::kSingleOwnerSpanOption;
 
 std::unique_ptr<opentracing::Span>
 Tracer::StartSpanWithOptions(string_view operationName,
@@ -70,6 +72,7 @@ Tracer::StartSpanWithOptions(string_view operationName,
     noexcept
 {
     try {
+        const OperationName internedOperationName(operationName);
         const auto result = analyzeReferences(options.references);
         const auto* parent = result._parent;
         const auto* self = result._self;
@@ -108,21 +111,21 @@ Tracer::StartSpanWithOptions(string_view operationName,
             }
             else {
                 const auto samplingStatus =
-                    _sampler->isSampled(traceID, operationName);
+                    _sampler->isSampled(traceID, internedOperationName);
                 if (samplingStatus.isSampled()) {
                     flags |=
                         static_cast<unsigned char>(SpanContext::Flag::kSampled);
                     samplerTags = samplingStatus.tags();
                 }
             }
-            ctx = SpanContext(traceID, spanID, parentID, flags, StrMap());
+            ctx = SpanContext(traceID, spanID, parentID, flags, BaggageMap());
         }
         else {
             const auto traceID = parent->traceID();
             const auto spanID = randomID();
             const auto parentID = parent->spanID();
             const auto flags = parent->flags();
-            ctx = SpanContext(traceID, spanID, parentID, flags, StrMap());
+            ctx = SpanContext(traceID, spanID, parentID, flags, BaggageMap());
         }
 
         if (parent && !parent->baggage().empty()) {
@@ -132,14 +135,15 @@ Tracer::StartSpanWithOptions(string_view operationName,
         SystemClock::time_point startTimeSystem;
         SteadyClock::time_point startTimeSteady;
         std::tie(startTimeSystem, startTimeSteady) =
-            determineStartTimes(options);
+            determineStartTimes(options, *_clock);
         return startSpanInternal(ctx,
-                                 operationName,
+                                 internedOperationName,
                                  startTimeSystem,
                                  startTimeSteady,
                                  samplerTags,
                                  options.tags,
                                  newTrace,
+                                 newTrace || parent->isRemote(),
                                  references);
     } catch (const std::exception& ex) {
         std::ostringstream oss;
@@ -155,12 +159,13 @@ Tracer::StartSpanWithOptions(string_view operationName,
 
 std::unique_ptr<Span>
 Tracer::startSpanInternal(const SpanContext& context,
-                          const std::string& operationName,
+                          const OperationName& operationName,
                           const SystemClock::time_point& startTimeSystem,
                           const SteadyClock::time_point& startTimeSteady,
                           const std::vector<Tag>& internalTags,
                           const std::vector<OpenTracingTag>& tags,
                           bool newTrace,
+                          bool localRoot,
                           const std::vector<Reference>& references) const
 {
     std::vector<Tag> spanTags;
@@ -179,7 +184,11 @@ Tracer::startSpanInternal(const SpanContext& context,
                                         startTimeSystem,
                                         startTimeSteady,
                                         spanTags,
-                                        references));
+                                        references,
+                                        (_options & kSingleOwnerSpanOption)
+                                            ? Span::Concurrency::kSingleOwner
+                                            : Span::Concurrency::kThreadSafe));
+    span->setLocalRoot(localRoot);
 
     _metrics->spansStarted().inc(1);
     if (span->context().isSampled()) {
@@ -249,7 +258,9 @@ std::shared_ptr<opentracing::Tracer>
 Tracer::make(const std::string& serviceName,
                    const Config& config,
      const std::shared_ptr<logging::Logger>& logger,
-     metrics::StatsFactory& statsFactory, int options)
+     metrics::StatsFactory& statsFactory, int options,
+     const std::shared_ptr<reporters::Reporter>& reporter,
+     const std::shared_ptr<const ClockSource>& clock)
 {
     if (serviceName.empty()) {
         throw std::invalid_argument("no service name provided");
@@ -259,7 +270,8 @@ Tracer::make(const std::string& serviceName,
         return opentracing::MakeNoopTracer();
     }
 
-    auto metrics = std::make_shared<metrics::Metrics>(statsFactory);
+    auto metrics = std::make_shared<metrics::Metrics>(
+        statsFactory, config.reporter().numSenders());
 
     std::shared_ptr<TextMapPropagator> textPropagator;
     std::shared_ptr<HTTPHeaderPropagator> httpHeaderPropagator;
@@ -281,17 +293,27 @@ Tracer::make(const std::string& serviceName,
 
     std::shared_ptr<samplers::Sampler> sampler(
         config.sampler().makeSampler(serviceName, *logger, *metrics));
-    std::shared_ptr<reporters::Reporter> reporter(
-        config.reporter().makeReporter(serviceName, *logger, *metrics));
+    auto tracerReporter = reporter;
+    if (!tracerReporter) {
+        tracerReporter =
+            config.reporter().makeReporter(serviceName, *logger, *metrics);
+    }
+    std::shared_ptr<const ClockSource> tracerClock = clock;
+    if (!tracerClock) {
+        tracerClock = ClockSource::make(
+            config.clockType(), config.clockCoarseInterval(), *logger);
+    }
     return std::shared_ptr<Tracer>(new Tracer(serviceName,
                                               sampler,
-                                              reporter,
+                                              tracerReporter,
                                               logger,
                                               metrics,
                                               textPropagator,
                                               httpHeaderPropagator,
                                               config.tags(),
-                                              options));
+                                              options,
+                                              tracerClock,
+                                              config.logLimits()));
 }
 
 opentracing::SpanReference SelfRef(const opentracing::SpanContext* span_context) noexcept {
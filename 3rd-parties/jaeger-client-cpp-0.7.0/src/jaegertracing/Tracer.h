@@ -25,6 +25,7 @@
 #include <opentracing/noop.h>
 #include <opentracing/tracer.h>
 
+#include "jaegertracing/ClockSource.h"
 #include "jaegertracing/Compilers.h"
 #include "jaegertracing/Config.h"
 #include "jaegertracing/Constants.h"
@@ -52,6 +53,8 @@ class Tracer : public opentracing::Tracer,
     using string_view = opentracing::string_view;
 
     static constexpr auto kGen128BitOption = 1;
+    // Spans are started in Span::Concurrency::kSingleOwner mode.
+    static constexpr auto kSingleOwnerSpanOption = 2;
 
     static std::shared_ptr<opentracing::Tracer> make(const Config& config)
     {
@@ -82,14 +85,41 @@ class Tracer : public opentracing::Tracer,
          const std::shared_ptr<logging::Logger>& logger,
          metrics::StatsFactory& statsFactory)
     {
-        return make(serviceName, config, logger, statsFactory, config.traceId128Bit() ? kGen128BitOption : 0);
+        return make(serviceName,
+                    config,
+                    logger,
+                    statsFactory,
+                    (config.traceId128Bit() ? kGen128BitOption : 0) |
+                        (config.singleOwnerSpans() ? kSingleOwnerSpanOption
+                                                   : 0));
+    }
+    static std::shared_ptr<opentracing::Tracer>
+    make(const std::string& serviceName,
+         const Config& config,
+         const std::shared_ptr<logging::Logger>& logger,
+         metrics::StatsFactory& statsFactory,
+         int options)
+    {
+        return make(serviceName,
+                    config,
+                    logger,
+                    statsFactory,
+                    options,
+                    std::shared_ptr<reporters::Reporter>());
     }
+    // Reports spans to `reporter` instead of the reporter described by
+    // `config`, e.g. a reporters::NullReporter to measure tracing without
+    // reporting, and reads span timestamps from `clock` instead of the
+    // source named by `config`. Either is made from `config` when null.
     static std::shared_ptr<opentracing::Tracer>
     make(const std::string& serviceName,
          const Config& config,
          const std::shared_ptr<logging::Logger>& logger,
          metrics::StatsFactory& statsFactory,
-         int options);
+         int options,
+         const std::shared_ptr<reporters::Reporter>& reporter,
+         const std::shared_ptr<const ClockSource>& clock =
+             std::shared_ptr<const ClockSource>());
 
     ~Tracer() { Close(); }
 
@@ -143,8 +173,7 @@ class Tracer : public opentracing::Tracer,
         if (spanContext == SpanContext()) {
             return std::unique_ptr<opentracing::SpanContext>();
         }
-        return std::unique_ptr<opentracing::SpanContext>(
-            new SpanContext(spanContext));
+        return makeRemoteContext(spanContext);
     }
 
     opentracing::expected<std::unique_ptr<opentracing::SpanContext>>
@@ -154,8 +183,7 @@ class Tracer : public opentracing::Tracer,
         if (spanContext == SpanContext()) {
             return std::unique_ptr<opentracing::SpanContext>();
         }
-        return std::unique_ptr<opentracing::SpanContext>(
-            new SpanContext(spanContext));
+        return makeRemoteContext(spanContext);
     }
 
     opentracing::expected<std::unique_ptr<opentracing::SpanContext>>
@@ -165,8 +193,7 @@ class Tracer : public opentracing::Tracer,
         if (spanContext == SpanContext()) {
             return std::unique_ptr<opentracing::SpanContext>();
         }
-        return std::unique_ptr<opentracing::SpanContext>(
-            new SpanContext(spanContext));
+        return makeRemoteContext(spanContext);
     }
 
     void Close() noexcept override
@@ -192,6 +219,10 @@ class Tracer : public opentracing::Tracer,
         return _baggageSetter;
     }
 
+    const ClockSource& clock() const { return *_clock; }
+
+    const LogLimits& logLimits() const { return _logLimits; }
+
     void reportSpan(const Span& span) const
     {
         _metrics->spansFinished().inc(1);
@@ -216,7 +247,9 @@ class Tracer : public opentracing::Tracer,
            const std::shared_ptr<TextMapPropagator> &textPropagator,
            const std::shared_ptr<HTTPHeaderPropagator> &httpHeaderPropagator,
            const std::vector<Tag>& tags,
-           int options)
+           int options,
+           const std::shared_ptr<const ClockSource>& clock,
+           const LogLimits& logLimits)
         : _serviceName(serviceName)
         , _hostIPv4(net::IPAddress::localIP(AF_INET))
         , _sampler(sampler)
@@ -231,6 +264,8 @@ class Tracer : public opentracing::Tracer,
         , _restrictionManager(new baggage::DefaultRestrictionManager(0))
         , _baggageSetter(*_restrictionManager, *_metrics)
         , _options(options)
+        , _clock(clock)
+        , _logLimits(logLimits)
     {
         _tags.push_back(Tag(kJaegerClientVersionTagKey, kJaegerClientVersion));
 
@@ -267,14 +302,25 @@ class Tracer : public opentracing::Tracer,
 
     std::unique_ptr<Span>
     startSpanInternal(const SpanContext& context,
-                      const std::string& operationName,
+                      const OperationName& operationName,
                       const SystemClock::time_point& startTimeSystem,
                       const SteadyClock::time_point& startTimeSteady,
                       const std::vector<Tag>& internalTags,
                       const std::vector<OpenTracingTag>& tags,
                       bool newTrace,
+                      bool localRoot,
                       const std::vector<Reference>& references) const;
 
+    static std::unique_ptr<opentracing::SpanContext>
+    makeRemoteContext(const SpanContext& spanContext)
+    {
+        std::unique_ptr<SpanContext> remoteContext(
+            new SpanContext(spanContext));
+        remoteContext->setRemote(true);
+        return std::unique_ptr<opentracing::SpanContext>(
+            std::move(remoteContext));
+    }
+
     using OpenTracingRef = std::pair<opentracing::SpanReferenceType,
                                      const opentracing::SpanContext*>;
 
@@ -309,6 +355,8 @@ class Tracer : public opentracing::Tracer,
     std::unique_ptr<baggage::RestrictionManager> _restrictionManager;
     baggage::BaggageSetter _baggageSetter;
     int _options;
+    std::shared_ptr<const ClockSource> _clock;
+    LogLimits _logLimits;
 };
 
 
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/Config.h"
+#include "jaegertracing/Logging.h"
+#include "jaegertracing/Tracer.h"
+#include "jaegertracing/metrics/NullStatsFactory.h"
+#include "jaegertracing/net/IPAddress.h"
+#include "jaegertracing/net/Socket.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jaegertracing {
+namespace {
+
+constexpr auto kMaxThreads = 8;
+
+// Spans are reported over UDP to a socket that is never read, so the
+// reporter does its usual work and the kernel drops the datagrams.
+const net::IPAddress& sinkAddress()
+{
+    static const struct Sink {
+        Sink()
+            : _socket()
+            , _address()
+        {
+            _socket.open(AF_INET, SOCK_DGRAM);
+            _socket.bind(net::IPAddress::v4("127.0.0.1", 0));
+            ::sockaddr_storage addrStorage;
+            ::socklen_t addrLen = sizeof(addrStorage);
+            ::getsockname(_socket.handle(),
+                          reinterpret_cast<::sockaddr*>(&addrStorage),
+                          &addrLen);
+            _address = net::IPAddress(addrStorage, addrLen);
+        }
+
+        net::Socket _socket;
+        net::IPAddress _address;
+    } sink;
+    return sink._address;
+}
+
+std::shared_ptr<opentracing::Tracer> makeTracer(bool sampled,
+                                                int options = 0)
+{
+    const Config config(
+        false,
+        false,
+        samplers::Config("const",
+                         sampled ? 1 : 0,
+                         "",
+                         0,
+                         samplers::Config::Clock::duration()),
+        reporters::Config(10000,
+                          std::chrono::milliseconds(100),
+                          false,
+                          sinkAddress().authority()));
+    metrics::NullStatsFactory factory;
+    return Tracer::make(
+        "benchmark", config, logging::nullLogger(), factory, options);
+}
+
+const std::shared_ptr<opentracing::Tracer>& sampledTracer()
+{
+    static const auto tracer = makeTracer(true);
+    return tracer;
+}
+
+const std::shared_ptr<opentracing::Tracer>& singleOwnerTracer()
+{
+    static const auto tracer =
+        makeTracer(true, Tracer::kSingleOwnerSpanOption);
+    return tracer;
+}
+
+const std::shared_ptr<opentracing::Tracer>& notSampledTracer()
+{
+    static const auto tracer = makeTracer(false);
+    return tracer;
+}
+
+void BM_StartSpanSampled(benchmark::State& state)
+{
+    const auto& tracer = sampledTracer();
+    for (auto _ : state) {
+        auto span = tracer->StartSpan("operation");
+        span->Finish();
+    }
+}
+BENCHMARK(BM_StartSpanSampled)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+void BM_StartSpanNotSampled(benchmark::State& state)
+{
+    const auto& tracer = notSampledTracer();
+    for (auto _ : state) {
+        auto span = tracer->StartSpan("operation");
+        span->Finish();
+    }
+}
+BENCHMARK(BM_StartSpanNotSampled)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+void BM_StartChildSpan(benchmark::State& state)
+{
+    const auto& tracer = sampledTracer();
+    const auto parent = tracer->StartSpan("parent");
+    for (auto _ : state) {
+        auto span = tracer->StartSpan(
+            "operation", { opentracing::ChildOf(&parent->context()) });
+        span->Finish();
+    }
+}
+BENCHMARK(BM_StartChildSpan)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+constexpr auto kNumTagValues = 8;
+
+// One value of each opentracing::Value alternative that may be a tag.
+const std::vector<std::pair<std::string, opentracing::Value>>& tagValues()
+{
+    static const std::vector<std::pair<std::string, opentracing::Value>>
+        values = { { "bool", true },
+                   { "double", 3.14 },
+                   { "int64", static_cast<int64_t>(-42) },
+                   { "uint64", static_cast<uint64_t>(42) },
+                   { "string", std::string("GET /api/v1/traces") },
+                   { "string_view",
+                     opentracing::string_view("GET /api/v1/traces") },
+                   { "const_char", "GET /api/v1/traces" },
+                   { "null", nullptr } };
+    return values;
+}
+
+// Each span takes a bounded number of tags or logs so memory stays flat.
+// Starting and finishing the span is amortized over them.
+constexpr auto kRecordsPerSpan = 64;
+
+void BM_SetTag(benchmark::State& state)
+{
+    const auto& tracer = sampledTracer();
+    const auto& value = tagValues()[state.range(0)];
+    state.SetLabel(value.first);
+    auto span = tracer->StartSpan("operation");
+    auto numTags = 0;
+    for (auto _ : state) {
+        span->SetTag("http.request", value.second);
+        if (++numTags == kRecordsPerSpan) {
+            span = tracer->StartSpan("operation");
+            numTags = 0;
+        }
+    }
+}
+BENCHMARK(BM_SetTag)
+    ->DenseRange(0, kNumTagValues - 1)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+void BM_Log(benchmark::State& state)
+{
+    const auto& tracer = sampledTracer();
+    auto span = tracer->StartSpan("operation");
+    auto numLogs = 0;
+    for (auto _ : state) {
+        span->Log({ { "event", "cache.miss" },
+                    { "key", static_cast<int64_t>(numLogs) } });
+        if (++numLogs == kRecordsPerSpan) {
+            span = tracer->StartSpan("operation");
+            numLogs = 0;
+        }
+    }
+}
+BENCHMARK(BM_Log)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+// The span of a request handler like the customer service's handle_get: a
+// few tags and a log from the one thread serving the request. The argument
+// selects single owner spans.
+void BM_HandleRequest(benchmark::State& state)
+{
+    const auto& tracer =
+        state.range(0) ? singleOwnerTracer() : sampledTracer();
+    state.SetLabel(state.range(0) ? "single_owner" : "thread_safe");
+    for (auto _ : state) {
+        auto span = tracer->StartSpan("handle_get");
+        span->SetTag("http.method", "GET");
+        span->SetTag("http.status_code", static_cast<int64_t>(200));
+        span->Log({ { "event", "response.prepared" } });
+        span->Finish();
+    }
+}
+BENCHMARK(BM_HandleRequest)
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // anonymous namespace
+}  // namespace jaegertracing
@@ -334,6 +334,31 @@ TEST(Tracer, testDisabledConfig)
         Tracer::make("test-service", config))));
 }
 
+TEST(Tracer, testMakeWithNullOverrides)
+{
+    Config config;
+    metrics::NullStatsFactory factory;
+    // Null reporter and clock are both made from the config.
+    auto tracer = std::static_pointer_cast<Tracer>(Tracer::make(
+        "test-service", config, logging::nullLogger(), factory, 0, nullptr));
+    ASSERT_NE(nullptr,
+              dynamic_cast<const SystemClockSource*>(&tracer->clock()));
+    tracer->Close();
+
+    const std::shared_ptr<const ClockSource> clock =
+        std::make_shared<CoarseClockSource>(std::chrono::milliseconds(1));
+    tracer = std::static_pointer_cast<Tracer>(
+        Tracer::make("test-service",
+                     config,
+                     logging::nullLogger(),
+                     factory,
+                     0,
+                     nullptr,
+                     clock));
+    ASSERT_EQ(clock.get(), &tracer->clock());
+    tracer->Close();
+}
+
 TEST(Tracer, testPropagation)
 {
     const auto handle = testutils::TracerUtil::installGlobalTracer();
@@ -421,6 +446,19 @@ TEST(Tracer, testPropagation)
             "yes");
         ASSERT_EQ(ctx, *extractedCtx);
 
+        // Test header keys are matched regardless of case.
+        headerMap.clear();
+        headerMap["Uber-Trace-ID"] = oss.str();
+        headerMap["UberCtx-Mixed-Key"] = "x%20y";
+        result = tracer->Extract(headerReader);
+        ASSERT_TRUE(static_cast<bool>(result));
+        extractedCtx.reset(static_cast<SpanContext*>(result->release()));
+        ASSERT_TRUE(static_cast<bool>(extractedCtx));
+        ASSERT_EQ(span->context().traceID(), extractedCtx->traceID());
+        ASSERT_EQ(span->context().spanID(), extractedCtx->spanID());
+        ASSERT_EQ(1, extractedCtx->baggage().size());
+        ASSERT_EQ("x y", extractedCtx->baggage().at("mixed-key"));
+
         // Test bad trace context.
         headerMap.clear();
         headerMap[kTraceContextHeaderName] = "12345678";
@@ -553,6 +591,53 @@ TEST(Tracer, testTracerTags)
     ASSERT_EQ(std::string("test-service"), jaegerTracer->serviceName());
 }
 
+TEST(Tracer, testLogLimits)
+{
+    Config config(
+        false,
+        false,
+        samplers::Config(
+            "const", 1, "", 0, samplers::Config::Clock::duration()),
+        reporters::Config(0, std::chrono::milliseconds(100), false, "", ""),
+        propagation::HeadersConfig(),
+        baggage::RestrictionsConfig(),
+        "test-service",
+        std::vector<Tag>(),
+        propagation::Format::JAEGER,
+        ClockSource::Type::kSystem,
+        std::chrono::microseconds(0),
+        false,
+        LogLimits(10, LogLimits::kDefaultMaxLogBytes, 2, 3));
+    auto tracer = Tracer::make(config);
+    std::unique_ptr<Span> span(
+        static_cast<Span*>(tracer->StartSpan("test-log-limits").release()));
+    ASSERT_TRUE(static_cast<bool>(span));
+
+    span->Log({ { "event", "start" } });
+    // Keeps the first two retries and then every third one: 1, 2, 5 and 8.
+    // Built at runtime, so the event value is not interned.
+    const std::string retry("retry");
+    for (auto i = 0; i < 10; ++i) {
+        span->Log({ { "event", retry }, { "attempt", i } });
+    }
+    for (auto i = 0; i < 20; ++i) {
+        span->Log({ { "attempt", i } });
+    }
+    span->Finish();
+
+    thrift::Span thriftSpan;
+    span->thrift(thriftSpan);
+    ASSERT_EQ(10, static_cast<int>(thriftSpan.logs.size()));
+    const auto tags = span->tags();
+    const auto itr =
+        std::find_if(std::begin(tags), std::end(tags), [](const Tag& tag) {
+            return tag.key() == kDroppedLogsTagKey;
+        });
+    ASSERT_NE(std::end(tags), itr);
+    ASSERT_EQ(6 + 15, itr->value().get<int64_t>());
+    tracer->Close();
+}
+
 TEST(Tracer, testTracerSimpleChild)
 {
     const auto handle = testutils::TracerUtil::installGlobalTracer();
@@ -567,6 +652,41 @@ TEST(Tracer, testTracerSimpleChild)
     tracer->Close();
 }
 
+TEST(Tracer, testLocalRoot)
+{
+    const auto handle = testutils::TracerUtil::installGlobalTracer();
+    const auto tracer =
+        std::static_pointer_cast<Tracer>(opentracing::Tracer::Global());
+    const std::unique_ptr<Span> root(
+        static_cast<Span*>(tracer->StartSpan("root").release()));
+    ASSERT_TRUE(root->isLocalRoot());
+    ASSERT_FALSE(root->context().isRemote());
+
+    StrMap textMap;
+    WriterMock<opentracing::TextMapWriter> textWriter(textMap);
+    ASSERT_TRUE(static_cast<bool>(tracer->Inject(root->context(), textWriter)));
+    ReaderMock<opentracing::TextMapReader> textReader(textMap);
+    auto result = tracer->Extract(textReader);
+    ASSERT_TRUE(static_cast<bool>(result));
+    std::unique_ptr<const SpanContext> remoteCtx(
+        static_cast<SpanContext*>(result->release()));
+    ASSERT_TRUE(remoteCtx->isRemote());
+
+    // A server span continues the trace of another process.
+    const std::unique_ptr<Span> server(static_cast<Span*>(
+        tracer->StartSpan("server", { opentracing::ChildOf(remoteCtx.get()) })
+            .release()));
+    ASSERT_NE(0u, server->context().parentID());
+    ASSERT_TRUE(server->isLocalRoot());
+    ASSERT_FALSE(server->context().isRemote());
+    const std::unique_ptr<Span> child(static_cast<Span*>(
+        tracer
+            ->StartSpan("child", { opentracing::ChildOf(&server->context()) })
+            .release()));
+    ASSERT_FALSE(child->isLocalRoot());
+    tracer->Close();
+}
+
 TEST(Tracer, testTracerSpanSelfRef)
 {
     const auto handle = testutils::TracerUtil::installGlobalTracer();
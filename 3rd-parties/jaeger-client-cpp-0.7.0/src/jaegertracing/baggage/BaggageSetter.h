@@ -36,7 +36,7 @@ class BaggageSetter {
 
     template <typename LoggingFunction>
     void setBaggage(Span& span,
-                    SpanContext::StrMap& baggage,
+                    BaggageMap& baggage,
                     const std::string& key,
                     std::string value,
                     LoggingFunction logFn) const
@@ -65,12 +65,7 @@ class BaggageSetter {
         auto itr = baggage.find(key);
         const auto prevItem =
             (itr == std::end(baggage) ? std::string() : itr->second);
-        if (itr == std::end(baggage)) {
-            baggage[key] = value;
-        }
-        else {
-            itr->second = value;
-        }
+        baggage[key] = value;
         logFields(span,
                   key,
                   value,
@@ -36,7 +36,8 @@ RemoteRestrictionManager::RemoteRestrictionManager(
     bool denyBaggageOnInitializationFailure,
     const Clock::duration& refreshInterval,
     logging::Logger& logger,
-    metrics::Metrics& metrics)
+    metrics::Metrics& metrics,
+    utils::Poller& poller)
     : _serviceName(serviceName)
     , _serverAddress(
           net::IPAddress::v4(hostPort.empty() ? kDefaultHostPort : hostPort))
@@ -46,27 +47,40 @@ RemoteRestrictionManager::RemoteRestrictionManager(
                            : refreshInterval)
     , _logger(logger)
     , _metrics(metrics)
-    , _running(true)
-    , _initialized(false)
-    , _thread([this]() { poll(); })
+    , _restrictionsGet(net::URI())
+    , _restrictions()
+    , _poller(poller)
+    , _mutex()
+    , _pollTask(0)
 {
+    try {
+        _restrictionsGet = net::http::ConditionalGet(
+            restrictionsURI(_serviceName, _serverAddress));
+    } catch (...) {
+        // Never polls, so the initialization failure policy stays in effect.
+        utils::ErrorUtil::logError(
+            _logger, "Failed to build the baggage restrictions URI");
+        return;
+    }
+    _pollTask =
+        _poller.add(_refreshInterval, [this]() { updateRestrictions(); });
 }
 
 Restriction
 RemoteRestrictionManager::getRestriction(const std::string& /* service */,
                                          const std::string& key)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-
-    if (!_initialized) {
+    _poller.restartIfForked();
+    const auto restrictions = std::atomic_load(&_restrictions);
+    if (!restrictions) {
         if (_denyBaggageOnInitializationFailure) {
             return Restriction(false, 0);
         }
         return Restriction(true, kDefaultMaxValueLength);
     }
 
-    auto itr = _restrictions.find(key);
-    if (itr != std::end(_restrictions)) {
+    auto itr = restrictions->find(key);
+    if (itr != std::end(*restrictions)) {
         return itr->second;
     }
     return Restriction(false, 0);
@@ -74,61 +88,38 @@ RemoteRestrictionManager::getRestriction(const std::string& /* service */,
 
 void RemoteRestrictionManager::close() noexcept
 {
-    std::unique_lock<std::mutex> lock(_mutex);
-    if (!_running) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pollTask == 0) {
         return;
     }
-    _running = false;
-    lock.unlock();
-    _cv.notify_one();
-    _thread.join();
+    _poller.remove(_pollTask);
+    _pollTask = 0;
 }
 
-void RemoteRestrictionManager::poll() noexcept
+net::URI
+RemoteRestrictionManager::restrictionsURI(const std::string& serviceName,
+                                          const net::IPAddress& serverAddress)
 {
-    net::URI remoteURI;
-    try {
-        std::ostringstream oss;
-        oss << "http://" << _serverAddress.authority()
-            << "/baggageRestrictions?service="
-            << net::URI::queryEscape(_serviceName);
-        remoteURI = net::URI::parse(oss.str());
-        updateRestrictions(remoteURI);
-    } catch (...) {
-        auto logger = logging::consoleLogger();
-        utils::ErrorUtil::logError(*logger,
-                                   "Failed in RemoteRestrictionManager::poll");
-        return;
-    }
-
-    Clock::time_point lastUpdateTime = Clock::now();
-    while (true) {
-        {
-            std::unique_lock<std::mutex> lock(_mutex);
-            _cv.wait_until(lock, lastUpdateTime + _refreshInterval, [this]() {
-                return !_running;
-            });
-            if (!_running) {
-                return;
-            }
-        }
-
-        if ((Clock::now() - lastUpdateTime) >= _refreshInterval) {
-            updateRestrictions(remoteURI);
-            lastUpdateTime = Clock::now();
-        }
-    }
+    std::ostringstream oss;
+    oss << "http://" << serverAddress.authority()
+        << "/baggageRestrictions?service="
+        << net::URI::queryEscape(serviceName);
+    return net::URI::parse(oss.str());
 }
 
-void RemoteRestrictionManager::updateRestrictions(
-    const net::URI& remoteURI) noexcept
+void RemoteRestrictionManager::updateRestrictions() noexcept
 {
     try {
-        const auto responseHTTP = net::http::get(remoteURI);
+        net::http::Response responseHTTP;
+        if (!_restrictionsGet.get(responseHTTP)) {
+            // Unchanged, the current snapshot is still up to date.
+            _metrics.baggageRestrictionsUpdateSuccess().inc(1);
+            return;
+        }
         if (responseHTTP.statusCode() != 200) {
             std::ostringstream oss;
             oss << "Received HTTP error response"
-                << ", uri=" << remoteURI
+                << ", uri=" << _restrictionsGet.uri()
                 << ", statusCode=" << responseHTTP.statusCode()
                 << ", reason=" << responseHTTP.reason();
             _logger.error(oss.str());
@@ -138,24 +129,23 @@ void RemoteRestrictionManager::updateRestrictions(
         thrift::BaggageRestrictionManager_getBaggageRestrictions_result
             response = nlohmann::json::parse(responseHTTP.body());
         if (response.__isset.success) {
-            KeyRestrictionMap restrictions;
-            restrictions.reserve(response.success.size());
+            std::shared_ptr<KeyRestrictionMap> restrictions(
+                new KeyRestrictionMap());
+            restrictions->reserve(response.success.size());
             std::transform(
                 std::begin(response.success),
                 std::end(response.success),
-                std::inserter(restrictions, std::end(restrictions)),
+                std::inserter(*restrictions, std::end(*restrictions)),
                 [](const thrift::BaggageRestriction restriction) {
                     return std::make_pair(
                         restriction.baggageKey,
                         Restriction(true, restriction.maxValueLength));
                 });
-            {
-                std::lock_guard<std::mutex> lock(_mutex);
-                _restrictions = std::move(restrictions);
-                if (!_initialized) {
-                    _initialized = true;
-                }
-            }
+            std::atomic_store(
+                &_restrictions,
+                std::shared_ptr<const KeyRestrictionMap>(
+                    std::move(restrictions)));
+            _restrictionsGet.commit(responseHTTP);
             _metrics.baggageRestrictionsUpdateSuccess().inc(1);
         }
         else {
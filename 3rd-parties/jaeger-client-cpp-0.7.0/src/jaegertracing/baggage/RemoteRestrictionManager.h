@@ -18,10 +18,9 @@
 #define JAEGERTRACING_BAGGAGE_REMOTERESTRICTIONMANAGER_H
 
 #include <chrono>
-#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <unordered_map>
 
 #include "jaegertracing/Compilers.h"
@@ -32,11 +31,15 @@
 #include "jaegertracing/metrics/Metrics.h"
 #include "jaegertracing/net/IPAddress.h"
 #include "jaegertracing/net/URI.h"
+#include "jaegertracing/net/http/ConditionalGet.h"
 #include "jaegertracing/thrift-gen/BaggageRestrictionManager.h"
+#include "jaegertracing/utils/Poller.h"
 
 namespace jaegertracing {
 namespace baggage {
 
+// Polls the agent for baggage restrictions on the process-wide poller and
+// publishes them as an immutable snapshot read without locking.
 class RemoteRestrictionManager : public RestrictionManager {
   public:
     using Clock = std::chrono::steady_clock;
@@ -56,7 +59,8 @@ class RemoteRestrictionManager : public RestrictionManager {
                              bool denyBaggageOnInitializationFailure,
                              const Clock::duration& refreshInterval,
                              logging::Logger& logger,
-                             metrics::Metrics& metrics);
+                             metrics::Metrics& metrics,
+                             utils::Poller& poller = utils::Poller::shared());
 
     ~RemoteRestrictionManager() { close(); }
 
@@ -68,9 +72,10 @@ class RemoteRestrictionManager : public RestrictionManager {
     const Clock::duration& refreshInterval() const { return _refreshInterval; }
 
   private:
-    void poll() noexcept;
+    static net::URI restrictionsURI(const std::string& serviceName,
+                                    const net::IPAddress& serverAddress);
 
-    void updateRestrictions(const net::URI& remoteURI) noexcept;
+    void updateRestrictions() noexcept;
 
     std::string _serviceName;
     net::IPAddress _serverAddress;
@@ -78,12 +83,14 @@ class RemoteRestrictionManager : public RestrictionManager {
     Clock::duration _refreshInterval;
     logging::Logger& _logger;
     metrics::Metrics& _metrics;
-    KeyRestrictionMap _restrictions;
-    bool _running;
-    bool _initialized;
-    std::thread _thread;
-    std::condition_variable _cv;
+    net::http::ConditionalGet _restrictionsGet;
+    // Null until the first successful update.
+    std::shared_ptr<const KeyRestrictionMap> _restrictions;
+    utils::Poller& _poller;
     std::mutex _mutex;
+    // Registered at the end of the constructor, since the task may run
+    // before the constructor returns. Zero if not polling.
+    utils::Poller::TaskID _pollTask;
 };
 
 }  // namespace baggage
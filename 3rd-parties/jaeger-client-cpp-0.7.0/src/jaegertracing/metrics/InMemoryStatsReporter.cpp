@@ -22,6 +22,8 @@
 #include "jaegertracing/metrics/Metrics.h"
 #include "jaegertracing/metrics/Timer.h"
 
+#include <utility>
+
 namespace jaegertracing {
 namespace metrics {
 namespace {
@@ -75,11 +77,27 @@ void InMemoryStatsReporter::updateGauge(
     });
 }
 
+StatsReporter::Handle InMemoryStatsReporter::registerMetric(
+    ValueMap& map,
+    const std::string& name,
+    const TagMap& tags)
+{
+    Registration registration;
+    registration._map = &map;
+    registration._metricName = Metrics::addTagsToMetricName(name, tags);
+    registration._value = nullptr;
+    _registrations.push_back(std::move(registration));
+    return static_cast<Handle>(_registrations.size());
+}
+
 void InMemoryStatsReporter::reset()
 {
     _counters.clear();
     _gauges.clear();
     _timers.clear();
+    for (auto&& registration : _registrations) {
+        registration._value = nullptr;
+    }
 }
 
 }  // namespace metrics
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace jaegertracing {
 namespace metrics {
@@ -47,6 +48,37 @@ class InMemoryStatsReporter : public StatsReporter {
                      int64_t time,
                      const TagMap& tags) override;
 
+    Handle registerCounter(const std::string& name,
+                           const TagMap& tags) override
+    {
+        return registerMetric(_counters, name, tags);
+    }
+
+    Handle registerTimer(const std::string& name, const TagMap& tags) override
+    {
+        return registerMetric(_timers, name, tags);
+    }
+
+    Handle registerGauge(const std::string& name, const TagMap& tags) override
+    {
+        return registerMetric(_gauges, name, tags);
+    }
+
+    void incCounter(Handle handle, int64_t delta) override
+    {
+        value(handle) += delta;
+    }
+
+    void recordTimer(Handle handle, int64_t time) override
+    {
+        value(handle) += time;
+    }
+
+    void updateGauge(Handle handle, int64_t amount) override
+    {
+        value(handle) = amount;
+    }
+
     void reset();
 
     const ValueMap& counters() const { return _counters; }
@@ -56,6 +88,29 @@ class InMemoryStatsReporter : public StatsReporter {
     const ValueMap& timers() const { return _timers; }
 
   private:
+    // A registered metric caches its entry in the value map on first
+    // update, so later updates through its handle are a single indexed
+    // write. reset() drops the cached entries along with the maps.
+    struct Registration {
+        ValueMap* _map;
+        std::string _metricName;
+        int64_t* _value;
+    };
+
+    Handle
+    registerMetric(ValueMap& map, const std::string& name, const TagMap& tags);
+
+    int64_t& value(Handle handle)
+    {
+        auto& registration = _registrations[handle - 1];
+        if (!registration._value) {
+            registration._value =
+                &(*registration._map)[registration._metricName];
+        }
+        return *registration._value;
+    }
+
+    std::vector<Registration> _registrations;
     ValueMap _counters;
     ValueMap _gauges;
     ValueMap _timers;
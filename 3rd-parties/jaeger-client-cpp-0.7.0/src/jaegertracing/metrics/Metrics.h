@@ -19,6 +19,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "jaegertracing/Compilers.h"
 
@@ -27,6 +28,7 @@
 #include "jaegertracing/metrics/StatsFactory.h"
 #include "jaegertracing/metrics/StatsFactoryImpl.h"
 #include "jaegertracing/metrics/StatsReporter.h"
+#include "jaegertracing/metrics/Timer.h"
 
 namespace jaegertracing {
 namespace metrics {
@@ -35,19 +37,23 @@ class Metrics {
   public:
     static std::unique_ptr<Metrics> makeNullMetrics();
 
-    static std::unique_ptr<Metrics> fromStatsReporter(StatsReporter& reporter)
+    static std::unique_ptr<Metrics>
+    fromStatsReporter(StatsReporter& reporter, int numReporterWorkers = 1)
     {
         // Factory only used for constructor, so need not live past the
         // initialization of Metrics object.
         StatsFactoryImpl factory(reporter);
-        return std::unique_ptr<Metrics>(new Metrics(factory));
+        return std::unique_ptr<Metrics>(
+            new Metrics(factory, numReporterWorkers));
     }
 
     static std::string addTagsToMetricName(
         const std::string& name,
         const std::unordered_map<std::string, std::string>& tags);
 
-    explicit Metrics(StatsFactory& factory)
+    // Queue gauges per reporter worker are only registered when there is
+    // more than one worker.
+    explicit Metrics(StatsFactory& factory, int numReporterWorkers = 1)
         : _tracesStartedSampled(factory.createCounter(
               "jaeger.traces", { { "state", "started" }, { "sampled", "y" } }))
         , _tracesStartedNotSampled(factory.createCounter(
@@ -69,7 +75,23 @@ class Metrics {
                                                  { { "state", "failure" } }))
         , _reporterDropped(factory.createCounter("jaeger.reporter-spans",
                                                  { { "state", "dropped" } }))
+        , _reporterSpooled(factory.createCounter("jaeger.reporter-spans",
+                                                 { { "state", "spooled" } }))
         , _reporterQueueLength(factory.createGauge("jaeger.reporter-queue"))
+        , _reporterQueueBytes(
+              factory.createGauge("jaeger.reporter-queue-bytes"))
+        , _reporterDroppedBytes(factory.createCounter(
+              "jaeger.reporter-bytes", { { "state", "dropped" } }))
+        , _reporterFlushLatency(
+              factory.createTimer("jaeger.reporter-flush-latency"))
+        , _reporterBatchesFull(factory.createCounter(
+              "jaeger.reporter-batches", { { "state", "full" } }))
+        , _reporterBatchesPartial(factory.createCounter(
+              "jaeger.reporter-batches", { { "state", "partial" } }))
+        , _reporterSentBytes(factory.createCounter(
+              "jaeger.reporter-bytes", { { "state", "sent" } }))
+        , _reporterUnusedBytes(factory.createCounter(
+              "jaeger.reporter-bytes", { { "state", "unused" } }))
         , _samplerRetrieved(factory.createCounter("jaeger.sampler",
                                                   { { "state", "retrieved" } }))
         , _samplerUpdated(factory.createCounter("jaeger.sampler",
@@ -92,7 +114,15 @@ class Metrics {
               "jaeger.baggage-restrictions-update", { { "result", "ok" } }))
         , _baggageRestrictionsUpdateFailure(factory.createCounter(
               "jaeger.baggage-restrictions-update", { { "result", "err" } }))
+        , _reporterWorkerQueueLength()
     {
+        if (numReporterWorkers > 1) {
+            for (auto i = 0; i < numReporterWorkers; ++i) {
+                _reporterWorkerQueueLength.emplace_back(factory.createGauge(
+                    "jaeger.reporter-worker-queue",
+                    { { "worker", std::to_string(i) } }));
+            }
+        }
     }
 
     ~Metrics();
@@ -143,10 +173,79 @@ class Metrics {
 
     Counter& reporterDropped() { return *_reporterDropped; }
 
+    // Spans written to the spool file while the agent was unavailable. They
+    // are replayed later and not counted as successful.
+    const Counter& reporterSpooled() const { return *_reporterSpooled; }
+
+    Counter& reporterSpooled() { return *_reporterSpooled; }
+
     const Gauge& reporterQueueLength() const { return *_reporterQueueLength; }
 
     Gauge& reporterQueueLength() { return *_reporterQueueLength; }
 
+    const Gauge& reporterQueueBytes() const { return *_reporterQueueBytes; }
+
+    Gauge& reporterQueueBytes() { return *_reporterQueueBytes; }
+
+    const Counter& reporterDroppedBytes() const
+    {
+        return *_reporterDroppedBytes;
+    }
+
+    Counter& reporterDroppedBytes() { return *_reporterDroppedBytes; }
+
+    // Time spent sending a batch, in microseconds.
+    const Timer& reporterFlushLatency() const
+    {
+        return *_reporterFlushLatency;
+    }
+
+    Timer& reporterFlushLatency() { return *_reporterFlushLatency; }
+
+    // Batches sent because no further span would fit, as opposed to
+    // partial batches sent on the flush interval.
+    const Counter& reporterBatchesFull() const
+    {
+        return *_reporterBatchesFull;
+    }
+
+    Counter& reporterBatchesFull() { return *_reporterBatchesFull; }
+
+    const Counter& reporterBatchesPartial() const
+    {
+        return *_reporterBatchesPartial;
+    }
+
+    Counter& reporterBatchesPartial() { return *_reporterBatchesPartial; }
+
+    // Packing efficiency is sent / (sent + unused) bytes, where unused bytes
+    // are the difference between each batch and the max packet size.
+    const Counter& reporterSentBytes() const { return *_reporterSentBytes; }
+
+    Counter& reporterSentBytes() { return *_reporterSentBytes; }
+
+    const Counter& reporterUnusedBytes() const
+    {
+        return *_reporterUnusedBytes;
+    }
+
+    Counter& reporterUnusedBytes() { return *_reporterUnusedBytes; }
+
+    int numReporterWorkers() const
+    {
+        return _reporterWorkerQueueLength.size();
+    }
+
+    const Gauge& reporterWorkerQueueLength(int worker) const
+    {
+        return *_reporterWorkerQueueLength[worker];
+    }
+
+    Gauge& reporterWorkerQueueLength(int worker)
+    {
+        return *_reporterWorkerQueueLength[worker];
+    }
+
     const Counter& samplerRetrieved() const { return *_samplerRetrieved; }
 
     Counter& samplerRetrieved() { return *_samplerRetrieved; }
@@ -224,7 +323,15 @@ class Metrics {
     std::unique_ptr<Counter> _reporterSuccess;
     std::unique_ptr<Counter> _reporterFailure;
     std::unique_ptr<Counter> _reporterDropped;
+    std::unique_ptr<Counter> _reporterSpooled;
     std::unique_ptr<Gauge> _reporterQueueLength;
+    std::unique_ptr<Gauge> _reporterQueueBytes;
+    std::unique_ptr<Counter> _reporterDroppedBytes;
+    std::unique_ptr<Timer> _reporterFlushLatency;
+    std::unique_ptr<Counter> _reporterBatchesFull;
+    std::unique_ptr<Counter> _reporterBatchesPartial;
+    std::unique_ptr<Counter> _reporterSentBytes;
+    std::unique_ptr<Counter> _reporterUnusedBytes;
     std::unique_ptr<Counter> _samplerRetrieved;
     std::unique_ptr<Counter> _samplerUpdated;
     std::unique_ptr<Counter> _samplerUpdateFailure;
@@ -235,6 +342,7 @@ class Metrics {
     std::unique_ptr<Counter> _baggageTruncate;
     std::unique_ptr<Counter> _baggageRestrictionsUpdateSuccess;
     std::unique_ptr<Counter> _baggageRestrictionsUpdateFailure;
+    std::vector<std::unique_ptr<Gauge>> _reporterWorkerQueueLength;
 };
 
 }  // namespace metrics
@@ -107,5 +107,24 @@ TEST_F(MetricsTest, testReset)
     ASSERT_TRUE(timers.empty());
 }
 
+TEST_F(MetricsTest, testHandles)
+{
+    constexpr auto metricName = "jaeger.test-counter.state=ok";
+    StatsFactoryImpl factory(_metricsReporter);
+    auto counter =
+        factory.createCounter("jaeger.test-counter", { { "state", "ok" } });
+    ASSERT_TRUE(_metricsReporter.counters().empty());
+
+    counter->inc(2);
+    counter->inc(3);
+    _metricsReporter.incCounter(
+        "jaeger.test-counter", 1, { { "state", "ok" } });
+    ASSERT_EQ(6, _metricsReporter.counters().at(metricName));
+
+    _metricsReporter.reset();
+    counter->inc(4);
+    ASSERT_EQ(4, _metricsReporter.counters().at(metricName));
+}
+
 }  // namespace metrics
 }  // namespace jaegertracing
@@ -53,6 +53,23 @@ class NullStatsReporter : public StatsReporter {
                 const std::unordered_map<std::string, std::string>&) override
     {
     }
+
+    // Updates are ignored, so every metric can share one handle and skip
+    // passing its name and tags.
+    Handle registerCounter(const std::string&, const TagMap&) override
+    {
+        return 1;
+    }
+
+    Handle registerTimer(const std::string&, const TagMap&) override
+    {
+        return 1;
+    }
+
+    Handle registerGauge(const std::string&, const TagMap&) override
+    {
+        return 1;
+    }
 };
 
 }  // namespace metrics
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/metrics/PrometheusFormatter.h"
+
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+namespace jaegertracing {
+namespace metrics {
+namespace {
+
+using Snapshot = ShardedStatsFactory::Snapshot;
+using Histogram = ShardedStatsFactory::Histogram;
+using TagMap = StatsFactory::TagMap;
+
+bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+bool isNameChar(char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_' ||
+           ch == ':' || isDigit(ch);
+}
+
+void writeLabelValue(std::ostream& out, const std::string& value)
+{
+    for (auto&& ch : value) {
+        switch (ch) {
+        case '\\':
+            out << "\\\\";
+            break;
+        case '"':
+            out << "\\\"";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        default:
+            out << ch;
+            break;
+        }
+    }
+}
+
+// Writes {a="x",b="y"} with labels in sorted order, plus an optional extra
+// label that is always last (used for the histogram "le" label).
+void writeLabels(std::ostream& out,
+                 const TagMap& tags,
+                 const char* extraName = nullptr,
+                 const std::string& extraValue = std::string())
+{
+    if (tags.empty() && extraName == nullptr) {
+        return;
+    }
+    const std::map<std::string, std::string> orderedTags(std::begin(tags),
+                                                         std::end(tags));
+    auto separator = '{';
+    for (auto&& pair : orderedTags) {
+        out << separator << PrometheusFormatter::metricName(pair.first)
+            << "=\"";
+        writeLabelValue(out, pair.second);
+        out << '"';
+        separator = ',';
+    }
+    if (extraName != nullptr) {
+        out << separator << extraName << "=\"" << extraValue << '"';
+    }
+    out << '}';
+}
+
+// Samples of one metric must be contiguous and share a single TYPE line, so
+// group them by exposed name. Sorting the snapshot key alone is not enough,
+// for example "a-b" sorts between "a" and "a.tag=x".
+template <typename ValueMap>
+std::map<std::string, std::vector<const typename ValueMap::mapped_type*>>
+groupByName(const ValueMap& values)
+{
+    std::map<std::string, std::vector<const typename ValueMap::mapped_type*>>
+        groups;
+    for (auto&& pair : values) {
+        groups[PrometheusFormatter::metricName(pair.second._name)].push_back(
+            &pair.second);
+    }
+    return groups;
+}
+
+void writeValues(std::ostream& out,
+                 const Snapshot::ValueMap& values,
+                 const char* type)
+{
+    for (auto&& group : groupByName(values)) {
+        out << "# TYPE " << group.first << ' ' << type << '\n';
+        for (auto&& sample : group.second) {
+            out << group.first;
+            writeLabels(out, sample->_tags);
+            out << ' ' << sample->_value << '\n';
+        }
+    }
+}
+
+void writeHistograms(std::ostream& out, const Snapshot::HistogramMap& values)
+{
+    for (auto&& group : groupByName(values)) {
+        out << "# TYPE " << group.first << " histogram\n";
+        for (auto&& sample : group.second) {
+            const auto& histogram = sample->_value;
+            // Buckets past the largest recorded value would all repeat the
+            // total count, so stop there and let +Inf cover the rest.
+            auto lastBucket = ShardedStatsFactory::kNumBuckets - 1;
+            while (lastBucket > 0 && histogram._buckets[lastBucket] == 0) {
+                --lastBucket;
+            }
+            auto cumulative = static_cast<int64_t>(0);
+            for (auto i = 0; i <= lastBucket; ++i) {
+                cumulative += histogram._buckets[i];
+                out << group.first << "_bucket";
+                writeLabels(out,
+                            sample->_tags,
+                            "le",
+                            std::to_string(Histogram::bucketUpperBound(i)));
+                out << ' ' << cumulative << '\n';
+            }
+            out << group.first << "_bucket";
+            writeLabels(out, sample->_tags, "le", "+Inf");
+            out << ' ' << histogram._count << '\n';
+            out << group.first << "_sum";
+            writeLabels(out, sample->_tags);
+            out << ' ' << histogram._sum << '\n';
+            out << group.first << "_count";
+            writeLabels(out, sample->_tags);
+            out << ' ' << histogram._count << '\n';
+        }
+    }
+}
+
+}  // anonymous namespace
+
+constexpr const char* PrometheusFormatter::kContentType;
+
+std::string PrometheusFormatter::metricName(const std::string& name)
+{
+    std::string result;
+    result.reserve(name.size() + 1);
+    if (!name.empty() && isDigit(name[0])) {
+        result += '_';
+    }
+    for (auto&& ch : name) {
+        result += isNameChar(ch) ? ch : '_';
+    }
+    return result;
+}
+
+void PrometheusFormatter::write(std::ostream& out, const Snapshot& snapshot)
+{
+    writeValues(out, snapshot._counters, "counter");
+    writeValues(out, snapshot._gauges, "gauge");
+    writeHistograms(out, snapshot._timers);
+}
+
+std::string PrometheusFormatter::format(const Snapshot& snapshot)
+{
+    std::ostringstream oss;
+    write(oss, snapshot);
+    return oss.str();
+}
+
+}  // namespace metrics
+}  // namespace jaegertracing
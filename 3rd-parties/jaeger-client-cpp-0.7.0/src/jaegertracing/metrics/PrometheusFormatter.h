@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_METRICS_PROMETHEUSFORMATTER_H
+#define JAEGERTRACING_METRICS_PROMETHEUSFORMATTER_H
+
+#include <iosfwd>
+#include <string>
+
+#include "jaegertracing/metrics/ShardedStatsFactory.h"
+
+namespace jaegertracing {
+namespace metrics {
+
+// Renders a ShardedStatsFactory snapshot in the Prometheus text exposition
+// format, so a scrape endpoint or periodic file dump can publish tracer
+// metrics without a push pipeline. Metric names have characters outside
+// [a-zA-Z0-9_:] replaced with '_' (jaeger.reporter-spans becomes
+// jaeger_reporter_spans) and tags become labels. Timers are exposed as
+// histograms with power-of-two buckets.
+class PrometheusFormatter {
+  public:
+    static constexpr auto kContentType = "text/plain; version=0.0.4";
+
+    static std::string metricName(const std::string& name);
+
+    static void write(std::ostream& out,
+                      const ShardedStatsFactory::Snapshot& snapshot);
+
+    static std::string format(const ShardedStatsFactory::Snapshot& snapshot);
+};
+
+}  // namespace metrics
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_METRICS_PROMETHEUSFORMATTER_H
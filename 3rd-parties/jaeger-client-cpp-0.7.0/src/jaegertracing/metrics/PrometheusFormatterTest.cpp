@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/metrics/Counter.h"
+#include "jaegertracing/metrics/Gauge.h"
+#include "jaegertracing/metrics/PrometheusFormatter.h"
+#include "jaegertracing/metrics/ShardedStatsFactory.h"
+#include "jaegertracing/metrics/Timer.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace jaegertracing {
+namespace metrics {
+
+TEST(PrometheusFormatter, testMetricName)
+{
+    ASSERT_EQ("jaeger_reporter_spans",
+              PrometheusFormatter::metricName("jaeger.reporter-spans"));
+    ASSERT_EQ("_9lives", PrometheusFormatter::metricName("9lives"));
+}
+
+TEST(PrometheusFormatter, testFormat)
+{
+    ShardedStatsFactory factory;
+    factory.createCounter("jaeger.reporter-spans", { { "state", "dropped" } })
+        ->inc(2);
+    factory.createCounter("jaeger.reporter-spans", { { "state", "success" } })
+        ->inc(5);
+    factory.createCounter("jaeger.reporter-spans-extra")->inc(1);
+    factory.createGauge("jaeger.reporter-queue", { { "q", "a\"b" } })
+        ->update(3);
+    auto timer = factory.createTimer("jaeger.reporter-flush-latency");
+    timer->record(1);
+    timer->record(3);
+    timer->record(3);
+
+    ASSERT_EQ("# TYPE jaeger_reporter_spans counter\n"
+              "jaeger_reporter_spans{state=\"dropped\"} 2\n"
+              "jaeger_reporter_spans{state=\"success\"} 5\n"
+              "# TYPE jaeger_reporter_spans_extra counter\n"
+              "jaeger_reporter_spans_extra 1\n"
+              "# TYPE jaeger_reporter_queue gauge\n"
+              "jaeger_reporter_queue{q=\"a\\\"b\"} 3\n"
+              "# TYPE jaeger_reporter_flush_latency histogram\n"
+              "jaeger_reporter_flush_latency_bucket{le=\"0\"} 0\n"
+              "jaeger_reporter_flush_latency_bucket{le=\"1\"} 1\n"
+              "jaeger_reporter_flush_latency_bucket{le=\"3\"} 3\n"
+              "jaeger_reporter_flush_latency_bucket{le=\"+Inf\"} 3\n"
+              "jaeger_reporter_flush_latency_sum 7\n"
+              "jaeger_reporter_flush_latency_count 3\n",
+              PrometheusFormatter::format(factory.snapshot()));
+}
+
+}  // namespace metrics
+}  // namespace jaegertracing
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/metrics/ShardedStatsFactory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "jaegertracing/metrics/Counter.h"
+#include "jaegertracing/metrics/Gauge.h"
+#include "jaegertracing/metrics/Metrics.h"
+#include "jaegertracing/metrics/Timer.h"
+
+namespace jaegertracing {
+namespace metrics {
+namespace {
+
+constexpr size_t kCacheLineSize = 64;
+
+using AtomicValue = std::atomic<int64_t>;
+
+// Alone on its cache line, so updates from other shards never contend.
+struct alignas(kCacheLineSize) PaddedValue {
+    AtomicValue _value;
+};
+
+static_assert(sizeof(PaddedValue) == kCacheLineSize,
+              "PaddedValue must fill one cache line");
+
+// operator new only guarantees alignof(std::max_align_t) before C++17, so
+// states holding cache-line aligned shards allocate their own storage.
+// The pointer returned by malloc is kept just before the aligned block.
+class CacheLineAligned {
+  public:
+    static void* operator new(size_t size)
+    {
+        auto* block = std::malloc(size + kCacheLineSize + sizeof(void*));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        const auto address =
+            reinterpret_cast<uintptr_t>(block) + sizeof(void*);
+        auto* aligned = reinterpret_cast<void*>(
+            (address + kCacheLineSize - 1) & ~(kCacheLineSize - 1));
+        static_cast<void**>(aligned)[-1] = block;
+        return aligned;
+    }
+
+    static void operator delete(void* ptr)
+    {
+        if (ptr) {
+            std::free(static_cast<void**>(ptr)[-1]);
+        }
+    }
+};
+
+// Threads are assigned shards round robin the first time they update a
+// metric, which spreads a small thread pool evenly across the shards.
+int shardIndex()
+{
+    static std::atomic<unsigned> nextShard(0);
+    static thread_local const int shard =
+        static_cast<int>(nextShard.fetch_add(1, std::memory_order_relaxed) %
+                         ShardedStatsFactory::kNumShards);
+    return shard;
+}
+
+}  // anonymous namespace
+
+constexpr int ShardedStatsFactory::kNumShards;
+constexpr int ShardedStatsFactory::kNumBuckets;
+
+int ShardedStatsFactory::Histogram::bucketIndex(int64_t value)
+{
+    if (value <= 0) {
+        return 0;
+    }
+    auto index = 0;
+    for (auto bits = static_cast<uint64_t>(value); bits != 0; bits >>= 1) {
+        ++index;
+    }
+    return index;
+}
+
+int64_t ShardedStatsFactory::Histogram::bucketUpperBound(int index)
+{
+    return static_cast<int64_t>((static_cast<uint64_t>(1) << index) - 1);
+}
+
+class ShardedStatsFactory::CounterState : public CacheLineAligned {
+  public:
+    CounterState()
+        : _shards()
+    {
+    }
+
+    void inc(int64_t delta)
+    {
+        _shards[shardIndex()]._value.fetch_add(delta,
+                                               std::memory_order_relaxed);
+    }
+
+    int64_t value() const
+    {
+        auto total = static_cast<int64_t>(0);
+        for (auto&& shard : _shards) {
+            total += shard._value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+  private:
+    std::array<PaddedValue, kNumShards> _shards;
+};
+
+// A gauge holds the last value written, which cannot be merged across
+// shards, so it is a single atomic updated with a relaxed store.
+class ShardedStatsFactory::GaugeState {
+  public:
+    GaugeState()
+        : _value(0)
+    {
+    }
+
+    void update(int64_t amount)
+    {
+        _value.store(amount, std::memory_order_relaxed);
+    }
+
+    int64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+  private:
+    AtomicValue _value;
+};
+
+class ShardedStatsFactory::TimerState : public CacheLineAligned {
+  public:
+    TimerState()
+        : _shards()
+    {
+    }
+
+    void record(int64_t time)
+    {
+        auto& shard = _shards[shardIndex()];
+        shard._count.fetch_add(1, std::memory_order_relaxed);
+        shard._sum.fetch_add(time, std::memory_order_relaxed);
+        shard._buckets[Histogram::bucketIndex(time)].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+
+    Histogram value() const
+    {
+        Histogram histogram;
+        for (auto&& shard : _shards) {
+            histogram._count += shard._count.load(std::memory_order_relaxed);
+            histogram._sum += shard._sum.load(std::memory_order_relaxed);
+            for (auto i = 0; i < kNumBuckets; ++i) {
+                histogram._buckets[i] +=
+                    shard._buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        return histogram;
+    }
+
+  private:
+    struct alignas(kCacheLineSize) Shard {
+        AtomicValue _count;
+        AtomicValue _sum;
+        std::array<AtomicValue, kNumBuckets> _buckets;
+    };
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+namespace {
+
+// The metric handles own a reference to their state so the factory and the
+// handles may be destroyed in any order.
+template <typename State>
+class CounterImpl : public Counter {
+  public:
+    explicit CounterImpl(const std::shared_ptr<State>& state)
+        : _state(state)
+    {
+    }
+
+    void inc(int64_t delta) override { _state->inc(delta); }
+
+  private:
+    std::shared_ptr<State> _state;
+};
+
+template <typename State>
+class GaugeImpl : public Gauge {
+  public:
+    explicit GaugeImpl(const std::shared_ptr<State>& state)
+        : _state(state)
+    {
+    }
+
+    void update(int64_t amount) override { _state->update(amount); }
+
+  private:
+    std::shared_ptr<State> _state;
+};
+
+template <typename State>
+class TimerImpl : public Timer {
+  public:
+    explicit TimerImpl(const std::shared_ptr<State>& state)
+        : _state(state)
+    {
+    }
+
+    void record(int64_t time) override { _state->record(time); }
+
+  private:
+    std::shared_ptr<State> _state;
+};
+
+template <typename ValueMap, typename Registry>
+void collect(ValueMap& values, const Registry& registry)
+{
+    for (auto&& pair : registry) {
+        auto& sample = values[pair.first];
+        sample._name = pair.second._name;
+        sample._tags = pair.second._tags;
+        sample._value = pair.second._state->value();
+    }
+}
+
+}  // anonymous namespace
+
+ShardedStatsFactory::ShardedStatsFactory()
+    : _mutex()
+    , _counters()
+    , _gauges()
+    , _timers()
+{
+}
+
+ShardedStatsFactory::~ShardedStatsFactory() = default;
+
+template <typename State>
+std::shared_ptr<State>
+ShardedStatsFactory::findOrCreate(Registry<State>& registry,
+                                  const std::string& name,
+                                  const TagMap& tags)
+{
+    auto& entry = registry[Metrics::addTagsToMetricName(name, tags)];
+    if (!entry._state) {
+        entry._name = name;
+        entry._tags = tags;
+        // Not make_shared, which ignores the states' cache line alignment.
+        entry._state = std::shared_ptr<State>(new State());
+    }
+    return entry._state;
+}
+
+std::unique_ptr<Counter>
+ShardedStatsFactory::createCounter(const std::string& name, const TagMap& tags)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::unique_ptr<Counter>(
+        new CounterImpl<CounterState>(findOrCreate(_counters, name, tags)));
+}
+
+std::unique_ptr<Timer>
+ShardedStatsFactory::createTimer(const std::string& name, const TagMap& tags)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::unique_ptr<Timer>(
+        new TimerImpl<TimerState>(findOrCreate(_timers, name, tags)));
+}
+
+std::unique_ptr<Gauge>
+ShardedStatsFactory::createGauge(const std::string& name, const TagMap& tags)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::unique_ptr<Gauge>(
+        new GaugeImpl<GaugeState>(findOrCreate(_gauges, name, tags)));
+}
+
+ShardedStatsFactory::Snapshot ShardedStatsFactory::snapshot() const
+{
+    Snapshot snapshot;
+    std::lock_guard<std::mutex> lock(_mutex);
+    collect(snapshot._counters, _counters);
+    collect(snapshot._gauges, _gauges);
+    collect(snapshot._timers, _timers);
+    return snapshot;
+}
+
+}  // namespace metrics
+}  // namespace jaegertracing
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_METRICS_SHARDEDSTATSFACTORY_H
+#define JAEGERTRACING_METRICS_SHARDEDSTATSFACTORY_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "jaegertracing/metrics/StatsFactory.h"
+
+namespace jaegertracing {
+namespace metrics {
+
+class Counter;
+class Gauge;
+class Timer;
+
+// Stats factory that keeps metric values in process instead of forwarding
+// every update to a StatsReporter. Counters and timers are split across
+// cache-line padded shards, one per group of threads, so updates are a
+// single relaxed atomic add with no lock and no map lookup. Shards are only
+// summed when snapshot() is called. Metrics created with the same name and
+// tags share their storage.
+class ShardedStatsFactory : public StatsFactory {
+  public:
+    static constexpr auto kNumShards = 16;
+
+    // Bucket i of a histogram counts values whose bit width is i, that is
+    // values in [2^(i-1), 2^i). Bucket 0 counts values <= 0.
+    static constexpr auto kNumBuckets = 64;
+
+    struct Histogram {
+        static int bucketIndex(int64_t value);
+
+        // Inclusive upper bound of bucket index, 2^index - 1.
+        static int64_t bucketUpperBound(int index);
+
+        Histogram()
+            : _count(0)
+            , _sum(0)
+            , _buckets()
+        {
+        }
+
+        int64_t _count;
+        int64_t _sum;
+        std::array<int64_t, kNumBuckets> _buckets;
+    };
+
+    template <typename ValueType>
+    struct Sample {
+        Sample()
+            : _name()
+            , _tags()
+            , _value()
+        {
+        }
+
+        std::string _name;
+        TagMap _tags;
+        ValueType _value;
+    };
+
+    // Aggregated values keyed by Metrics::addTagsToMetricName(name, tags).
+    struct Snapshot {
+        using ValueMap = std::map<std::string, Sample<int64_t>>;
+        using HistogramMap = std::map<std::string, Sample<Histogram>>;
+
+        ValueMap _counters;
+        ValueMap _gauges;
+        HistogramMap _timers;
+    };
+
+    using StatsFactory::createCounter;
+    using StatsFactory::createGauge;
+    using StatsFactory::createTimer;
+
+    ShardedStatsFactory();
+
+    ~ShardedStatsFactory();
+
+    std::unique_ptr<Counter> createCounter(const std::string& name,
+                                           const TagMap& tags) override;
+
+    std::unique_ptr<Timer> createTimer(const std::string& name,
+                                       const TagMap& tags) override;
+
+    std::unique_ptr<Gauge> createGauge(const std::string& name,
+                                       const TagMap& tags) override;
+
+    // Safe to call from any thread while metrics are being updated. Only
+    // contends with metric creation, never with updates.
+    Snapshot snapshot() const;
+
+  private:
+    class CounterState;
+    class GaugeState;
+    class TimerState;
+
+    template <typename State>
+    struct Entry {
+        std::string _name;
+        TagMap _tags;
+        std::shared_ptr<State> _state;
+    };
+
+    template <typename State>
+    using Registry = std::map<std::string, Entry<State>>;
+
+    template <typename State>
+    static std::shared_ptr<State> findOrCreate(Registry<State>& registry,
+                                               const std::string& name,
+                                               const TagMap& tags);
+
+    mutable std::mutex _mutex;
+    Registry<CounterState> _counters;
+    Registry<GaugeState> _gauges;
+    Registry<TimerState> _timers;
+};
+
+}  // namespace metrics
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_METRICS_SHARDEDSTATSFACTORY_H
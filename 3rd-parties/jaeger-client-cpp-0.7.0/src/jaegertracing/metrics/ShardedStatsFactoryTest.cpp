@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/metrics/Counter.h"
+#include "jaegertracing/metrics/Gauge.h"
+#include "jaegertracing/metrics/Metrics.h"
+#include "jaegertracing/metrics/ShardedStatsFactory.h"
+#include "jaegertracing/metrics/Timer.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace jaegertracing {
+namespace metrics {
+
+TEST(ShardedStatsFactory, testCounter)
+{
+    constexpr auto numThreads = 8;
+    constexpr auto numIncrements = 10000;
+    ShardedStatsFactory factory;
+    auto counter = factory.createCounter("jaeger.test-counter");
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&counter]() {
+            for (auto j = 0; j < numIncrements; ++j) {
+                counter->inc(1);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    const auto snapshot = factory.snapshot();
+    ASSERT_EQ(1, static_cast<int>(snapshot._counters.size()));
+    const auto itr = snapshot._counters.find("jaeger.test-counter");
+    ASSERT_TRUE(itr != std::end(snapshot._counters));
+    ASSERT_EQ(numThreads * numIncrements, itr->second._value);
+}
+
+TEST(ShardedStatsFactory, testSharedState)
+{
+    ShardedStatsFactory factory;
+    auto first = factory.createCounter("jaeger.spans", { { "state", "a" } });
+    auto second = factory.createCounter("jaeger.spans", { { "state", "a" } });
+    auto other = factory.createCounter("jaeger.spans", { { "state", "b" } });
+    first->inc(1);
+    second->inc(2);
+    other->inc(5);
+    first.reset();
+    const auto snapshot = factory.snapshot();
+    ASSERT_EQ(2, static_cast<int>(snapshot._counters.size()));
+    const auto& sample = snapshot._counters.at("jaeger.spans.state=a");
+    ASSERT_EQ(3, sample._value);
+    ASSERT_EQ("jaeger.spans", sample._name);
+    ASSERT_EQ("a", sample._tags.at("state"));
+    ASSERT_EQ(5, snapshot._counters.at("jaeger.spans.state=b")._value);
+}
+
+TEST(ShardedStatsFactory, testGauge)
+{
+    ShardedStatsFactory factory;
+    auto gauge = factory.createGauge("jaeger.test-gauge");
+    gauge->update(7);
+    gauge->update(3);
+    ASSERT_EQ(3, factory.snapshot()._gauges.at("jaeger.test-gauge")._value);
+}
+
+TEST(ShardedStatsFactory, testTimer)
+{
+    using Histogram = ShardedStatsFactory::Histogram;
+    ASSERT_EQ(0, Histogram::bucketIndex(-1));
+    ASSERT_EQ(0, Histogram::bucketIndex(0));
+    ASSERT_EQ(1, Histogram::bucketIndex(1));
+    ASSERT_EQ(3, Histogram::bucketIndex(4));
+    ASSERT_EQ(3, Histogram::bucketIndex(7));
+    ASSERT_EQ(63, Histogram::bucketIndex(INT64_MAX));
+    ASSERT_EQ(7, Histogram::bucketUpperBound(3));
+    ASSERT_EQ(INT64_MAX, Histogram::bucketUpperBound(63));
+
+    ShardedStatsFactory factory;
+    auto timer = factory.createTimer("jaeger.test-timer");
+    timer->record(1);
+    timer->record(5);
+    timer->record(6);
+    const auto histogram =
+        factory.snapshot()._timers.at("jaeger.test-timer")._value;
+    ASSERT_EQ(3, histogram._count);
+    ASSERT_EQ(12, histogram._sum);
+    ASSERT_EQ(1, histogram._buckets[1]);
+    ASSERT_EQ(2, histogram._buckets[3]);
+}
+
+TEST(ShardedStatsFactory, testMetrics)
+{
+    ShardedStatsFactory factory;
+    Metrics metrics(factory);
+    metrics.reporterDropped().inc(2);
+    metrics.tracesStartedSampled().inc(1);
+    metrics.reporterQueueLength().update(4);
+    const auto snapshot = factory.snapshot();
+    ASSERT_EQ(
+        2, snapshot._counters.at("jaeger.reporter-spans.state=dropped")._value);
+    ASSERT_EQ(1,
+              snapshot._counters.at("jaeger.traces.sampled=y.state=started")
+                  ._value);
+    ASSERT_EQ(4, snapshot._gauges.at("jaeger.reporter-queue")._value);
+}
+
+}  // namespace metrics
+}  // namespace jaegertracing
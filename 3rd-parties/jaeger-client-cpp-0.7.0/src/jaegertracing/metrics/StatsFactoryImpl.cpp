@@ -17,7 +17,6 @@
 #include "jaegertracing/metrics/StatsFactoryImpl.h"
 #include "jaegertracing/metrics/Counter.h"
 #include "jaegertracing/metrics/Gauge.h"
-#include "jaegertracing/metrics/Metric.h"
 #include "jaegertracing/metrics/StatsReporter.h"
 #include "jaegertracing/metrics/Timer.h"
 #include <cstdint>
@@ -26,14 +25,26 @@ namespace jaegertracing {
 namespace metrics {
 namespace {
 
-class ReportedMetric : public Metric {
+// Holds the reporter handle resolved when the metric is created. The name
+// and tags are only kept for reporters that do not hand out handles.
+class ReportedMetric {
   public:
+    using Handle = StatsReporter::Handle;
+    using TagMap = StatsReporter::TagMap;
+
     ReportedMetric(StatsReporter& reporter,
+                   Handle handle,
                    const std::string& name,
                    const TagMap& tags)
-        : Metric(name, tags)
-        , _reporter(reporter)
+        : _reporter(reporter)
+        , _handle(handle)
+        , _name()
+        , _tags()
     {
+        if (_handle == StatsReporter::kNoHandle) {
+            _name = name;
+            _tags = tags;
+        }
     }
 
     virtual ~ReportedMetric() = default;
@@ -41,8 +52,17 @@ class ReportedMetric : public Metric {
   protected:
     StatsReporter& reporter() { return _reporter; }
 
+    Handle handle() const { return _handle; }
+
+    const std::string& name() const { return _name; }
+
+    const TagMap& tags() const { return _tags; }
+
   private:
     StatsReporter& _reporter;
+    Handle _handle;
+    std::string _name;
+    TagMap _tags;
 };
 
 class CounterImpl : public ReportedMetric, public Counter {
@@ -50,12 +70,17 @@ class CounterImpl : public ReportedMetric, public Counter {
     CounterImpl(StatsReporter& reporter,
                 const std::string& name,
                 const std::unordered_map<std::string, std::string>& tags)
-        : ReportedMetric(reporter, name, tags)
+        : ReportedMetric(
+              reporter, reporter.registerCounter(name, tags), name, tags)
     {
     }
 
     void inc(int64_t delta) override
     {
+        if (handle() != StatsReporter::kNoHandle) {
+            reporter().incCounter(handle(), delta);
+            return;
+        }
         reporter().incCounter(name(), delta, tags());
     }
 };
@@ -65,12 +90,17 @@ class TimerImpl : public ReportedMetric, public Timer {
     TimerImpl(StatsReporter& reporter,
               const std::string& name,
               const std::unordered_map<std::string, std::string>& tags)
-        : ReportedMetric(reporter, name, tags)
+        : ReportedMetric(
+              reporter, reporter.registerTimer(name, tags), name, tags)
     {
     }
 
     void record(int64_t time) override
     {
+        if (handle() != StatsReporter::kNoHandle) {
+            reporter().recordTimer(handle(), time);
+            return;
+        }
         reporter().recordTimer(name(), time, tags());
     }
 };
@@ -80,12 +110,17 @@ class GaugeImpl : public ReportedMetric, public Gauge {
     GaugeImpl(StatsReporter& reporter,
               const std::string& name,
               const std::unordered_map<std::string, std::string>& tags)
-        : ReportedMetric(reporter, name, tags)
+        : ReportedMetric(
+              reporter, reporter.registerGauge(name, tags), name, tags)
     {
     }
 
     void update(int64_t amount) override
     {
+        if (handle() != StatsReporter::kNoHandle) {
+            reporter().updateGauge(handle(), amount);
+            return;
+        }
         reporter().updateGauge(name(), amount, tags());
     }
 };
@@ -15,3 +15,11 @@
  */
 
 #include "jaegertracing/metrics/StatsReporter.h"
+
+namespace jaegertracing {
+namespace metrics {
+
+constexpr StatsReporter::Handle StatsReporter::kNoHandle;
+
+}  // namespace metrics
+}  // namespace jaegertracing
@@ -28,6 +28,12 @@ class StatsReporter {
   public:
     using TagMap = std::unordered_map<std::string, std::string>;
 
+    // Identifies a metric registered with a reporter, so updates need not
+    // pass its name and tags again.
+    using Handle = uint32_t;
+
+    static constexpr Handle kNoHandle = 0;
+
     virtual ~StatsReporter() = default;
 
     void incCounter(const std::string& name, int64_t delta)
@@ -54,6 +60,32 @@ class StatsReporter {
     virtual void updateGauge(const std::string& name,
                              int64_t amount,
                              const TagMap& tags) = 0;
+
+    // Metrics created by StatsFactoryImpl are registered once. A reporter
+    // that returns a handle is then updated through the handle overloads
+    // below, which should index the metric directly. The default returns
+    // `kNoHandle` and keeps the name-based calls.
+    virtual Handle registerCounter(const std::string&, const TagMap&)
+    {
+        return kNoHandle;
+    }
+
+    virtual Handle registerTimer(const std::string&, const TagMap&)
+    {
+        return kNoHandle;
+    }
+
+    virtual Handle registerGauge(const std::string&, const TagMap&)
+    {
+        return kNoHandle;
+    }
+
+    // Only called with handles this reporter returned.
+    virtual void incCounter(Handle, int64_t) {}
+
+    virtual void recordTimer(Handle, int64_t) {}
+
+    virtual void updateGauge(Handle, int64_t) {}
 };
 
 }  // namespace metrics
@@ -19,6 +19,7 @@
 
 #include "jaegertracing/net/IPAddress.h"
 #include "jaegertracing/net/URI.h"
+#include <chrono>
 #include <errno.h>
 #include <memory>
 #include <ostream>
@@ -161,6 +162,30 @@ class Socket {
         throw std::runtime_error(oss.str());
     }
 
+    // Bounds each send and receive, and on most platforms connect(), to
+    // `timeout` instead of waiting for the peer indefinitely. Calls that
+    // time out fail with EAGAIN or EWOULDBLOCK.
+    void setTimeout(const std::chrono::milliseconds& timeout)
+    {
+#ifdef WIN32
+        const DWORD value = static_cast<DWORD>(timeout.count());
+#else
+        ::timeval value;
+        value.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        value.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+#endif
+        const auto* option = reinterpret_cast<const char*>(&value);
+        for (const auto name : { SO_RCVTIMEO, SO_SNDTIMEO }) {
+            const auto returnCode =
+                ::setsockopt(_handle, SOL_SOCKET, name, option, sizeof(value));
+            if (returnCode != 0) {
+                throw std::system_error(errno,
+                                        std::system_category(),
+                                        "Failed to set socket timeout");
+            }
+        }
+    }
+
     static constexpr auto kDefaultBacklog = 128;
 
     void listen(int backlog = kDefaultBacklog)
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/net/http/ConditionalGet.h"
+
+#include <functional>
+#include <vector>
+
+namespace jaegertracing {
+namespace net {
+namespace http {
+namespace {
+
+constexpr auto kStatusOK = 200;
+constexpr auto kStatusNotModified = 304;
+
+}  // anonymous namespace
+
+bool ConditionalGet::get(Response& response) const
+{
+    std::vector<Header> headers;
+    if (_hasCommitted && !_etag.empty()) {
+        headers.emplace_back("If-None-Match", _etag);
+    }
+    response = http::get(_uri, headers, _timeout);
+    if (response.statusCode() == kStatusNotModified) {
+        return false;
+    }
+    if (response.statusCode() != kStatusOK || !_hasCommitted) {
+        return true;
+    }
+    const auto etag = response.header("ETag");
+    if (!etag.empty() && etag == _etag) {
+        return false;
+    }
+    return hash(response.body()) != _bodyHash;
+}
+
+void ConditionalGet::commit(const Response& response)
+{
+    _etag = response.header("ETag");
+    _bodyHash = hash(response.body());
+    _hasCommitted = true;
+}
+
+size_t ConditionalGet::hash(const std::string& body)
+{
+    return std::hash<std::string>()(body);
+}
+
+}  // namespace http
+}  // namespace net
+}  // namespace jaegertracing
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_NET_HTTP_CONDITIONALGET_H
+#define JAEGERTRACING_NET_HTTP_CONDITIONALGET_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "jaegertracing/net/URI.h"
+#include "jaegertracing/net/http/Response.h"
+
+namespace jaegertracing {
+namespace net {
+namespace http {
+
+// Repeatedly fetches one resource and tells whether it changed since the
+// response last passed to commit(). The server's ETag is sent back in
+// If-None-Match, and servers without ETags are handled by comparing a hash
+// of the body. Requests are bounded by a timeout, since they run on the
+// poller thread shared by every tracer.
+class ConditionalGet {
+  public:
+    static std::chrono::milliseconds defaultTimeout()
+    {
+        return std::chrono::seconds(5);
+    }
+
+    explicit ConditionalGet(
+        const URI& uri,
+        const std::chrono::milliseconds& timeout = defaultTimeout())
+        : _uri(uri)
+        , _timeout(timeout)
+        , _etag()
+        , _bodyHash(0)
+        , _hasCommitted(false)
+    {
+    }
+
+    const URI& uri() const { return _uri; }
+
+    // Returns false if the resource is unchanged, in which case `response`
+    // need not be parsed. Any other status, including errors, returns true.
+    bool get(Response& response) const;
+
+    // Records `response` as applied, so identical responses are reported as
+    // unchanged from now on. Only commit responses that were used
+    // successfully, otherwise a bad response would never be retried.
+    void commit(const Response& response);
+
+  private:
+    static size_t hash(const std::string& body);
+
+    URI _uri;
+    std::chrono::milliseconds _timeout;
+    std::string _etag;
+    size_t _bodyHash;
+    bool _hasCommitted;
+};
+
+}  // namespace http
+}  // namespace net
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_NET_HTTP_CONDITIONALGET_H
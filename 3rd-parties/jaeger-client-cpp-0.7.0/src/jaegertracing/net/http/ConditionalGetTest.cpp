@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/net/http/ConditionalGet.h"
+#include "jaegertracing/net/IPAddress.h"
+#include "jaegertracing/net/Socket.h"
+#include <array>
+#include <chrono>
+#include <future>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace jaegertracing {
+namespace net {
+namespace http {
+
+TEST(ConditionalGet, testUnchangedResponses)
+{
+    Socket socket;
+    socket.open(AF_INET, SOCK_STREAM);
+    socket.bind(IPAddress::v4("127.0.0.1", 0));
+    socket.listen();
+    ::sockaddr_storage addrStorage;
+    ::socklen_t addrLen = sizeof(addrStorage);
+    ASSERT_EQ(0,
+              ::getsockname(socket.handle(),
+                            reinterpret_cast<::sockaddr*>(&addrStorage),
+                            &addrLen));
+    const IPAddress serverAddress(addrStorage, addrLen);
+
+    const std::vector<std::string> responses = {
+        "HTTP/1.1 200 OK\r\nETag: \"v1\"\r\nContent-Length: 7\r\n\r\n"
+        "{\"a\":1}",
+        "HTTP/1.1 304 Not Modified\r\nContent-Length: 0\r\n\r\n",
+        "HTTP/1.1 200 OK\r\nContent-Length: 7\r\n\r\n{\"a\":1}",
+        "HTTP/1.1 200 OK\r\nContent-Length: 7\r\n\r\n{\"a\":2}"
+    };
+    std::vector<std::string> requests;
+    std::thread serverThread([&socket, &responses, &requests]() {
+        for (auto&& response : responses) {
+            auto clientSocket = socket.accept();
+            std::array<char, 1024> buffer;
+            const auto numRead =
+                ::recv(clientSocket.handle(), &buffer[0], buffer.size(), 0);
+            requests.emplace_back(&buffer[0], numRead > 0 ? numRead : 0);
+            ::send(clientSocket.handle(),
+                   response.c_str(),
+                   response.size(),
+                   0);
+        }
+    });
+
+    ConditionalGet conditionalGet(
+        URI::parse("http://" + serverAddress.authority() + "/strategy"));
+    Response response;
+    ASSERT_TRUE(conditionalGet.get(response));
+    ASSERT_EQ("\"v1\"", response.header("etag"));
+    conditionalGet.commit(response);
+
+    // Not modified according to the server.
+    ASSERT_FALSE(conditionalGet.get(response));
+    // Same body, without an ETag.
+    ASSERT_FALSE(conditionalGet.get(response));
+    ASSERT_TRUE(conditionalGet.get(response));
+    ASSERT_EQ("{\"a\":2}", response.body());
+    serverThread.join();
+
+    ASSERT_EQ(std::string::npos, requests[0].find("If-None-Match"));
+    ASSERT_NE(std::string::npos, requests[1].find("If-None-Match: \"v1\""));
+}
+
+TEST(ConditionalGet, testTimeout)
+{
+    Socket socket;
+    socket.open(AF_INET, SOCK_STREAM);
+    socket.bind(IPAddress::v4("127.0.0.1", 0));
+    socket.listen();
+    ::sockaddr_storage addrStorage;
+    ::socklen_t addrLen = sizeof(addrStorage);
+    ASSERT_EQ(0,
+              ::getsockname(socket.handle(),
+                            reinterpret_cast<::sockaddr*>(&addrStorage),
+                            &addrLen));
+    const IPAddress serverAddress(addrStorage, addrLen);
+
+    // The server accepts the request but never answers.
+    std::promise<void> done;
+    std::thread serverThread([&socket, &done]() {
+        auto clientSocket = socket.accept();
+        done.get_future().wait();
+    });
+
+    ConditionalGet conditionalGet(
+        URI::parse("http://" + serverAddress.authority() + "/strategy"),
+        std::chrono::milliseconds(50));
+    Response response;
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_THROW(conditionalGet.get(response), std::exception);
+    ASSERT_GT(std::chrono::seconds(5),
+              std::chrono::steady_clock::now() - start);
+    done.set_value();
+    serverThread.join();
+}
+
+}  // namespace http
+}  // namespace net
+}  // namespace jaegertracing
@@ -17,6 +17,8 @@
 #include "jaegertracing/net/http/Response.h"
 #include "jaegertracing/net/http/SocketReader.h"
 
+#include <algorithm>
+#include <cctype>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -55,6 +57,24 @@ Response Response::parse(std::istream& in)
     return response;
 }
 
+std::string Response::header(const std::string& key) const
+{
+    const auto equalsIgnoreCase = [](char lhs, char rhs) {
+        return std::tolower(static_cast<unsigned char>(lhs)) ==
+               std::tolower(static_cast<unsigned char>(rhs));
+    };
+    for (auto&& header : _headers) {
+        if (header.key().size() == key.size() &&
+            std::equal(std::begin(key),
+                       std::end(key),
+                       std::begin(header.key()),
+                       equalsIgnoreCase)) {
+            return header.value();
+        }
+    }
+    return std::string();
+}
+
 Response read(Socket & socket)
 {
   std::string response = SocketReader::read(socket);
@@ -63,16 +83,35 @@ Response read(Socket & socket)
 }
 
 Response get(const URI& uri)
+{
+    return get(uri, std::vector<Header>());
+}
+
+Response get(const URI& uri, const std::vector<Header>& headers)
+{
+    return get(uri, headers, std::chrono::milliseconds::zero());
+}
+
+Response get(const URI& uri,
+             const std::vector<Header>& headers,
+             const std::chrono::milliseconds& timeout)
 {
     Socket socket;
     socket.open(AF_INET, SOCK_STREAM);
+    if (timeout > std::chrono::milliseconds::zero()) {
+        socket.setTimeout(timeout);
+    }
     socket.connect(uri);
     std::ostringstream requestStream;
     requestStream << "GET " << uri.target() << " HTTP/1.1\r\n"
                   << "Host: " << uri.authority()
                   << "\r\n"
                      "User-Agent: jaegertracing/"
-                  << kJaegerClientVersion << "\r\n\r\n";
+                  << kJaegerClientVersion << "\r\n";
+    for (auto&& header : headers) {
+        requestStream << header.key() << ": " << header.value() << "\r\n";
+    }
+    requestStream << "\r\n";
     const auto request = requestStream.str();
 #ifdef WIN32
     const auto numWritten = ::send(socket.handle(), request.c_str(), request.size(), 0);
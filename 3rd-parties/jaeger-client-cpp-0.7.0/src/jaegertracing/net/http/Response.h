@@ -17,6 +17,8 @@
 #ifndef JAEGERTRACING_NET_HTTP_RESPONSE_H
 #define JAEGERTRACING_NET_HTTP_RESPONSE_H
 
+#include <chrono>
+
 #include "jaegertracing/net/URI.h"
 #include "jaegertracing/net/Socket.h"
 #include "jaegertracing/net/http/Error.h"
@@ -46,6 +48,10 @@ class Response {
 
     const std::vector<Header>& headers() const { return _headers; }
 
+    // Value of the first header named `key`, ignoring case, or an empty
+    // string.
+    std::string header(const std::string& key) const;
+
     const std::string& body() const { return _body; }
 
   private:
@@ -58,6 +64,15 @@ class Response {
 
 Response get(const URI& uri);
 
+// Sends `headers` along with the usual Host and User-Agent.
+Response get(const URI& uri, const std::vector<Header>& headers);
+
+// Like get(uri, headers), but gives up on a connect, send or receive that
+// takes longer than `timeout`.
+Response get(const URI& uri,
+             const std::vector<Header>& headers,
+             const std::chrono::milliseconds& timeout);
+
 /**
  * Reads http response from a socket
  */
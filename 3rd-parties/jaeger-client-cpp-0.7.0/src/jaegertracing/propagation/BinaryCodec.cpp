@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/propagation/BinaryCodec.h"
+
+#include <cstring>
+#include <string>
+
+#include "jaegertracing/platform/Endian.h"
+
+namespace jaegertracing {
+namespace propagation {
+namespace {
+
+template <typename ValueType>
+void store(char* data, ValueType value)
+{
+    value = platform::endian::toBigEndian(value);
+    std::memcpy(data, &value, sizeof(value));
+}
+
+template <typename ValueType>
+ValueType load(const char* data)
+{
+    ValueType value;
+    std::memcpy(&value, data, sizeof(value));
+    return platform::endian::fromBigEndian(value);
+}
+
+}  // anonymous namespace
+
+constexpr size_t BinaryCodec::kTraceIDHighOffset;
+constexpr size_t BinaryCodec::kTraceIDLowOffset;
+constexpr size_t BinaryCodec::kSpanIDOffset;
+constexpr size_t BinaryCodec::kParentIDOffset;
+constexpr size_t BinaryCodec::kFlagsOffset;
+constexpr size_t BinaryCodec::kNumBaggageItemsOffset;
+constexpr size_t BinaryCodec::kFixedSize;
+
+size_t BinaryCodec::encodedSize(const SpanContext& ctx, bool withBaggage)
+{
+    auto size = kFixedSize;
+    if (withBaggage) {
+        for (auto&& item : ctx.baggage()) {
+            size += 2 * sizeof(uint32_t) + item.first.size() +
+                    item.second.size();
+        }
+    }
+    return size;
+}
+
+size_t BinaryCodec::encode(const SpanContext& ctx,
+                           char* data,
+                           size_t size,
+                           bool withBaggage)
+{
+    const auto encodedBytes = encodedSize(ctx, withBaggage);
+    if (size < encodedBytes) {
+        return 0;
+    }
+
+    store(data + kTraceIDHighOffset, ctx.traceID().high());
+    store(data + kTraceIDLowOffset, ctx.traceID().low());
+    store(data + kSpanIDOffset, ctx.spanID());
+    store(data + kParentIDOffset, ctx.parentID());
+    data[kFlagsOffset] = static_cast<char>(ctx.flags());
+    if (!withBaggage) {
+        store(data + kNumBaggageItemsOffset, static_cast<uint32_t>(0));
+        return encodedBytes;
+    }
+
+    const auto& baggage = ctx.baggage();
+    store(data + kNumBaggageItemsOffset,
+          static_cast<uint32_t>(baggage.size()));
+    auto* pos = data + kFixedSize;
+    const auto writeString = [&pos](const std::string& str) {
+        store(pos, static_cast<uint32_t>(str.size()));
+        pos += sizeof(uint32_t);
+        std::memcpy(pos, str.data(), str.size());
+        pos += str.size();
+    };
+    for (auto&& item : baggage) {
+        writeString(item.first);
+        writeString(item.second);
+    }
+    return encodedBytes;
+}
+
+size_t BinaryCodec::decode(const char* data, size_t size, SpanContext& ctx)
+{
+    if (size < kFixedSize) {
+        return 0;
+    }
+    const auto numBaggageItems = load<uint32_t>(data + kNumBaggageItemsOffset);
+    // Every item takes at least its two lengths, so a corrupt count cannot
+    // reserve more than the buffer could hold.
+    if (numBaggageItems > (size - kFixedSize) / (2 * sizeof(uint32_t))) {
+        return 0;
+    }
+
+    auto offset = kFixedSize;
+    const auto readString = [data, size, &offset](
+                                opentracing::string_view& str) {
+        if (size - offset < sizeof(uint32_t)) {
+            return false;
+        }
+        const auto length = load<uint32_t>(data + offset);
+        offset += sizeof(uint32_t);
+        if (size - offset < length) {
+            return false;
+        }
+        str = opentracing::string_view(data + offset, length);
+        offset += length;
+        return true;
+    };
+
+    BaggageMap baggage;
+    baggage.reserve(numBaggageItems);
+    for (auto i = static_cast<uint32_t>(0); i < numBaggageItems; ++i) {
+        opentracing::string_view key;
+        opentracing::string_view value;
+        if (!readString(key) || !readString(value)) {
+            return 0;
+        }
+        baggage[key].assign(value.data(), value.size());
+    }
+
+    ctx = SpanContext(TraceID(load<uint64_t>(data + kTraceIDHighOffset),
+                              load<uint64_t>(data + kTraceIDLowOffset)),
+                      load<uint64_t>(data + kSpanIDOffset),
+                      load<uint64_t>(data + kParentIDOffset),
+                      static_cast<unsigned char>(data[kFlagsOffset]),
+                      baggage);
+    return offset;
+}
+
+}  // namespace propagation
+}  // namespace jaegertracing
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_PROPAGATION_BINARYCODEC_H
+#define JAEGERTRACING_PROPAGATION_BINARYCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "jaegertracing/SpanContext.h"
+
+namespace jaegertracing {
+namespace propagation {
+
+// Encodes a span context into a caller-provided buffer, for binary RPC
+// headers that cannot afford the streams of BinaryPropagator. The fields
+// sit at the fixed offsets below, followed by the baggage items as
+// length-prefixed keys and values. Integers are big-endian.
+class BinaryCodec {
+  public:
+    static constexpr size_t kTraceIDHighOffset = 0;
+    static constexpr size_t kTraceIDLowOffset =
+        kTraceIDHighOffset + sizeof(uint64_t);
+    static constexpr size_t kSpanIDOffset =
+        kTraceIDLowOffset + sizeof(uint64_t);
+    static constexpr size_t kParentIDOffset = kSpanIDOffset + sizeof(uint64_t);
+    static constexpr size_t kFlagsOffset = kParentIDOffset + sizeof(uint64_t);
+    static constexpr size_t kNumBaggageItemsOffset =
+        kFlagsOffset + sizeof(uint8_t);
+    static constexpr size_t kFixedSize =
+        kNumBaggageItemsOffset + sizeof(uint32_t);
+
+    // Size encode() needs for `ctx`, `kFixedSize` without baggage.
+    static size_t encodedSize(const SpanContext& ctx, bool withBaggage = true);
+
+    // Returns the number of bytes written, or zero if `size` is too small.
+    static size_t encode(const SpanContext& ctx,
+                         char* data,
+                         size_t size,
+                         bool withBaggage = true);
+
+    // Returns the number of bytes read, or zero if `data` is truncated, in
+    // which case `ctx` is left unchanged.
+    static size_t decode(const char* data, size_t size, SpanContext& ctx);
+};
+
+}  // namespace propagation
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_PROPAGATION_BINARYCODEC_H
@@ -34,34 +34,42 @@ class JaegerPropagator : public Propagator<ReaderType, WriterType> {
   protected:
     SpanContext doExtract(const Reader& reader) const override
     {
-        SpanContext ctx;
-        StrMap baggage;
-        const auto result =
-            reader.ForeachKey([this, &ctx, &baggage](const std::string& rawKey,
-                                                     const std::string& value) {
-                const auto key = this->normalizeKey(rawKey);
-                if (key == this->_headerKeys.traceContextHeaderName()) {
-                    const auto safeValue = this->decodeValue(value);
-                    std::istringstream iss(safeValue);
-                    if (!(iss >> ctx) || ctx == SpanContext()) {
+        // Capturing no more than two pointers lets std::function keep the
+        // callback inline instead of allocating it.
+        struct {
+            SpanContext _ctx;
+            BaggageMap _baggage;
+        } extracted;
+        const auto result = reader.ForeachKey(
+            [this, &extracted](opentracing::string_view rawKey,
+                               opentracing::string_view value) {
+                auto& ctx = extracted._ctx;
+                auto& baggage = extracted._baggage;
+                const auto& prefix =
+                    this->_headerKeys.traceBaggageHeaderPrefix();
+                if (this->keyEquals(
+                        rawKey, this->_headerKeys.traceContextHeaderName())) {
+                    std::string buffer;
+                    ctx = SpanContext::fromString(
+                        this->decodedView(value, buffer));
+                    if (!ctx.traceID().isValid()) {
                         return opentracing::make_expected_from_error<void>(
                             opentracing::span_context_corrupted_error);
                     }
                 }
-                else if (key == this->_headerKeys.jaegerBaggageHeader()) {
+                else if (this->keyEquals(
+                             rawKey, this->_headerKeys.jaegerBaggageHeader())) {
                     for (auto&& pair : parseCommaSeparatedMap(value)) {
                         baggage[pair.first] = pair.second;
                     }
                 }
-                else {
-                    const auto prefix =
-                        this->_headerKeys.traceBaggageHeaderPrefix();
-                    if (key.size() >= prefix.size() &&
-                        key.substr(0, prefix.size()) == prefix) {
-                        const auto safeKey = removeBaggageKeyPrefix(key);
-                        const auto safeValue = this->decodeValue(value);
-                        baggage[safeKey] = safeValue;
-                    }
+                else if (this->keyHasPrefix(rawKey, prefix)) {
+                    const auto safeKey = this->normalizeKey(
+                        opentracing::string_view(rawKey.data() + prefix.size(),
+                                                 rawKey.size() - prefix.size()));
+                    std::string buffer;
+                    const auto safeValue = this->decodedView(value, buffer);
+                    baggage[safeKey].assign(safeValue.data(), safeValue.size());
                 }
 
                 return opentracing::make_expected();
@@ -73,15 +81,20 @@ class JaegerPropagator : public Propagator<ReaderType, WriterType> {
             return SpanContext();
         }
 
-        return SpanContext(
-            ctx.traceID(), ctx.spanID(), ctx.parentID(), ctx.flags(), baggage);
+        const auto& ctx = extracted._ctx;
+        return SpanContext(ctx.traceID(),
+                           ctx.spanID(),
+                           ctx.parentID(),
+                           ctx.flags(),
+                           extracted._baggage);
     }
 
     void doInject(const SpanContext& ctx, const Writer& writer) const override
     {
-        std::ostringstream oss;
-        oss << ctx;
-        writer.Set(this->_headerKeys.traceContextHeaderName(), oss.str());
+        char buffer[SpanContext::kMaxStringLength];
+        writer.Set(this->_headerKeys.traceContextHeaderName(),
+                   opentracing::string_view(buffer,
+                                            ctx.toChars(buffer) - buffer));
         ctx.forEachBaggageItem(
             [this, &writer](const std::string& key, const std::string& value) {
                 const auto safeKey = addBaggageKeyPrefix(key);
@@ -92,10 +105,11 @@ class JaegerPropagator : public Propagator<ReaderType, WriterType> {
     }
 
   private:
-    static StrMap parseCommaSeparatedMap(const std::string& escapedValue)
+    static StrMap parseCommaSeparatedMap(opentracing::string_view escapedValue)
     {
         StrMap map;
-        std::istringstream iss(net::URI::queryUnescape(escapedValue));
+        std::istringstream iss(
+            net::URI::queryUnescape(std::string(escapedValue)));
         std::string piece;
         while (std::getline(iss, piece, ',')) {
             const auto eqPos = piece.find('=');
@@ -112,11 +126,6 @@ class JaegerPropagator : public Propagator<ReaderType, WriterType> {
     {
         return this->_headerKeys.traceBaggageHeaderPrefix() + key;
     }
-
-    std::string removeBaggageKeyPrefix(const std::string& key) const
-    {
-        return key.substr(this->_headerKeys.traceBaggageHeaderPrefix().size());
-    }
 };
 
 using JaegerTextMapPropagator =
@@ -140,7 +149,25 @@ class JaegerHTTPHeaderPropagator
         return net::URI::queryUnescape(str);
     }
 
-    std::string normalizeKey(const std::string& rawKey) const override
+    bool needsDecoding(opentracing::string_view value) const override
+    {
+        return std::find(std::begin(value), std::end(value), '%') !=
+               std::end(value);
+    }
+
+    bool keyEquals(opentracing::string_view rawKey,
+                   opentracing::string_view key) const override
+    {
+        return rawKey.size() == key.size() &&
+               std::equal(std::begin(rawKey),
+                          std::end(rawKey),
+                          std::begin(key),
+                          [](char lhs, char rhs) {
+                              return std::tolower(lhs) == rhs;
+                          });
+    }
+
+    std::string normalizeKey(opentracing::string_view rawKey) const override
     {
         std::string key;
         key.reserve(rawKey.size());
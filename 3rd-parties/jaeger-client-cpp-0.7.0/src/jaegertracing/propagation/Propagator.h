@@ -59,12 +59,11 @@ class Propagator : public Extractor<ReaderType>, public Injector<WriterType> {
     SpanContext extract(const Reader& reader) const override
     {
         std::string debugID;
-        const auto result =
-            reader.ForeachKey([this, &debugID](const std::string& rawKey,
-                                               const std::string& value) {
-                const auto key = normalizeKey(rawKey);
-                if (key == _headerKeys.jaegerDebugHeader()) {
-                    debugID = value;
+        const auto result = reader.ForeachKey(
+            [this, &debugID](opentracing::string_view rawKey,
+                             opentracing::string_view value) {
+                if (keyEquals(rawKey, _headerKeys.jaegerDebugHeader())) {
+                    debugID.assign(value.data(), value.size());
                 }
 
                 return opentracing::make_expected();
@@ -76,11 +75,14 @@ class Propagator : public Extractor<ReaderType>, public Injector<WriterType> {
             return SpanContext();
         }
 
-        int flags = ctx.flags();
-        if (!debugID.empty()) {
-            flags |= static_cast<unsigned char>(SpanContext::Flag::kDebug) |
-                     static_cast<unsigned char>(SpanContext::Flag::kSampled);
+        if (debugID.empty()) {
+            return ctx;
         }
+
+        const auto flags =
+            ctx.flags() |
+            static_cast<unsigned char>(SpanContext::Flag::kDebug) |
+            static_cast<unsigned char>(SpanContext::Flag::kSampled);
         return SpanContext(ctx.traceID(),
                            ctx.spanID(),
                            ctx.parentID(),
@@ -110,7 +112,42 @@ class Propagator : public Extractor<ReaderType>, public Injector<WriterType> {
         return str;
     }
 
-    virtual std::string normalizeKey(const std::string& rawKey) const
+    // Whether decodeValue would change `value`. Lets extraction skip the
+    // copy for the common case of a value with nothing to unescape.
+    virtual bool needsDecoding(opentracing::string_view /* value */) const
+    {
+        return false;
+    }
+
+    // Returns `value` decoded, using `buffer` as storage only when decoding
+    // is needed.
+    opentracing::string_view decodedView(opentracing::string_view value,
+                                         std::string& buffer) const
+    {
+        if (!needsDecoding(value)) {
+            return value;
+        }
+        buffer = decodeValue(std::string(value));
+        return buffer;
+    }
+
+    // Compares a key as received against a configured key, which is
+    // expected to be in normalized form already.
+    virtual bool keyEquals(opentracing::string_view rawKey,
+                           opentracing::string_view key) const
+    {
+        return rawKey == key;
+    }
+
+    bool keyHasPrefix(opentracing::string_view rawKey,
+                      opentracing::string_view prefix) const
+    {
+        return rawKey.size() >= prefix.size() &&
+               keyEquals(opentracing::string_view(rawKey.data(), prefix.size()),
+                         prefix);
+    }
+
+    virtual std::string normalizeKey(opentracing::string_view rawKey) const
     {
         return rawKey;
     }
@@ -165,8 +202,7 @@ class BinaryPropagator : public Extractor<std::istream&>,
         const auto flags = static_cast<unsigned char>(ch);
 
         const auto numBaggageItems = readBinary<uint32_t>(in);
-        StrMap baggage;
-        baggage.reserve(numBaggageItems);
+        BaggageMap baggage;
         for (auto i = static_cast<uint32_t>(0); i < numBaggageItems; ++i) {
             const auto keyLength = readBinary<uint32_t>(in);
             std::string key(keyLength, '\0');
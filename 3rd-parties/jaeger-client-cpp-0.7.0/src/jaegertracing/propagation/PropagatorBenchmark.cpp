@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/Constants.h"
+#include "jaegertracing/propagation/BinaryCodec.h"
+#include "jaegertracing/propagation/JaegerPropagator.h"
+#include "jaegertracing/propagation/W3CPropagator.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jaegertracing {
+namespace propagation {
+namespace {
+
+using Headers = std::vector<std::pair<std::string, std::string>>;
+
+class HeadersReader : public opentracing::HTTPHeadersReader {
+  public:
+    explicit HeadersReader(const Headers& headers)
+        : _headers(headers)
+    {
+    }
+
+    opentracing::expected<void> ForeachKey(
+        std::function<opentracing::expected<void>(opentracing::string_view,
+                                                  opentracing::string_view)> f)
+        const override
+    {
+        for (auto&& pair : _headers) {
+            const auto result = f(pair.first, pair.second);
+            if (!result) {
+                return result;
+            }
+        }
+        return opentracing::make_expected();
+    }
+
+  private:
+    const Headers& _headers;
+};
+
+class NullWriter : public opentracing::HTTPHeadersWriter {
+  public:
+    opentracing::expected<void>
+    Set(opentracing::string_view key,
+        opentracing::string_view value) const override
+    {
+        benchmark::DoNotOptimize(key.data());
+        benchmark::DoNotOptimize(value.data());
+        return opentracing::make_expected();
+    }
+};
+
+// A typical set of headers on an inbound request, plus the trace context.
+Headers requestHeaders(const std::string& name, const std::string& value)
+{
+    return { { "Host", "frontend.svc.cluster.local" },
+             { "User-Agent", "Mozilla/5.0 (X11; Linux x86_64)" },
+             { "Accept", "application/json" },
+             { "Content-Type", "application/json" },
+             { name, value } };
+}
+
+const SpanContext kSpanContext(TraceID(0x0af7651916cd43dd, 0x8448eb211c80319c),
+                               0xb9c7c989f97918e1,
+                               0,
+                               1,
+                               SpanContext::StrMap());
+
+void BM_JaegerExtract(benchmark::State& state)
+{
+    const JaegerHTTPHeaderPropagator propagator;
+    const auto headers = requestHeaders(
+        "Uber-Trace-Id",
+        "0af7651916cd43dd8448eb211c80319c:b9c7c989f97918e1:0:1");
+    const HeadersReader reader(headers);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(propagator.extract(reader));
+    }
+}
+BENCHMARK(BM_JaegerExtract);
+
+void BM_W3CExtract(benchmark::State& state)
+{
+    const W3CHTTPHeaderPropagator propagator;
+    const auto headers = requestHeaders(
+        "Traceparent",
+        "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e1-01");
+    const HeadersReader reader(headers);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(propagator.extract(reader));
+    }
+}
+BENCHMARK(BM_W3CExtract);
+
+void BM_JaegerInject(benchmark::State& state)
+{
+    const JaegerHTTPHeaderPropagator propagator;
+    const NullWriter writer;
+    for (auto _ : state) {
+        propagator.inject(kSpanContext, writer);
+    }
+}
+BENCHMARK(BM_JaegerInject);
+
+void BM_W3CInject(benchmark::State& state)
+{
+    const W3CHTTPHeaderPropagator propagator;
+    const NullWriter writer;
+    for (auto _ : state) {
+        propagator.inject(kSpanContext, writer);
+    }
+}
+BENCHMARK(BM_W3CInject);
+
+void BM_JaegerTextMapExtract(benchmark::State& state)
+{
+    const JaegerTextMapPropagator propagator;
+    const auto headers = requestHeaders(
+        "uber-trace-id",
+        "0af7651916cd43dd8448eb211c80319c:b9c7c989f97918e1:0:1");
+    const HeadersReader reader(headers);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(propagator.extract(reader));
+    }
+}
+BENCHMARK(BM_JaegerTextMapExtract);
+
+void BM_W3CTextMapExtract(benchmark::State& state)
+{
+    const W3CTextMapPropagator propagator;
+    const auto headers = requestHeaders(
+        "traceparent",
+        "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e1-01");
+    const HeadersReader reader(headers);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(propagator.extract(reader));
+    }
+}
+BENCHMARK(BM_W3CTextMapExtract);
+
+void BM_JaegerTextMapInject(benchmark::State& state)
+{
+    const JaegerTextMapPropagator propagator;
+    const NullWriter writer;
+    for (auto _ : state) {
+        propagator.inject(kSpanContext, writer);
+    }
+}
+BENCHMARK(BM_JaegerTextMapInject);
+
+void BM_W3CTextMapInject(benchmark::State& state)
+{
+    const W3CTextMapPropagator propagator;
+    const NullWriter writer;
+    for (auto _ : state) {
+        propagator.inject(kSpanContext, writer);
+    }
+}
+BENCHMARK(BM_W3CTextMapInject);
+
+void BM_BinaryExtract(benchmark::State& state)
+{
+    const BinaryPropagator propagator;
+    std::ostringstream oss;
+    propagator.inject(kSpanContext, oss);
+    const auto encoded = oss.str();
+    for (auto _ : state) {
+        std::istringstream iss(encoded);
+        benchmark::DoNotOptimize(propagator.extract(iss));
+    }
+}
+BENCHMARK(BM_BinaryExtract);
+
+void BM_BinaryInject(benchmark::State& state)
+{
+    const BinaryPropagator propagator;
+    std::ostringstream oss;
+    for (auto _ : state) {
+        oss.str(std::string());
+        propagator.inject(kSpanContext, oss);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_BinaryInject);
+
+void BM_BinaryCodecDecode(benchmark::State& state)
+{
+    std::string encoded(BinaryCodec::encodedSize(kSpanContext), '\0');
+    BinaryCodec::encode(kSpanContext, &encoded[0], encoded.size());
+    SpanContext ctx;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            BinaryCodec::decode(encoded.data(), encoded.size(), ctx));
+    }
+}
+BENCHMARK(BM_BinaryCodecDecode);
+
+void BM_BinaryCodecEncode(benchmark::State& state)
+{
+    char buffer[BinaryCodec::kFixedSize];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            BinaryCodec::encode(kSpanContext, buffer, sizeof(buffer)));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_BinaryCodecEncode);
+
+}  // anonymous namespace
+}  // namespace propagation
+}  // namespace jaegertracing
@@ -15,6 +15,7 @@
  */
 
 #include "jaegertracing/propagation/Propagator.h"
+#include "jaegertracing/propagation/BinaryCodec.h"
 #include "jaegertracing/SpanContext.h"
 #include "jaegertracing/TraceID.h"
 #include <gtest/gtest.h>
@@ -23,6 +24,7 @@
 #include <stddef.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace jaegertracing {
 namespace propagation {
@@ -68,5 +70,35 @@ TEST(Propagator, testBinaryPropagation)
     ASSERT_EQ(ctx, binaryPropagator.extract(ss));
 }
 
+TEST(Propagator, testBinaryCodec)
+{
+    const SpanContext ctx(TraceID(0x0102030405060708, 2),
+                          3,
+                          4,
+                          1,
+                          SpanContext::StrMap({ { "key", "value" } }));
+    const auto size = BinaryCodec::encodedSize(ctx);
+    ASSERT_EQ(BinaryCodec::kFixedSize + 2 * sizeof(uint32_t) + 8, size);
+    std::vector<char> buffer(size);
+    ASSERT_EQ(0u, BinaryCodec::encode(ctx, &buffer[0], size - 1));
+    ASSERT_EQ(size, BinaryCodec::encode(ctx, &buffer[0], size));
+    ASSERT_EQ(1, buffer[BinaryCodec::kTraceIDHighOffset]);
+    ASSERT_EQ(8, buffer[BinaryCodec::kTraceIDHighOffset + 7]);
+    ASSERT_EQ(1, buffer[BinaryCodec::kFlagsOffset]);
+
+    SpanContext decoded;
+    ASSERT_EQ(0u, BinaryCodec::decode(&buffer[0], size - 1, decoded));
+    ASSERT_EQ(SpanContext(), decoded);
+    ASSERT_EQ(size, BinaryCodec::decode(&buffer[0], size, decoded));
+    ASSERT_EQ(ctx, decoded);
+
+    ASSERT_EQ(BinaryCodec::kFixedSize,
+              BinaryCodec::encode(ctx, &buffer[0], size, false));
+    ASSERT_EQ(BinaryCodec::kFixedSize,
+              BinaryCodec::decode(&buffer[0], size, decoded));
+    ASSERT_EQ(ctx.spanID(), decoded.spanID());
+    ASSERT_TRUE(decoded.baggage().empty());
+}
+
 }  // namespace propagation
 }  // namespace jaegertracing
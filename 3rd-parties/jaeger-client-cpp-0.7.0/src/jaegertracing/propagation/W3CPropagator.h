@@ -35,23 +35,29 @@ class W3CPropagator : public Propagator<ReaderType, WriterType> {
   protected:
     SpanContext doExtract(const Reader& reader) const override
     {
-        SpanContext ctx;
-        std::string traceState;
+        // Capturing no more than two pointers lets std::function keep the
+        // callback inline instead of allocating it.
+        struct {
+            SpanContext _ctx;
+            std::string _traceState;
+        } extracted;
         const auto result = reader.ForeachKey(
-            [this, &ctx, &traceState](const std::string& rawKey,
-                                      const std::string& value) {
-                const auto key = this->normalizeKey(rawKey);
-                if (key == kW3CTraceParentHeaderName) {
-                    const auto safeValue = this->decodeValue(value);
-                    std::istringstream iss(safeValue);
-                    ctx = readTraceParent(iss);
-                    if (!iss || ctx == SpanContext()) {
+            [this, &extracted](opentracing::string_view rawKey,
+                               opentracing::string_view value) {
+                if (this->keyEquals(rawKey, kW3CTraceParentHeaderName)) {
+                    std::string buffer;
+                    extracted._ctx =
+                        readTraceParent(this->decodedView(value, buffer));
+                    if (!extracted._ctx.traceID().isValid()) {
                         return opentracing::make_expected_from_error<void>(
                             opentracing::span_context_corrupted_error);
                     }
                 }
-                else if (key == kW3CTraceStateHeaderName) {
-                    traceState = this->decodeValue(value);
+                else if (this->keyEquals(rawKey, kW3CTraceStateHeaderName)) {
+                    std::string buffer;
+                    const auto safeValue = this->decodedView(value, buffer);
+                    extracted._traceState.assign(safeValue.data(),
+                                                 safeValue.size());
                 }
 
                 return opentracing::make_expected();
@@ -63,108 +69,86 @@ class W3CPropagator : public Propagator<ReaderType, WriterType> {
             return SpanContext();
         }
 
+        const auto& ctx = extracted._ctx;
         return SpanContext(ctx.traceID(),
                            ctx.spanID(),
                            ctx.parentID(),
                            ctx.flags(),
-                           StrMap(),
+                           BaggageMap(),
                            "",
-                           traceState);
+                           std::move(extracted._traceState));
     }
 
     void doInject(const SpanContext& ctx, const Writer& writer) const override
     {
-        std::ostringstream oss;
-        writeTraceParent(oss, ctx);
-        writer.Set(kW3CTraceParentHeaderName, oss.str());
+        char buffer[kTraceParentLength];
+        writer.Set(kW3CTraceParentHeaderName,
+                   opentracing::string_view(
+                       buffer, writeTraceParent(ctx, buffer) - buffer));
         if (!ctx.traceState().empty()) {
             writer.Set(kW3CTraceStateHeaderName, ctx.traceState());
         }
     }
 
   private:
-    SpanContext readTraceParent(std::istream& in) const
+    // Version 00 is "00-", 32 hex digits of trace ID, '-', 16 hex digits of
+    // span ID, '-' and 2 hex digits of flags, always 55 characters.
+    static constexpr auto kTraceParentLength = 55;
+    static constexpr auto kTraceIDOffset = 3;
+    static constexpr auto kSpanIDOffset = 36;
+    static constexpr auto kFlagsOffset = 53;
+
+    // Validates and decodes in a single pass over the fixed layout. Returns
+    // an empty context if the value is malformed or has a zero trace or
+    // span ID.
+    static SpanContext readTraceParent(opentracing::string_view value)
     {
-        char ch = '\0';
-        if (!in.get(ch) || ch != '0') {
+        const auto* data = value.data();
+        if (value.size() != kTraceParentLength || data[0] != '0' ||
+            data[1] != '0' || data[kTraceIDOffset - 1] != '-' ||
+            data[kSpanIDOffset - 1] != '-' || data[kFlagsOffset - 1] != '-') {
             return SpanContext();
         }
 
-        if (!in.get(ch) || ch != '0') {
+        auto high = static_cast<uint64_t>(0);
+        auto low = static_cast<uint64_t>(0);
+        auto spanID = static_cast<uint64_t>(0);
+        const auto flagsHigh =
+            utils::HexParsing::hexDigitValue(data[kFlagsOffset]);
+        const auto flagsLow =
+            utils::HexParsing::hexDigitValue(data[kFlagsOffset + 1]);
+        if (!utils::HexParsing::decodeHex16(data + kTraceIDOffset, high) ||
+            !utils::HexParsing::decodeHex16(data + kTraceIDOffset + 16, low) ||
+            !utils::HexParsing::decodeHex16(data + kSpanIDOffset, spanID) ||
+            (flagsHigh | flagsLow) < 0) {
             return SpanContext();
         }
 
-        if (!in.get(ch) || ch != '-') {
+        const TraceID traceID(high, low);
+        if (!traceID.isValid() || spanID == 0) {
             return SpanContext();
         }
 
-        auto traceID = readTraceID(in);
-        if (!traceID.isValid()) {
-            return SpanContext();
-        }
-
-        if (!in.get(ch) || ch != '-') {
-            return SpanContext();
-        }
-
-        constexpr auto kMaxUInt64Chars = static_cast<size_t>(16);
-        auto buffer = utils::HexParsing::readSegment(in, kMaxUInt64Chars, '-');
-        if (buffer.empty()) {
-            return SpanContext();
-        }
-        auto spanID = utils::HexParsing::decodeHex<uint64_t>(buffer);
-
-        if (!in.get(ch) || ch != '-') {
-            return SpanContext();
-        }
-
-        constexpr auto kMaxByteChars = static_cast<size_t>(2);
-        buffer = utils::HexParsing::readSegment(in, kMaxByteChars, '-');
-        if (buffer.empty() || buffer.size() != 2) {
-            return SpanContext();
-        }
-        auto flags = utils::HexParsing::decodeHex<unsigned char>(buffer);
-
-        in.clear();
-
-        return SpanContext(traceID, spanID, 0, flags, StrMap());
+        const auto flags =
+            static_cast<unsigned char>((flagsHigh << 4) | flagsLow);
+        return SpanContext(traceID, spanID, 0, flags, BaggageMap());
     }
 
-    TraceID readTraceID(std::istream& in) const
+    // Writes the version 00 layout and returns the end of the written range.
+    // `first` must have room for kTraceParentLength characters.
+    static char* writeTraceParent(const SpanContext& ctx, char* first)
     {
-        TraceID traceID;
-        constexpr auto kMaxChars = static_cast<size_t>(32);
-        auto buffer = utils::HexParsing::readSegment(in, kMaxChars, '-');
-
-        if (buffer.empty() || buffer.size() != kMaxChars) {
-            return TraceID();
-        }
-
-        auto beginLowStr = std::end(buffer) - kMaxChars / 2;
-        const std::string highStr(std::begin(buffer), beginLowStr);
-        auto high = utils::HexParsing::decodeHex<uint64_t>(highStr);
-        const std::string lowStr(beginLowStr, std::end(buffer));
-        auto low = utils::HexParsing::decodeHex<uint64_t>(lowStr);
-
-        return TraceID(high, low);
-    }
-
-    void writeTraceParent(std::ostream& out, const SpanContext& ctx) const
-    {
-        out << "00";
-        out << '-';
-        writeTraceID(out, ctx.traceID());
-        out << '-';
-        out << std::setw(16) << std::setfill('0') << std::hex << ctx.spanID();
-        out << '-';
-        out << std::setw(2) << std::setfill('0') << std::hex
-            << static_cast<size_t>(ctx.flags());
-    }
-
-    void writeTraceID(std::ostream& out, const TraceID& traceID) const
-    {
-        out << std::setw(16) << std::setfill('0') << std::hex << traceID.high();
-        out << std::setw(16) << std::setfill('0') << std::hex << traceID.low();
+        *first++ = '0';
+        *first++ = '0';
+        *first++ = '-';
+        first = utils::HexParsing::encodeHex16(ctx.traceID().high(), first);
+        first = utils::HexParsing::encodeHex16(ctx.traceID().low(), first);
+        *first++ = '-';
+        first = utils::HexParsing::encodeHex16(ctx.spanID(), first);
+        *first++ = '-';
+        *first++ = utils::HexParsing::kHexDigits[ctx.flags() >> 4];
+        *first++ = utils::HexParsing::kHexDigits[ctx.flags() & 0xf];
+        return first;
     }
 };
 
@@ -188,7 +172,25 @@ class W3CHTTPHeaderPropagator
         return net::URI::queryUnescape(str);
     }
 
-    std::string normalizeKey(const std::string& rawKey) const override
+    bool needsDecoding(opentracing::string_view value) const override
+    {
+        return std::find(std::begin(value), std::end(value), '%') !=
+               std::end(value);
+    }
+
+    bool keyEquals(opentracing::string_view rawKey,
+                   opentracing::string_view key) const override
+    {
+        return rawKey.size() == key.size() &&
+               std::equal(std::begin(rawKey),
+                          std::end(rawKey),
+                          std::begin(key),
+                          [](char lhs, char rhs) {
+                              return std::tolower(lhs) == rhs;
+                          });
+    }
+
+    std::string normalizeKey(opentracing::string_view rawKey) const override
     {
         std::string key;
         key.reserve(rawKey.size());
@@ -96,7 +96,11 @@ TEST(W3CPropagator, testExtract)
         { "00-00000000000000000000000000000000-b9c7c989f97918e1-01", false },
         { "01-0af7651916cd43dd8448eb211c80319-b9c7c989f97918e1-01", false },
         { "01-0af7651916cd43dd8448eb211c80319cc-b9c7c989f97918e1-01", false },
-        { "00-0af7651916cd43dd8448eb211c80319c-0000000000000000-01", false }
+        { "00-0af7651916cd43dd8448eb211c80319c-0000000000000000-01", false },
+        { "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e-01", false },
+        { "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e1-0", false },
+        { "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e1-0x", false },
+        { "00-0af7651916cd43dd8448eb211c80319c-b9c7c989f97918e1-01-", false }
     };
 
     W3CTextMapPropagator textMapPropagator;
@@ -133,6 +137,16 @@ TEST(W3CPropagator, testExtract)
         ReaderMock<opentracing::HTTPHeadersReader>(map));
     ASSERT_EQ(true, spanContext.isValid());
     ASSERT_EQ("foo=bar", spanContext.traceState());
+    ASSERT_EQ(0xff, spanContext.traceID().high());
+    ASSERT_EQ(1, spanContext.traceID().low());
+    ASSERT_EQ(2, spanContext.spanID());
+    ASSERT_EQ(1, spanContext.flags());
+
+    // Copies share the unparsed trace state instead of duplicating it.
+    const SpanContext copy(spanContext);
+    ASSERT_EQ(spanContext.traceState().data(), copy.traceState().data());
+    ASSERT_EQ(spanContext.traceState().data(),
+              spanContext.withBaggage({ { "a", "b" } }).traceState().data());
 }
 
 TEST(W3CPropagator, testInject)
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/reporters/ColumnarReporter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "jaegertracing/Span.h"
+#include "jaegertracing/utils/ErrorUtil.h"
+
+namespace jaegertracing {
+namespace reporters {
+namespace {
+
+constexpr size_t kAlignment = 8;
+
+static_assert(sizeof(ColumnarReporter::FileHeader) == 16,
+              "FileHeader must not be padded");
+static_assert(sizeof(ColumnarReporter::BlockHeader) == 48,
+              "BlockHeader must not be padded");
+static_assert(sizeof(ColumnarReporter::IndexEntry) == 32,
+              "IndexEntry must not be padded");
+static_assert(sizeof(ColumnarReporter::Footer) == 32,
+              "Footer must not be padded");
+
+size_t padded(size_t size)
+{
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+int64_t toMicroseconds(const std::chrono::nanoseconds& duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+}  // anonymous namespace
+
+constexpr uint32_t ColumnarReporter::kMagic;
+constexpr uint32_t ColumnarReporter::kVersion;
+constexpr uint32_t ColumnarReporter::kBlockMagic;
+constexpr size_t ColumnarReporter::kDefaultBlockSize;
+constexpr size_t ColumnarReporter::kMaxPendingBlocks;
+
+void ColumnarReporter::Columns::reserve(size_t size)
+{
+    _traceIDHighs.reserve(size);
+    _traceIDLows.reserve(size);
+    _spanIDs.reserve(size);
+    _parentIDs.reserve(size);
+    _startTimes.reserve(size);
+    _durations.reserve(size);
+    _operationIDs.reserve(size);
+}
+
+void ColumnarReporter::Columns::clear()
+{
+    _traceIDHighs.clear();
+    _traceIDLows.clear();
+    _spanIDs.clear();
+    _parentIDs.clear();
+    _startTimes.clear();
+    _durations.clear();
+    _operationIDs.clear();
+}
+
+ColumnarReporter::ColumnarReporter(const std::string& path,
+                                   logging::Logger& logger,
+                                   size_t blockSize)
+    : _path(path)
+    , _logger(logger)
+    , _blockSize(blockSize)
+    , _fd(-1)
+    , _offset(0)
+    , _index()
+    , _numWrittenNames(0)
+    , _columns()
+    , _internedOperations()
+    , _operations()
+    , _operationNames()
+    , _pending()
+    , _running(true)
+    , _mutex()
+    , _cv()
+    , _thread()
+{
+    if (blockSize == 0) {
+        throw std::invalid_argument("Columnar block size must be positive");
+    }
+    _fd = ::open(
+        path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        throw std::system_error(
+            errno, std::system_category(), "Failed to open " + path);
+    }
+    _columns.reserve(blockSize);
+    const FileHeader header = { kMagic, kVersion, 0 };
+    try {
+        write(&header, sizeof(header));
+        _thread = std::thread([this]() { writeBlocks(); });
+    } catch (...) {
+        ::close(_fd);
+        throw;
+    }
+}
+
+void ColumnarReporter::report(const Span& span) noexcept
+{
+    const auto& context = span.context();
+    const auto startTime =
+        toMicroseconds(span.startTimeSystem().time_since_epoch());
+    const auto duration = toMicroseconds(span.duration());
+    const auto operationName = span.internedOperationName();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running) {
+        return;
+    }
+    try {
+        _columns._traceIDHighs.push_back(context.traceID().high());
+        _columns._traceIDLows.push_back(context.traceID().low());
+        _columns._spanIDs.push_back(context.spanID());
+        _columns._parentIDs.push_back(context.parentID());
+        _columns._startTimes.push_back(startTime);
+        _columns._durations.push_back(duration);
+        _columns._operationIDs.push_back(operationID(operationName));
+        if (_columns.size() < _blockSize) {
+            return;
+        }
+        if (_pending.size() < kMaxPendingBlocks) {
+            queueBlock();
+            return;
+        }
+        // The writer cannot keep up with the disk. The names used by the
+        // dropped spans are still written with the next block.
+        _columns.clear();
+        _logger.error("Writer is behind, dropped spans for " + _path);
+    } catch (...) {
+        _columns.clear();
+        utils::ErrorUtil::logError(_logger,
+                                   "Failed to buffer spans for " + _path);
+    }
+}
+
+void ColumnarReporter::close() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        try {
+            if (_columns.size() > 0) {
+                queueBlock();
+            }
+        } catch (...) {
+            utils::ErrorUtil::logError(_logger,
+                                       "Failed to buffer spans for " + _path);
+        }
+        _running = false;
+    }
+    _cv.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    try {
+        Footer footer;
+        footer._namesOffset = _offset;
+        footer._numNames = static_cast<uint32_t>(_operationNames.size());
+        for (auto&& name : _operationNames) {
+            writeName(name);
+        }
+        footer._indexOffset = _offset;
+        footer._numBlocks = static_cast<uint32_t>(_index.size());
+        write(_index.data(), _index.size() * sizeof(IndexEntry));
+        footer._magic = kMagic;
+        footer._version = kVersion;
+        write(&footer, sizeof(footer));
+    } catch (...) {
+        utils::ErrorUtil::logError(_logger,
+                                   "Failed to write span index to " + _path);
+    }
+    ::close(_fd);
+    _fd = -1;
+}
+
+uint32_t ColumnarReporter::operationID(const OperationName& operationName)
+{
+    const auto poolID = operationName.id();
+    if (poolID != utils::StringPool::kNotInterned &&
+        poolID < _internedOperations.size() &&
+        _internedOperations[poolID] != 0) {
+        return _internedOperations[poolID] - 1;
+    }
+
+    const auto& name = operationName.str();
+    auto itr = _operations.find(name);
+    if (itr == std::end(_operations)) {
+        itr = _operations
+                  .emplace(name, static_cast<uint32_t>(_operationNames.size()))
+                  .first;
+        _operationNames.push_back(name);
+    }
+    if (poolID != utils::StringPool::kNotInterned) {
+        if (poolID >= _internedOperations.size()) {
+            _internedOperations.resize(poolID + 1, 0);
+        }
+        _internedOperations[poolID] = itr->second + 1;
+    }
+    return itr->second;
+}
+
+void ColumnarReporter::queueBlock()
+{
+    _pending.emplace_back();
+    auto& block = _pending.back();
+    std::swap(block._columns, _columns);
+    block._numNames = _operationNames.size();
+    _columns.reserve(_blockSize);
+    _cv.notify_one();
+}
+
+void ColumnarReporter::writeBlocks() noexcept
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this]() { return !_running || !_pending.empty(); });
+        if (_pending.empty()) {
+            return;
+        }
+        const auto block = std::move(_pending.front());
+        _pending.pop_front();
+        try {
+            // Includes the names of dropped and failed blocks.
+            const std::vector<std::string> names(
+                std::begin(_operationNames) + _numWrittenNames,
+                std::begin(_operationNames) + block._numNames);
+            // Written without the lock so report() never waits on the disk.
+            lock.unlock();
+            writeBlock(block._columns, names);
+        } catch (...) {
+            utils::ErrorUtil::logError(_logger,
+                                       "Failed to write spans to " + _path);
+        }
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+    }
+}
+
+void ColumnarReporter::writeBlock(const Columns& columns,
+                                  const std::vector<std::string>& names)
+{
+    const auto& startTimes = columns._startTimes;
+    const auto numSpans = columns.size();
+    BlockHeader header;
+    header._magic = kBlockMagic;
+    header._firstNameID = static_cast<uint32_t>(_numWrittenNames);
+    header._numNames = static_cast<uint32_t>(names.size());
+    header._reserved = 0;
+    header._size = sizeof(header) + 6 * numSpans * sizeof(uint64_t) +
+                   padded(numSpans * sizeof(uint32_t));
+    for (auto&& name : names) {
+        header._size += padded(sizeof(uint32_t) + name.size());
+    }
+    header._numSpans = numSpans;
+    header._minStartTime =
+        *std::min_element(std::begin(startTimes), std::end(startTimes));
+    header._maxStartTime =
+        *std::max_element(std::begin(startTimes), std::end(startTimes));
+
+    const auto offset = _offset;
+    try {
+        write(&header, sizeof(header));
+        writeColumn(columns._traceIDHighs);
+        writeColumn(columns._traceIDLows);
+        writeColumn(columns._spanIDs);
+        writeColumn(columns._parentIDs);
+        writeColumn(startTimes);
+        writeColumn(columns._durations);
+        writeColumn(columns._operationIDs);
+        for (auto&& name : names) {
+            writeName(name);
+        }
+    } catch (...) {
+        // A reader walking the blocks must not find a partial one followed
+        // by others.
+        if (::ftruncate(_fd, static_cast<off_t>(offset)) == 0 &&
+            ::lseek(_fd, static_cast<off_t>(offset), SEEK_SET) >= 0) {
+            _offset = offset;
+        }
+        throw;
+    }
+    _numWrittenNames += names.size();
+    const IndexEntry entry = {
+        offset, numSpans, header._minStartTime, header._maxStartTime
+    };
+    _index.push_back(entry);
+}
+
+void ColumnarReporter::writeName(const std::string& name)
+{
+    const auto length = static_cast<uint32_t>(name.size());
+    write(&length, sizeof(length));
+    write(name.data(), name.size());
+    pad();
+}
+
+void ColumnarReporter::write(const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const auto written = ::write(_fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(
+                errno, std::system_category(), "Failed to write " + _path);
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+        _offset += static_cast<uint64_t>(written);
+    }
+}
+
+void ColumnarReporter::pad()
+{
+    static const char kZeros[kAlignment] = {};
+    const auto remainder = _offset % kAlignment;
+    if (remainder != 0) {
+        write(kZeros, kAlignment - remainder);
+    }
+}
+
+}  // namespace reporters
+}  // namespace jaegertracing
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_REPORTERS_COLUMNARREPORTER_H
+#define JAEGERTRACING_REPORTERS_COLUMNARREPORTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "jaegertracing/Logging.h"
+#include "jaegertracing/OperationName.h"
+#include "jaegertracing/reporters/Reporter.h"
+
+namespace jaegertracing {
+namespace reporters {
+
+// Writes spans to a file as packed columns for offline analysis. Spans are
+// buffered into blocks of `blockSize` spans, which a background thread
+// writes after the `FileHeader` as a `BlockHeader` followed by one array
+// per column, in this order:
+//
+//     uint64_t traceIDHigh[n], traceIDLow[n], spanID[n], parentID[n]
+//     int64_t  startTime[n]    microseconds since the epoch
+//     int64_t  duration[n]     microseconds
+//     uint32_t operationID[n]  padded to a multiple of 8 bytes
+//
+// and then the operation names first used in the block, in operation ID
+// order, as length-prefixed strings padded to 8 bytes. Every block starts
+// with `kBlockMagic` and holds its own size, so a reader can walk the
+// blocks from the file header even if the process died before close(),
+// stopping at the first one that is missing its magic or ends past the
+// end of the file.
+//
+// close() appends every operation name again, then one `IndexEntry` per
+// block and the `Footer`. Every structure and array starts 8-byte aligned,
+// so a reader can map the file, read the footer at its end and use the
+// columns in place. Integers are native-endian. POSIX only.
+class ColumnarReporter : public Reporter {
+  public:
+    static constexpr uint32_t kMagic = 0x4A53434F;  // "JSCO"
+    static constexpr uint32_t kVersion = 2;
+    static constexpr uint32_t kBlockMagic = 0x4B4C4253;  // "SBLK"
+    static constexpr size_t kDefaultBlockSize = 4096;
+    // Full blocks waiting for the writer. Further blocks are dropped.
+    static constexpr size_t kMaxPendingBlocks = 4;
+
+    struct FileHeader {
+        uint32_t _magic;
+        uint32_t _version;
+        uint64_t _reserved;
+    };
+
+    struct BlockHeader {
+        uint32_t _magic;
+        uint32_t _firstNameID;
+        uint32_t _numNames;
+        uint32_t _reserved;
+        // Bytes from this header to the next block.
+        uint64_t _size;
+        uint64_t _numSpans;
+        int64_t _minStartTime;
+        int64_t _maxStartTime;
+    };
+
+    struct IndexEntry {
+        uint64_t _offset;
+        uint64_t _numSpans;
+        int64_t _minStartTime;
+        int64_t _maxStartTime;
+    };
+
+    struct Footer {
+        uint64_t _namesOffset;
+        uint64_t _indexOffset;
+        uint32_t _numNames;
+        uint32_t _numBlocks;
+        uint32_t _magic;
+        uint32_t _version;
+    };
+
+    // Throws std::invalid_argument for a zero block size and
+    // std::system_error if the file cannot be created.
+    ColumnarReporter(const std::string& path,
+                     logging::Logger& logger,
+                     size_t blockSize = kDefaultBlockSize);
+
+    ~ColumnarReporter() { close(); }
+
+    void report(const Span& span) noexcept override;
+
+    // Writes the pending blocks, the last partial block and the index.
+    // Spans reported afterwards are dropped.
+    void close() noexcept override;
+
+  private:
+    struct Columns {
+        void reserve(size_t size);
+
+        void clear();
+
+        size_t size() const { return _spanIDs.size(); }
+
+        std::vector<uint64_t> _traceIDHighs;
+        std::vector<uint64_t> _traceIDLows;
+        std::vector<uint64_t> _spanIDs;
+        std::vector<uint64_t> _parentIDs;
+        std::vector<int64_t> _startTimes;
+        std::vector<int64_t> _durations;
+        std::vector<uint32_t> _operationIDs;
+    };
+
+    struct Block {
+        Columns _columns;
+        // Operation names known when the block was queued.
+        size_t _numNames;
+    };
+
+    uint32_t operationID(const OperationName& operationName);
+
+    void queueBlock();
+
+    void writeBlocks() noexcept;
+
+    // Writes the columns and the names first used since the last block
+    // written. A failed block is truncated away.
+    void writeBlock(const Columns& columns,
+                    const std::vector<std::string>& names);
+
+    void writeName(const std::string& name);
+
+    void write(const void* data, size_t size);
+
+    template <typename ValueType>
+    void writeColumn(const std::vector<ValueType>& column)
+    {
+        write(column.data(), column.size() * sizeof(ValueType));
+        pad();
+    }
+
+    void pad();
+
+    std::string _path;
+    logging::Logger& _logger;
+    size_t _blockSize;
+    // Only used by the writer thread until it is joined in close().
+    int _fd;
+    uint64_t _offset;
+    std::vector<IndexEntry> _index;
+    size_t _numWrittenNames;
+    // Guarded by `_mutex`.
+    Columns _columns;
+    // File operation IDs plus one of interned names, indexed by pool ID.
+    std::vector<uint32_t> _internedOperations;
+    std::unordered_map<std::string, uint32_t> _operations;
+    std::vector<std::string> _operationNames;
+    std::deque<Block> _pending;
+    bool _running;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::thread _thread;
+};
+
+}  // namespace reporters
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_REPORTERS_COLUMNARREPORTER_H
@@ -15,6 +15,10 @@
  */
 
 #include <algorithm>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
 
 #include "jaegertracing/reporters/Config.h"
 #include "jaegertracing/ThriftSender.h"
@@ -22,6 +26,8 @@
 #include "jaegertracing/reporters/LoggingReporter.h"
 #include "jaegertracing/reporters/RemoteReporter.h"
 #include "jaegertracing/utils/EnvVariable.h"
+#include "jaegertracing/utils/ErrorUtil.h"
+#include "jaegertracing/utils/SpoolingTransport.h"
 
 namespace jaegertracing {
 namespace reporters {
@@ -36,22 +42,48 @@ constexpr const char* Config::kJAEGER_ENDPOINT_ENV_PROP;
 constexpr const char* Config::kJAEGER_REPORTER_LOG_SPANS_ENV_PROP;
 constexpr const char* Config::kJAEGER_REPORTER_FLUSH_INTERVAL_ENV_PROP;
 constexpr const char* Config::kJAEGER_REPORTER_MAX_QUEUE_SIZE_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_MAX_QUEUE_SIZE_BYTES_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_SPOOL_PATH_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_SPOOL_SIZE_BYTES_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_NUM_SENDERS_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_COMPRESSION_ENV_PROP;
+constexpr const char* Config::kJAEGER_REPORTER_CRASH_DUMP_PATH_ENV_PROP;
+constexpr size_t Config::kDefaultSpoolSizeBytes;
+constexpr size_t Config::kCrashDumpSlotSize;
 
 std::unique_ptr<Reporter> Config::makeReporter(const std::string& serviceName,
                                                logging::Logger& logger,
                                                metrics::Metrics& metrics) const
 {
-    std::unique_ptr<utils::Transport> transporter =
-        _endpoint.empty()
-            ? (std::unique_ptr<utils::Transport>(new utils::UDPTransporter(
-                  net::IPAddress::v4(_localAgentHostPort), 0)))
-            : (std::unique_ptr<utils::Transport>(
-                  new utils::HTTPTransporter(net::URI::parse(_endpoint), 0)));
-
-    std::unique_ptr<ThriftSender> sender(new ThriftSender(
-        std::forward<std::unique_ptr<utils::Transport>>(transporter)));
-    std::unique_ptr<RemoteReporter> remoteReporter(new RemoteReporter(
-        _bufferFlushInterval, _queueSize, std::move(sender), logger, metrics));
+    std::vector<std::unique_ptr<Sender>> senders;
+    for (auto i = 0; i < _numSenders; ++i) {
+        senders.push_back(makeSender(i, logger, metrics));
+    }
+    std::unique_ptr<RemoteReporter> remoteReporter(
+        new RemoteReporter(_bufferFlushInterval,
+                           _queueSize,
+                           std::move(senders),
+                           logger,
+                           metrics,
+                           _queueSizeBytes));
+    if (!_crashDumpPath.empty()) {
+        const auto fd = ::open(_crashDumpPath.c_str(),
+                               O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                               0644);
+        if (fd < 0) {
+            logger.error("Crash dump disabled, cannot open " + _crashDumpPath);
+        }
+        else {
+            try {
+                // Room for a full queue and as many spans batched by the
+                // senders.
+                remoteReporter->enableCrashFlush(
+                    fd, 2 * _queueSize, kCrashDumpSlotSize);
+            } catch (...) {
+                utils::ErrorUtil::logError(logger, "Crash dump disabled");
+            }
+        }
+    }
     if (_logSpans) {
         logger.info("Initializing logging reporter");
         return std::unique_ptr<CompositeReporter>(new CompositeReporter(
@@ -61,6 +93,38 @@ std::unique_ptr<Reporter> Config::makeReporter(const std::string& serviceName,
     return std::unique_ptr<Reporter>(std::move(remoteReporter));
 }
 
+std::unique_ptr<Sender> Config::makeSender(int index,
+                                           logging::Logger& logger,
+                                           metrics::Metrics& metrics) const
+{
+    auto compression = _compression;
+    if (compression != utils::Compression::kNone &&
+        !utils::Compressor::isAvailable()) {
+        logger.error("Batch compression disabled, built without zlib");
+        compression = utils::Compression::kNone;
+    }
+    std::unique_ptr<utils::Transport> transporter =
+        _endpoint.empty()
+            ? (std::unique_ptr<utils::Transport>(new utils::UDPTransporter(
+                  net::IPAddress::v4(_localAgentHostPort), 0)))
+            : (std::unique_ptr<utils::Transport>(new utils::HTTPTransporter(
+                  net::URI::parse(_endpoint), 0, compression)));
+    if (!_spoolPath.empty()) {
+        // Every sender needs a spool file of its own.
+        const auto spoolPath =
+            (index == 0) ? _spoolPath : _spoolPath + "." + std::to_string(index);
+        try {
+            transporter.reset(new utils::SpoolingTransport(
+                std::move(transporter), spoolPath, _spoolSizeBytes));
+        } catch (...) {
+            utils::ErrorUtil::logError(logger, "Span spool disabled");
+        }
+    }
+
+    return std::unique_ptr<Sender>(
+        new ThriftSender(std::move(transporter), &metrics));
+}
+
 void Config::fromEnv()
 {
     const auto agentHost =
@@ -112,6 +176,48 @@ void Config::fromEnv()
             _queueSize = maxQueueSize.second;
         }
     }
+
+    const auto maxQueueSizeBytes = utils::EnvVariable::getIntVariable(
+        kJAEGER_REPORTER_MAX_QUEUE_SIZE_BYTES_ENV_PROP);
+    if (!maxQueueSizeBytes.first) {
+        if (maxQueueSizeBytes.second > 0) {
+            _queueSizeBytes = maxQueueSizeBytes.second;
+        }
+    }
+
+    const auto spoolPath = utils::EnvVariable::getStringVariable(
+        kJAEGER_REPORTER_SPOOL_PATH_ENV_PROP);
+    if (!spoolPath.empty()) {
+        _spoolPath = spoolPath;
+    }
+
+    const auto numSenders = utils::EnvVariable::getIntVariable(
+        kJAEGER_REPORTER_NUM_SENDERS_ENV_PROP);
+    if (!numSenders.first) {
+        if (numSenders.second > 0) {
+            _numSenders = numSenders.second;
+        }
+    }
+
+    const auto compression = utils::EnvVariable::getStringVariable(
+        kJAEGER_REPORTER_COMPRESSION_ENV_PROP);
+    if (!compression.empty()) {
+        _compression = utils::parseCompression(compression);
+    }
+
+    const auto crashDumpPath = utils::EnvVariable::getStringVariable(
+        kJAEGER_REPORTER_CRASH_DUMP_PATH_ENV_PROP);
+    if (!crashDumpPath.empty()) {
+        _crashDumpPath = crashDumpPath;
+    }
+
+    const auto spoolSizeBytes = utils::EnvVariable::getIntVariable(
+        kJAEGER_REPORTER_SPOOL_SIZE_BYTES_ENV_PROP);
+    if (!spoolSizeBytes.first) {
+        if (spoolSizeBytes.second > 0) {
+            _spoolSizeBytes = spoolSizeBytes.second;
+        }
+    }
 }
 
 }  // namespace reporters
@@ -23,8 +23,10 @@
 #include <utility>
 
 #include "jaegertracing/Logging.h"
+#include "jaegertracing/Sender.h"
 #include "jaegertracing/metrics/Metrics.h"
 #include "jaegertracing/reporters/Reporter.h"
+#include "jaegertracing/utils/Compressor.h"
 #include "jaegertracing/utils/YAML.h"
 #include "jaegertracing/utils/HTTPTransporter.h"
 #include "jaegertracing/utils/UDPTransporter.h"
@@ -47,6 +49,16 @@ class Config {
     static constexpr auto kJAEGER_REPORTER_LOG_SPANS_ENV_PROP = "JAEGER_REPORTER_LOG_SPANS";
     static constexpr auto kJAEGER_REPORTER_FLUSH_INTERVAL_ENV_PROP = "JAEGER_REPORTER_FLUSH_INTERVAL";
     static constexpr auto kJAEGER_REPORTER_MAX_QUEUE_SIZE_ENV_PROP = "JAEGER_REPORTER_MAX_QUEUE_SIZE";
+    static constexpr auto kJAEGER_REPORTER_MAX_QUEUE_SIZE_BYTES_ENV_PROP = "JAEGER_REPORTER_MAX_QUEUE_SIZE_BYTES";
+    static constexpr auto kJAEGER_REPORTER_SPOOL_PATH_ENV_PROP = "JAEGER_REPORTER_SPOOL_PATH";
+    static constexpr auto kJAEGER_REPORTER_SPOOL_SIZE_BYTES_ENV_PROP = "JAEGER_REPORTER_SPOOL_SIZE_BYTES";
+    static constexpr auto kJAEGER_REPORTER_NUM_SENDERS_ENV_PROP = "JAEGER_REPORTER_NUM_SENDERS";
+    static constexpr auto kJAEGER_REPORTER_COMPRESSION_ENV_PROP = "JAEGER_REPORTER_COMPRESSION";
+    static constexpr auto kJAEGER_REPORTER_CRASH_DUMP_PATH_ENV_PROP = "JAEGER_REPORTER_CRASH_DUMP_PATH";
+
+    static constexpr size_t kDefaultSpoolSizeBytes = 16 * 1024 * 1024;
+    // Spans encoded larger than this are not kept for the crash dump.
+    static constexpr size_t kCrashDumpSlotSize = 4096;
 
 
 
@@ -74,8 +86,29 @@ class Config {
             configYAML, "localAgentHostPort", "");
         const auto endpoint = utils::yaml::findOrDefault<std::string>(
             configYAML, "endpoint", "");
-        return Config(
-            queueSize, bufferFlushInterval, logSpans, localAgentHostPort, endpoint);
+        const auto queueSizeBytes =
+            utils::yaml::findOrDefault<size_t>(configYAML, "queueSizeBytes", 0);
+        const auto spoolPath = utils::yaml::findOrDefault<std::string>(
+            configYAML, "spoolPath", "");
+        const auto spoolSizeBytes =
+            utils::yaml::findOrDefault<size_t>(configYAML, "spoolSizeBytes", 0);
+        const auto numSenders =
+            utils::yaml::findOrDefault<int>(configYAML, "numSenders", 0);
+        const auto compression = utils::yaml::findOrDefault<std::string>(
+            configYAML, "compression", "");
+        const auto crashDumpPath = utils::yaml::findOrDefault<std::string>(
+            configYAML, "crashDumpPath", "");
+        return Config(queueSize,
+                      bufferFlushInterval,
+                      logSpans,
+                      localAgentHostPort,
+                      endpoint,
+                      queueSizeBytes,
+                      spoolPath,
+                      spoolSizeBytes,
+                      numSenders,
+                      utils::parseCompression(compression),
+                      crashDumpPath);
     }
 
 #endif  // JAEGERTRACING_WITH_YAML_CPP
@@ -85,7 +118,13 @@ class Config {
         const Clock::duration& bufferFlushInterval =
             defaultBufferFlushInterval(),
         bool logSpans = false,
-        const std::string& localAgentHostPort = kDefaultLocalAgentHostPort, const std::string& endpoint = kDefaultEndpoint)
+        const std::string& localAgentHostPort = kDefaultLocalAgentHostPort, const std::string& endpoint = kDefaultEndpoint,
+        size_t queueSizeBytes = 0,
+        const std::string& spoolPath = "",
+        size_t spoolSizeBytes = kDefaultSpoolSizeBytes,
+        int numSenders = 1,
+        utils::Compression compression = utils::Compression::kNone,
+        const std::string& crashDumpPath = "")
         : _queueSize(queueSize > 0 ? queueSize : kDefaultQueueSize)
         , _bufferFlushInterval(bufferFlushInterval.count() > 0
                                    ? bufferFlushInterval
@@ -95,6 +134,13 @@ class Config {
                                   ? kDefaultLocalAgentHostPort
                                   : localAgentHostPort)
         , _endpoint(endpoint)
+        , _queueSizeBytes(queueSizeBytes)
+        , _spoolPath(spoolPath)
+        , _spoolSizeBytes(spoolSizeBytes > 0 ? spoolSizeBytes
+                                             : kDefaultSpoolSizeBytes)
+        , _numSenders(numSenders > 0 ? numSenders : 1)
+        , _compression(compression)
+        , _crashDumpPath(crashDumpPath)
     {
     }
 
@@ -104,6 +150,9 @@ class Config {
 
     int queueSize() const { return _queueSize; }
 
+    // Byte budget for queued spans, zero if only `queueSize` applies.
+    size_t queueSizeBytes() const { return _queueSizeBytes; }
+
     const Clock::duration& bufferFlushInterval() const
     {
         return _bufferFlushInterval;
@@ -121,14 +170,41 @@ class Config {
       return _endpoint;
     }
 
+    // File that holds batches the transport failed to send until they can be
+    // replayed, empty if spooling is disabled.
+    const std::string& spoolPath() const { return _spoolPath; }
+
+    size_t spoolSizeBytes() const { return _spoolSizeBytes; }
+
+    // Number of reporter worker threads, each with its own sender and
+    // transport.
+    int numSenders() const { return _numSenders; }
+
+    // Encoding of batches sent to the HTTP endpoint, ignored for the agent.
+    utils::Compression compression() const { return _compression; }
+
+    // File the queued and unsent spans are appended to when the process is
+    // killed by a signal, empty if the crash dump is disabled.
+    const std::string& crashDumpPath() const { return _crashDumpPath; }
+
     void fromEnv();
 
   private:
+    std::unique_ptr<Sender> makeSender(int index,
+                                       logging::Logger& logger,
+                                       metrics::Metrics& metrics) const;
+
     int _queueSize;
     Clock::duration _bufferFlushInterval;
     bool _logSpans;
     std::string _localAgentHostPort;
     std::string _endpoint;
+    size_t _queueSizeBytes;
+    std::string _spoolPath;
+    size_t _spoolSizeBytes;
+    int _numSenders;
+    utils::Compression _compression;
+    std::string _crashDumpPath;
 };
 
 }  // namespace reporters
@@ -31,9 +31,14 @@ TEST(Config, testLoadConfig)
         "disabled: false\n"
         "reporter:\n"
         "    logSpans: true\n"
+        "    queueSizeBytes: 1048576\n"
         "    bufferFlushInterval: 88\n"
         "    localAgentHostPort: ahost:22\n"
         "    endpoint: http://somehost:33/api/traces\n"
+        "    spoolPath: /var/tmp/jaeger.spool\n"
+        "    numSenders: 4\n"
+        "    compression: gzip\n"
+        "    crashDumpPath: /var/tmp/jaeger.crash\n"
         "sampler:\n"
         "  type: const\n"
         "  param: 1";
@@ -46,6 +51,12 @@ TEST(Config, testLoadConfig)
     ASSERT_EQ(std::chrono::seconds(88), config.bufferFlushInterval());
     ASSERT_EQ(std::string("ahost:22"), config.localAgentHostPort());
     ASSERT_EQ(std::string("http://somehost:33/api/traces"), config.endpoint());
+    ASSERT_EQ(1048576u, config.queueSizeBytes());
+    ASSERT_EQ(std::string("/var/tmp/jaeger.spool"), config.spoolPath());
+    ASSERT_EQ(Config::kDefaultSpoolSizeBytes, config.spoolSizeBytes());
+    ASSERT_EQ(4, config.numSenders());
+    ASSERT_EQ(utils::Compression::kGzip, config.compression());
+    ASSERT_EQ(std::string("/var/tmp/jaeger.crash"), config.crashDumpPath());
 }
 
 }  // namespace reporters
@@ -16,89 +16,405 @@
 
 #include "jaegertracing/reporters/RemoteReporter.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 
+#include <pthread.h>
+#include <unistd.h>
+
+#include "jaegertracing/Tracer.h"
 #include "jaegertracing/utils/ErrorUtil.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 
 namespace jaegertracing {
 namespace reporters {
+namespace {
+
+// Reporters that must be made consistent across fork(). Leaked so the
+// atfork handlers never see it destroyed.
+struct ForkRegistry {
+    std::mutex _mutex;
+    std::vector<RemoteReporter*> _reporters;
+    std::once_flag _handlersInstalled;
+};
+
+ForkRegistry& forkRegistry()
+{
+    static auto* registry = new ForkRegistry();
+    return *registry;
+}
+
+void encodeProcess(utils::ThriftWriter& writer, const Tracer& tracer)
+{
+    using Type = utils::ThriftWriter::Type;
+    const auto& tracerTags = tracer.tags();
+    writer.writeStructBegin();
+    writer.writeFieldBegin(Type::kString, 1);
+    writer.writeString(tracer.serviceName());
+    writer.writeFieldBegin(Type::kList, 2);
+    writer.writeListBegin(Type::kStruct, tracerTags.size());
+    for (auto&& tag : tracerTags) {
+        tag.encode(writer);
+    }
+    writer.writeStructEnd();
+}
+
+}  // anonymous namespace
 
 RemoteReporter::RemoteReporter(const Clock::duration& bufferFlushInterval,
                                int fixedQueueSize,
                                std::unique_ptr<Sender>&& sender,
                                logging::Logger& logger,
-                               metrics::Metrics& metrics)
+                               metrics::Metrics& metrics,
+                               size_t maxQueueBytes)
+    : RemoteReporter(bufferFlushInterval,
+                     fixedQueueSize,
+                     makeSenders(std::move(sender)),
+                     logger,
+                     metrics,
+                     maxQueueBytes)
+{
+}
+
+RemoteReporter::RemoteReporter(
+    const Clock::duration& bufferFlushInterval,
+    int fixedQueueSize,
+    std::vector<std::unique_ptr<Sender>>&& senders,
+    logging::Logger& logger,
+    metrics::Metrics& metrics,
+    size_t maxQueueBytes)
     : _bufferFlushInterval(bufferFlushInterval)
-    , _fixedQueueSize(fixedQueueSize)
-    , _sender(std::move(sender))
+    , _workerQueueSize(0)
+    , _workerQueueBytes(0)
     , _logger(logger)
     , _metrics(metrics)
-    , _queue()
+    , _workers()
     , _queueLength(0)
-    , _running(true)
-    , _lastFlush(Clock::now())
-    , _cv()
-    , _mutex()
-    , _thread()
+    , _queueBytes(0)
+    , _crashBuffer()
+    , _crashFD(-1)
+    , _forked(false)
+    , _restartMutex()
 {
-    _thread = std::thread([this]() { sweepQueue(); });
+    if (senders.empty()) {
+        throw std::invalid_argument("RemoteReporter needs a sender");
+    }
+    const auto numWorkers = static_cast<int>(senders.size());
+    _workerQueueSize = std::max(fixedQueueSize / numWorkers, 1);
+    if (maxQueueBytes > 0) {
+        _workerQueueBytes = std::max(maxQueueBytes / numWorkers,
+                                     static_cast<size_t>(1));
+    }
+
+    _workers.reserve(numWorkers);
+    for (auto i = 0; i < numWorkers; ++i) {
+        auto* queueGauge = (i < _metrics.numReporterWorkers())
+                               ? &_metrics.reporterWorkerQueueLength(i)
+                               : nullptr;
+        _workers.emplace_back(new Worker(std::move(senders[i]), queueGauge));
+    }
+    startWorkers();
+
+    auto& registry = forkRegistry();
+    std::lock_guard<std::mutex> lock(registry._mutex);
+    std::call_once(registry._handlersInstalled, []() {
+        ::pthread_atfork(&prepareFork, &parentAfterFork, &childAfterFork);
+    });
+    registry._reporters.push_back(this);
+}
+
+RemoteReporter::~RemoteReporter()
+{
+    close();
+    auto& registry = forkRegistry();
+    std::lock_guard<std::mutex> lock(registry._mutex);
+    registry._reporters.erase(std::remove(std::begin(registry._reporters),
+                                          std::end(registry._reporters),
+                                          this),
+                              std::end(registry._reporters));
+}
+
+void RemoteReporter::enableCrashFlush(int fd,
+                                      size_t numSlots,
+                                      size_t slotSize)
+{
+    try {
+        _crashBuffer.reset(new utils::CrashBuffer(numSlots, slotSize));
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    _crashFD = fd;
+    utils::CrashBuffer::install(*_crashBuffer, fd);
 }
 
 void RemoteReporter::report(const Span& span) noexcept
 {
-    std::unique_lock<std::mutex> lock(_mutex);
-    const auto pushed = (static_cast<int>(_queue.size()) < _fixedQueueSize);
+    if (_forked.load(std::memory_order_acquire)) {
+        restartWorkersAfterFork();
+    }
+    // Estimated and encoded outside the lock to keep the critical section
+    // short.
+    const auto spanBytes = (_workerQueueBytes > 0) ? span.estimatedSize() : 0;
+    const auto crashSlot =
+        _crashBuffer ? storeForCrash(span) : utils::CrashBuffer::kNoSlot;
+    auto& worker = workerFor(span);
+    std::unique_lock<std::mutex> lock(worker._mutex);
+    const auto pushed =
+        (static_cast<int>(worker._queue.size()) < _workerQueueSize) &&
+        (_workerQueueBytes == 0 ||
+         worker._queueBytes + spanBytes <= _workerQueueBytes);
     if (pushed) {
-        _queue.push_back(span);
+        worker._queue.push_back(span);
+        if (_crashBuffer) {
+            worker._queuedSlots.push_back(crashSlot);
+        }
+        worker._queueBytes += spanBytes;
         lock.unlock();
-        _cv.notify_one();
+        worker._cv.notify_one();
         ++_queueLength;
+        _queueBytes += spanBytes;
     }
     else {
+        lock.unlock();
+        if (_crashBuffer) {
+            _crashBuffer->release(crashSlot);
+        }
         _metrics.reporterDropped().inc(1);
+        if (spanBytes > 0) {
+            _metrics.reporterDroppedBytes().inc(spanBytes);
+        }
     }
 }
 
 void RemoteReporter::close() noexcept
 {
+    if (_forked.load(std::memory_order_acquire)) {
+        // Drains what the child queued before closing.
+        restartWorkersAfterFork();
+    }
     try {
-        {
-            std::lock_guard<std::mutex> lock(_mutex);
-            if (!_running) {
-                return;
+        std::vector<Worker*> stopped;
+        for (auto&& worker : _workers) {
+            {
+                std::lock_guard<std::mutex> lock(worker->_mutex);
+                if (!worker->_running) {
+                    continue;
+                }
+                worker->_running = false;
+            }
+            worker->_cv.notify_one();
+            stopped.push_back(worker.get());
+        }
+        for (auto* worker : stopped) {
+            if (worker->_thread && worker->_thread->joinable()) {
+                worker->_thread->join();
             }
-            _running = false;
+            flush(*worker);
         }
-        _cv.notify_one();
-        _thread.join();
-        flush();
     } catch (...) {
         utils::ErrorUtil::logError(_logger, "Failed in Reporter::close");
     }
+    if (_crashBuffer && _crashFD >= 0) {
+        utils::CrashBuffer::uninstall(*_crashBuffer);
+        ::close(_crashFD);
+        _crashFD = -1;
+    }
 }
 
-void RemoteReporter::sweepQueue() noexcept
+std::vector<std::unique_ptr<Sender>>
+RemoteReporter::makeSenders(std::unique_ptr<Sender>&& sender)
+{
+    std::vector<std::unique_ptr<Sender>> senders;
+    senders.push_back(std::move(sender));
+    return senders;
+}
+
+void RemoteReporter::prepareFork()
+{
+    auto& registry = forkRegistry();
+    registry._mutex.lock();
+    for (auto* reporter : registry._reporters) {
+        reporter->_restartMutex.lock();
+        for (auto&& worker : reporter->_workers) {
+            worker->_sendMutex.lock();
+            worker->_mutex.lock();
+            worker->_sender->prepareFork();
+        }
+    }
+}
+
+void RemoteReporter::parentAfterFork()
+{
+    auto& registry = forkRegistry();
+    for (auto* reporter : registry._reporters) {
+        for (auto&& worker : reporter->_workers) {
+            worker->_sender->parentAfterFork();
+            worker->_mutex.unlock();
+            worker->_sendMutex.unlock();
+        }
+        reporter->_restartMutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void RemoteReporter::childAfterFork()
+{
+    auto& registry = forkRegistry();
+    for (auto* reporter : registry._reporters) {
+        for (auto&& worker : reporter->_workers) {
+            worker->_sender->childAfterFork();
+            worker->_mutex.unlock();
+            worker->_sendMutex.unlock();
+        }
+        reporter->_forked = true;
+        reporter->_restartMutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void RemoteReporter::startWorkers()
+{
+    for (auto&& worker : _workers) {
+        if (!worker->_running) {
+            continue;
+        }
+        auto* workerPtr = worker.get();
+        worker->_thread.reset(
+            new std::thread([this, workerPtr]() { sweepQueue(*workerPtr); }));
+    }
+}
+
+void RemoteReporter::restartWorkersAfterFork() noexcept
+{
+    try {
+        std::lock_guard<std::mutex> lock(_restartMutex);
+        // Another thread may have restarted them while this one waited.
+        if (!_forked.load(std::memory_order_relaxed)) {
+            return;
+        }
+        for (auto&& worker : _workers) {
+            // The worker thread was not copied into the child, so it can be
+            // neither joined nor destroyed, and its condition variable may
+            // still count it as a waiter. The old worker is leaked and its
+            // sender moved to a fresh one.
+            auto* stale = worker.release();
+            stale->_thread.release();
+            worker.reset(new Worker(std::move(stale->_sender),
+                                    stale->_queueGauge));
+            worker->_running = stale->_running;
+            stale->_queue.clear();
+            // The parent still sends everything queued or batched.
+            worker->_sender->resetAfterFork();
+        }
+        _queueLength = 0;
+        _queueBytes = 0;
+        if (_crashBuffer) {
+            _crashBuffer->clear();
+        }
+        startWorkers();
+        // Released once the workers are in place, for report() to see them.
+        _forked.store(false, std::memory_order_release);
+    } catch (...) {
+        utils::ErrorUtil::logError(_logger,
+                                   "Failed to restart reporter after fork");
+    }
+}
+
+int RemoteReporter::storeForCrash(const Span& span) noexcept
+{
+    try {
+        static thread_local std::string buffer;
+        buffer.clear();
+        utils::ThriftWriter writer(utils::ThriftWriter::Protocol::kCompact,
+                                   buffer);
+        // Spans without a tracer carry no process to write.
+        if (!_crashBuffer->hasHeader() && !span.serviceName().empty()) {
+            encodeProcess(writer, static_cast<const Tracer&>(span.tracer()));
+            _crashBuffer->setHeader(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+        span.encode(writer);
+        return _crashBuffer->store(buffer.data(), buffer.size());
+    } catch (...) {
+        return utils::CrashBuffer::kNoSlot;
+    }
+}
+
+void RemoteReporter::releaseSentSlots(Worker& worker, int numSent) noexcept
+{
+    if (!_crashBuffer) {
+        return;
+    }
+    // Senders send spans in the order they were appended.
+    for (; numSent > 0 && !worker._sentSlots.empty(); --numSent) {
+        _crashBuffer->release(worker._sentSlots.front());
+        worker._sentSlots.pop_front();
+    }
+}
+
+void RemoteReporter::releaseRejectedSlot(Worker& worker) noexcept
+{
+    if (!_crashBuffer || worker._sentSlots.empty()) {
+        return;
+    }
+    _crashBuffer->release(worker._sentSlots.back());
+    worker._sentSlots.pop_back();
+}
+
+RemoteReporter::Worker& RemoteReporter::workerFor(const Span& span) const
+{
+    if (_workers.size() == 1) {
+        return *_workers.front();
+    }
+    const auto traceID = span.context().traceID();
+    return *_workers[(traceID.high() ^ traceID.low()) % _workers.size()];
+}
+
+void RemoteReporter::sweepQueue(Worker& worker) noexcept
 {
     while (true) {
         try {
-            std::unique_lock<std::mutex> lock(_mutex);
-            _cv.wait_until(lock, _lastFlush + _bufferFlushInterval, [this]() {
-                return !_running || !_queue.empty();
-            });
+            std::unique_lock<std::mutex> lock(worker._mutex);
+            worker._cv.wait_until(
+                lock, worker._lastFlush + _bufferFlushInterval, [&worker]() {
+                    return !worker._running || !worker._queue.empty();
+                });
 
-            if (!_running && _queue.empty()) {
+            if (!worker._running && worker._queue.empty()) {
                 return;
             }
 
-            if (!_queue.empty()) {
-                const auto span = _queue.front();
-                _queue.pop_front();
+            if (!worker._queue.empty()) {
+                const auto span = worker._queue.front();
+                worker._queue.pop_front();
+                if (_crashBuffer) {
+                    worker._sentSlots.push_back(worker._queuedSlots.front());
+                    worker._queuedSlots.pop_front();
+                }
                 --_queueLength;
-                sendSpan(span);
+                if (_workerQueueBytes > 0) {
+                    // Finished spans are immutable, so this matches the
+                    // estimate taken in report().
+                    const auto spanBytes =
+                        std::min(worker._queueBytes, span.estimatedSize());
+                    worker._queueBytes -= spanBytes;
+                    _queueBytes -= spanBytes;
+                }
+                if (worker._queueGauge) {
+                    worker._queueGauge->update(worker._queue.size());
+                }
+                lock.unlock();
+                std::lock_guard<std::mutex> sendLock(worker._sendMutex);
+                sendSpan(worker, span);
             }
-            else if (bufferFlushIntervalExpired()) {
-                flush();
+            else if (bufferFlushIntervalExpired(worker)) {
+                lock.unlock();
+                std::lock_guard<std::mutex> sendLock(worker._sendMutex);
+                flush(worker);
             }
         } catch (...) {
             utils::ErrorUtil::logError(_logger,
@@ -107,36 +423,74 @@ void RemoteReporter::sweepQueue() noexcept
     }
 }
 
-void RemoteReporter::sendSpan(const Span& span) noexcept
+void RemoteReporter::sendSpan(Worker& worker, const Span& span) noexcept
 {
     try {
-        const auto flushed = _sender->append(span);
+        const auto start = Clock::now();
+        const auto flushed = worker._sender->append(span);
         if (flushed > 0) {
-            _metrics.reporterSuccess().inc(flushed);
+            releaseSentSlots(worker, flushed);
+            recordFlushLatency(start);
+            recordFlushed(*worker._sender, flushed);
             _metrics.reporterQueueLength().update(_queueLength);
+            _metrics.reporterQueueBytes().update(_queueBytes);
         }
+    } catch (const Sender::RejectedSpan& ex) {
+        // Spans appended before it are still batched.
+        releaseRejectedSlot(worker);
+        recordSendFailure(span, ex);
     } catch (const Sender::Exception& ex) {
-        _metrics.reporterFailure().inc(ex.numFailed());
-        std::ostringstream oss;
-        oss << "error reporting span " << span.operationName() << ": "
-            << ex.what();
-        _logger.error(oss.str());
+        releaseSentSlots(worker, ex.numFailed());
+        recordSendFailure(span, ex);
     }
 }
 
-void RemoteReporter::flush() noexcept
+void RemoteReporter::flush(Worker& worker) noexcept
 {
     try {
-        const auto flushed = _sender->flush();
+        const auto start = Clock::now();
+        const auto flushed = worker._sender->flush();
         if (flushed > 0) {
-            _metrics.reporterSuccess().inc(flushed);
+            releaseSentSlots(worker, flushed);
+            recordFlushLatency(start);
+            recordFlushed(*worker._sender, flushed);
         }
     } catch (const Sender::Exception& ex) {
+        releaseSentSlots(worker, ex.numFailed());
         _metrics.reporterFailure().inc(ex.numFailed());
         _logger.error(ex.what());
     }
 
-    _lastFlush = Clock::now();
+    worker._lastFlush = Clock::now();
+}
+
+void RemoteReporter::recordSendFailure(const Span& span,
+                                       const Sender::Exception& ex)
+{
+    _metrics.reporterFailure().inc(ex.numFailed());
+    std::ostringstream oss;
+    oss << "error reporting span " << span.operationName() << ": "
+        << ex.what();
+    _logger.error(oss.str());
+}
+
+void RemoteReporter::recordFlushLatency(const Clock::time_point& start)
+{
+    _metrics.reporterFlushLatency().record(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                              start)
+            .count());
+}
+
+void RemoteReporter::recordFlushed(const Sender& sender, int numFlushed)
+{
+    const auto numDeferred = sender.numDeferred();
+    if (numDeferred > 0) {
+        _metrics.reporterSpooled().inc(numDeferred);
+    }
+    if (numFlushed > numDeferred) {
+        _metrics.reporterSuccess().inc(numFlushed - numDeferred);
+    }
 }
 
 }  // namespace reporters
@@ -20,8 +20,10 @@
 #include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "jaegertracing/Compilers.h"
 
@@ -30,6 +32,7 @@
 #include "jaegertracing/Sender.h"
 #include "jaegertracing/metrics/Metrics.h"
 #include "jaegertracing/reporters/Reporter.h"
+#include "jaegertracing/utils/CrashBuffer.h"
 
 namespace jaegertracing {
 namespace reporters {
@@ -38,42 +41,134 @@ class RemoteReporter : public Reporter {
   public:
     using Clock = std::chrono::steady_clock;
 
+    // `maxQueueBytes` additionally bounds the queue by the estimated memory
+    // held by queued spans; zero disables the byte budget.
     RemoteReporter(const Clock::duration& bufferFlushInterval,
                    int fixedQueueSize,
                    std::unique_ptr<Sender>&& sender,
                    logging::Logger& logger,
-                   metrics::Metrics& metrics);
+                   metrics::Metrics& metrics,
+                   size_t maxQueueBytes = 0);
 
-    ~RemoteReporter() { close(); }
+    // Runs one worker thread per sender, each with its own queue. Spans are
+    // assigned to workers by trace ID so a trace is batched by one sender.
+    // The queue bounds are split evenly between the workers.
+    RemoteReporter(const Clock::duration& bufferFlushInterval,
+                   int fixedQueueSize,
+                   std::vector<std::unique_ptr<Sender>>&& senders,
+                   logging::Logger& logger,
+                   metrics::Metrics& metrics,
+                   size_t maxQueueBytes = 0);
+
+    ~RemoteReporter();
 
     void report(const Span& span) noexcept override;
 
     void close() noexcept override;
 
-  private:
-    void sweepQueue() noexcept;
-
-    void sendSpan(const Span& span) noexcept;
+    // Keeps every span from report() until its batch is sent encoded in
+    // `numSlots` preallocated slots of `slotSize` bytes, and writes them to
+    // `fd` if the process is killed by a fatal signal or SIGTERM. `fd` is
+    // owned by the reporter from here on. The dump holds the encoded
+    // Process followed by the encoded spans, all compact Thrift framed like
+    // SpoolFile records. Must be called before the first report().
+    void enableCrashFlush(int fd, size_t numSlots, size_t slotSize);
 
-    void flush() noexcept;
-
-    bool bufferFlushIntervalExpired() const
+  private:
+    struct Worker {
+        Worker(std::unique_ptr<Sender>&& sender, metrics::Gauge* queueGauge)
+            : _sender(std::move(sender))
+            , _queueGauge(queueGauge)
+            , _queue()
+            , _queuedSlots()
+            , _sentSlots()
+            , _queueBytes(0)
+            , _running(true)
+            , _lastFlush(Clock::now())
+            , _cv()
+            , _mutex()
+            , _sendMutex()
+            , _thread()
+        {
+        }
+
+        std::unique_ptr<Sender> _sender;
+        metrics::Gauge* _queueGauge;
+        std::deque<Span> _queue;
+        // Crash buffer slots of the queued spans, in lockstep with `_queue`,
+        // and of the spans appended to the sender but not yet flushed.
+        std::deque<int> _queuedSlots;
+        std::deque<int> _sentSlots;
+        size_t _queueBytes;
+        bool _running;
+        Clock::time_point _lastFlush;
+        std::condition_variable _cv;
+        // Guards the queue. Never held while sending, so report() does not
+        // wait on the network.
+        std::mutex _mutex;
+        // Held while the sender is in use, so fork() does not copy a sender
+        // in the middle of an update. Never acquired with `_mutex` held.
+        std::mutex _sendMutex;
+        std::unique_ptr<std::thread> _thread;
+    };
+
+    static std::vector<std::unique_ptr<Sender>>
+    makeSenders(std::unique_ptr<Sender>&& sender);
+
+    // pthread_atfork handlers. The worker mutexes are held across fork so
+    // the child sees consistent queues and senders. The child handler only
+    // flags the reporter; on first use the child drops what the parent
+    // still sends and starts new workers.
+    static void prepareFork();
+
+    static void parentAfterFork();
+
+    static void childAfterFork();
+
+    void startWorkers();
+
+    void restartWorkersAfterFork() noexcept;
+
+    int storeForCrash(const Span& span) noexcept;
+
+    void releaseSentSlots(Worker& worker, int numSent) noexcept;
+
+    // Releases the slot of the span the sender just rejected, the last one
+    // handed to it.
+    void releaseRejectedSlot(Worker& worker) noexcept;
+
+    Worker& workerFor(const Span& span) const;
+
+    void sweepQueue(Worker& worker) noexcept;
+
+    void sendSpan(Worker& worker, const Span& span) noexcept;
+
+    void flush(Worker& worker) noexcept;
+
+    void recordSendFailure(const Span& span, const Sender::Exception& ex);
+
+    void recordFlushLatency(const Clock::time_point& start);
+
+    // Spans spooled for a later retry are not counted as successful.
+    void recordFlushed(const Sender& sender, int numFlushed);
+
+    bool bufferFlushIntervalExpired(const Worker& worker) const
     {
-        return (Clock::now() - _lastFlush) >= _bufferFlushInterval;
+        return (Clock::now() - worker._lastFlush) >= _bufferFlushInterval;
     }
 
     Clock::duration _bufferFlushInterval;
-    int _fixedQueueSize;
-    std::unique_ptr<Sender> _sender;
+    int _workerQueueSize;
+    size_t _workerQueueBytes;
     logging::Logger& _logger;
     metrics::Metrics& _metrics;
-    std::deque<Span> _queue;
+    std::vector<std::unique_ptr<Worker>> _workers;
     std::atomic<int> _queueLength;
-    bool _running;
-    Clock::time_point _lastFlush;
-    std::condition_variable _cv;
-    std::mutex _mutex;
-    std::thread _thread;
+    std::atomic<size_t> _queueBytes;
+    std::unique_ptr<utils::CrashBuffer> _crashBuffer;
+    int _crashFD;
+    std::atomic<bool> _forked;
+    std::mutex _restartMutex;
 };
 
 }  // namespace reporters
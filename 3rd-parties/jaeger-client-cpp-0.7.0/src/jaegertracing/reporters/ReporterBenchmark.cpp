@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/Logging.h"
+#include "jaegertracing/Sender.h"
+#include "jaegertracing/Span.h"
+#include "jaegertracing/ThriftSender.h"
+#include "jaegertracing/metrics/Metrics.h"
+#include "jaegertracing/reporters/RemoteReporter.h"
+#include "jaegertracing/testutils/TracerUtil.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace jaegertracing {
+namespace reporters {
+namespace {
+
+constexpr auto kMaxThreads = 8;
+
+class NullSender : public Sender {
+  public:
+    NullSender()
+        : _numSpans(0)
+    {
+    }
+
+    int append(const Span& span) override
+    {
+        ++_numSpans;
+        return 0;
+    }
+
+    int flush() override
+    {
+        const auto numSpans = _numSpans;
+        _numSpans = 0;
+        return numSpans;
+    }
+
+    void close() override {}
+
+  private:
+    int _numSpans;
+};
+
+// The global tracer reports to a mock agent, which is also the target of
+// the ThriftSender benchmarks.
+const testutils::TracerUtil::ResourceHandle& resources()
+{
+    static const auto handle = testutils::TracerUtil::installGlobalTracer();
+    return *handle;
+}
+
+// A sampled span with a few tags and a log, roughly an RPC server span.
+const Span& serverSpan()
+{
+    static const std::unique_ptr<opentracing::Span> span = []() {
+        resources();
+        auto span = opentracing::Tracer::Global()->StartSpan("GET /users");
+        span->SetTag("span.kind", "server");
+        span->SetTag("http.method", "GET");
+        span->SetTag("http.status_code", 200);
+        span->Log({ { "event", "cache.miss" } });
+        return span;
+    }();
+    return static_cast<const Span&>(*span);
+}
+
+// Reports from every benchmark thread into one reporter, whose worker
+// threads drain the queues into senders that drop the spans.
+void BM_RemoteReporterReport(benchmark::State& state)
+{
+    static std::unique_ptr<RemoteReporter> reporter;
+    static std::unique_ptr<logging::Logger> logger;
+    static std::unique_ptr<metrics::Metrics> metrics;
+    const auto& span = serverSpan();
+    if (state.thread_index() == 0) {
+        std::vector<std::unique_ptr<Sender>> senders;
+        for (auto i = 0; i < state.range(0); ++i) {
+            senders.emplace_back(new NullSender());
+        }
+        logger = logging::nullLogger();
+        metrics = metrics::Metrics::makeNullMetrics();
+        reporter.reset(new RemoteReporter(std::chrono::milliseconds(100),
+                                          100000,
+                                          std::move(senders),
+                                          *logger,
+                                          *metrics));
+    }
+    for (auto _ : state) {
+        reporter->report(span);
+    }
+    if (state.thread_index() == 0) {
+        reporter.reset();
+    }
+}
+BENCHMARK(BM_RemoteReporterReport)
+    ->ArgName("senders")
+    ->Arg(1)
+    ->Arg(4)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+// Appends spans to a ThriftSender and flushes every `state.range(0)` spans
+// to the mock agent over UDP.
+void BM_ThriftSenderAppendFlush(benchmark::State& state)
+{
+    const auto& span = serverSpan();
+    const auto& mockAgent = resources()._mockAgent;
+    ThriftSender sender(mockAgent->spanServerClient());
+    const auto spansPerFlush = state.range(0);
+    auto numSpans = 0;
+    for (auto _ : state) {
+        sender.append(span);
+        if (++numSpans == spansPerFlush) {
+            sender.flush();
+            numSpans = 0;
+        }
+    }
+    sender.flush();
+    state.SetItemsProcessed(state.iterations());
+    // The agent keeps every batch it receives.
+    mockAgent->resetBatches();
+}
+BENCHMARK(BM_ThriftSenderAppendFlush)
+    ->ArgName("spansPerFlush")
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100);
+
+}  // anonymous namespace
+}  // namespace reporters
+}  // namespace jaegertracing
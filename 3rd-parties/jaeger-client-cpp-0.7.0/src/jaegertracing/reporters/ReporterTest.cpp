@@ -19,22 +19,39 @@
 #include "jaegertracing/Logging.h"
 #include "jaegertracing/Tracer.h"
 #include "jaegertracing/Sender.h"
+#include "jaegertracing/metrics/InMemoryStatsReporter.h"
+#include "jaegertracing/reporters/ColumnarReporter.h"
 #include "jaegertracing/reporters/CompositeReporter.h"
 #include "jaegertracing/reporters/InMemoryReporter.h"
 #include "jaegertracing/reporters/LoggingReporter.h"
 #include "jaegertracing/reporters/NullReporter.h"
 #include "jaegertracing/reporters/RemoteReporter.h"
+#include "jaegertracing/reporters/TailSamplingReporter.h"
 #include "jaegertracing/samplers/ConstSampler.h"
 
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 namespace jaegertracing {
 namespace reporters {
 namespace {
 
 class FakeTransport : public Sender {
   public:
-    FakeTransport(std::vector<Span>& spans, std::mutex& mutex)
+    FakeTransport(std::vector<Span>& spans,
+                  std::mutex& mutex,
+                  bool spooled = false)
         : _spans(spans)
         , _mutex(mutex)
+        , _spooled(spooled)
     {
     }
 
@@ -47,15 +64,189 @@ class FakeTransport : public Sender {
 
     int flush() override { return 0; }
 
+    int numDeferred() const override { return _spooled ? 1 : 0; }
+
     void close() override {}
 
   private:
     std::vector<Span>& _spans;
     std::mutex& _mutex;
+    bool _spooled;
+};
+
+// Counts the fork handlers called on it.
+class ForkTrackingTransport : public FakeTransport {
+  public:
+    ForkTrackingTransport(std::vector<Span>& spans, std::mutex& mutex)
+        : FakeTransport(spans, mutex)
+        , _numChildForks(0)
+        , _numResets(0)
+    {
+    }
+
+    void childAfterFork() override { ++_numChildForks; }
+
+    void resetAfterFork() override { ++_numResets; }
+
+    int numChildForks() const { return _numChildForks; }
+
+    int numResets() const { return _numResets; }
+
+  private:
+    int _numChildForks;
+    int _numResets;
+};
+
+// Batches spans until flushed and rejects spans named "too-large", like a
+// sender whose packets they do not fit in.
+class RejectingTransport : public Sender {
+  public:
+    RejectingTransport()
+        : _numAppended(0)
+        , _numBatched(0)
+        , _mutex()
+        , _cv()
+    {
+    }
+
+    int append(const Span& span) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_numAppended;
+        _cv.notify_all();
+        if (span.operationName() == "too-large") {
+            throw Sender::RejectedSpan("Span is too large");
+        }
+        ++_numBatched;
+        return 0;
+    }
+
+    int flush() override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto numFlushed = _numBatched;
+        _numBatched = 0;
+        return numFlushed;
+    }
+
+    void close() override {}
+
+    void waitForAppends(int numAppends)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this, numAppends]() {
+            return _numAppended >= numAppends;
+        });
+    }
+
+  private:
+    int _numAppended;
+    int _numBatched;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+};
+
+// Holds the first append until released.
+class BlockingTransport : public Sender {
+  public:
+    BlockingTransport()
+        : _numAppended(0)
+        , _open(false)
+        , _mutex()
+        , _cv()
+    {
+    }
+
+    int append(const Span& span) override
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_numAppended;
+        _cv.notify_all();
+        _cv.wait(lock, [this]() { return _open; });
+        return 1;
+    }
+
+    int flush() override { return 0; }
+
+    void close() override {}
+
+    void waitForAppend()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]() { return _numAppended > 0; });
+    }
+
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _open = true;
+        }
+        _cv.notify_all();
+    }
+
+  private:
+    int _numAppended;
+    bool _open;
+    std::mutex _mutex;
+    std::condition_variable _cv;
 };
 
 const Span span;
 
+Span makeFinishedSpan(uint64_t traceID,
+                      uint64_t spanID,
+                      uint64_t parentID,
+                      const std::string& operationName,
+                      const std::chrono::milliseconds& duration,
+                      const std::vector<Tag>& tags = {})
+{
+    const auto startTime = Span::SteadyClock::now();
+    Span span(nullptr,
+              SpanContext(TraceID(0, traceID), spanID, parentID, 1, {}),
+              operationName,
+              Span::SystemClock::now(),
+              startTime,
+              tags);
+    opentracing::FinishSpanOptions options;
+    options.finish_steady_timestamp = startTime + duration;
+    span.FinishWithOptions(options);
+    return span;
+}
+
+// Walks the whole blocks of a columnar file from its header and appends the
+// operation names they introduce to `names`.
+std::vector<ColumnarReporter::BlockHeader>
+readColumnarBlocks(const std::string& contents,
+                   std::vector<std::string>& names)
+{
+    using BlockHeader = ColumnarReporter::BlockHeader;
+    const auto padded = [](size_t size) { return (size + 7) / 8 * 8; };
+    std::vector<BlockHeader> blocks;
+    auto offset = sizeof(ColumnarReporter::FileHeader);
+    while (offset + sizeof(BlockHeader) <= contents.size()) {
+        BlockHeader header;
+        std::memcpy(&header, &contents[offset], sizeof(header));
+        if (header._magic != ColumnarReporter::kBlockMagic ||
+            offset + header._size > contents.size()) {
+            break;
+        }
+        auto nameOffset = offset + sizeof(header) +
+                          6 * header._numSpans * sizeof(uint64_t) +
+                          padded(header._numSpans * sizeof(uint32_t));
+        for (auto i = 0u; i < header._numNames; ++i) {
+            uint32_t length = 0;
+            std::memcpy(&length, &contents[nameOffset], sizeof(length));
+            names.push_back(
+                contents.substr(nameOffset + sizeof(length), length));
+            nameOffset += padded(sizeof(length) + length);
+        }
+        blocks.push_back(header);
+        offset += header._size;
+    }
+    return blocks;
+}
+
 }  // anonymous namespace
 
 TEST(Reporter, testRemoteReporter)
@@ -81,6 +272,239 @@ TEST(Reporter, testRemoteReporter)
     ASSERT_EQ(spans.size(), kNumReports);
 }
 
+TEST(Reporter, testRemoteReporterByteBudget)
+{
+    std::vector<Span> spans;
+    std::mutex mutex;
+    auto logger = logging::nullLogger();
+    metrics::InMemoryStatsReporter statsReporter;
+    auto metrics = metrics::Metrics::fromStatsReporter(statsReporter);
+    constexpr auto kFixedQueueSize = 1000;
+    constexpr auto kNumReports = 10;
+    const auto spanBytes = span.estimatedSize();
+    {
+        RemoteReporter reporter(
+            std::chrono::milliseconds(1),
+            kFixedQueueSize,
+            std::unique_ptr<Sender>(new FakeTransport(spans, mutex)),
+            *logger,
+            *metrics,
+            spanBytes - 1);
+        for (auto i = 0; i < kNumReports; ++i) {
+            reporter.report(span);
+        }
+        reporter.close();
+    }
+    ASSERT_TRUE(spans.empty());
+    const auto& counters = statsReporter.counters();
+    ASSERT_EQ(kNumReports,
+              counters.at("jaeger.reporter-spans.state=dropped"));
+    ASSERT_EQ(static_cast<int64_t>(kNumReports * spanBytes),
+              counters.at("jaeger.reporter-bytes.state=dropped"));
+
+    {
+        RemoteReporter reporter(
+            std::chrono::milliseconds(1),
+            kFixedQueueSize,
+            std::unique_ptr<Sender>(new FakeTransport(spans, mutex)),
+            *logger,
+            *metrics,
+            kNumReports * spanBytes);
+        for (auto i = 0; i < kNumReports; ++i) {
+            reporter.report(span);
+        }
+        reporter.close();
+    }
+    ASSERT_EQ(kNumReports, static_cast<int>(spans.size()));
+    ASSERT_EQ(1,
+              static_cast<int>(statsReporter.timers().count(
+                  "jaeger.reporter-flush-latency")));
+}
+
+TEST(Reporter, testRemoteReporterSpooled)
+{
+    std::vector<Span> spans;
+    std::mutex mutex;
+    auto logger = logging::nullLogger();
+    metrics::InMemoryStatsReporter statsReporter;
+    auto metrics = metrics::Metrics::fromStatsReporter(statsReporter);
+    constexpr auto kNumReports = 10;
+    {
+        RemoteReporter reporter(
+            std::chrono::milliseconds(1),
+            kNumReports,
+            std::unique_ptr<Sender>(new FakeTransport(spans, mutex, true)),
+            *logger,
+            *metrics);
+        for (auto i = 0; i < kNumReports; ++i) {
+            reporter.report(span);
+        }
+        reporter.close();
+    }
+    const auto& counters = statsReporter.counters();
+    ASSERT_EQ(kNumReports,
+              counters.at("jaeger.reporter-spans.state=spooled"));
+    ASSERT_EQ(0, counters.count("jaeger.reporter-spans.state=success"));
+}
+
+TEST(Reporter, testRemoteReporterReportWhileSending)
+{
+    auto logger = logging::nullLogger();
+    metrics::InMemoryStatsReporter statsReporter;
+    auto metrics = metrics::Metrics::fromStatsReporter(statsReporter);
+    auto* sender = new BlockingTransport();
+    constexpr auto kFixedQueueSize = 10;
+    RemoteReporter reporter(std::chrono::milliseconds(1),
+                            kFixedQueueSize,
+                            std::unique_ptr<Sender>(sender),
+                            *logger,
+                            *metrics);
+    reporter.report(span);
+    sender->waitForAppend();
+
+    // The worker is stuck sending, reporting must still not block.
+    for (auto i = 0; i < kFixedQueueSize + 1; ++i) {
+        reporter.report(span);
+    }
+    ASSERT_EQ(1, statsReporter.counters().at(
+                     "jaeger.reporter-spans.state=dropped"));
+    sender->open();
+    reporter.close();
+    ASSERT_EQ(kFixedQueueSize + 1,
+              statsReporter.counters().at(
+                  "jaeger.reporter-spans.state=success"));
+}
+
+TEST(Reporter, testRemoteReporterWorkers)
+{
+    std::vector<Span> spans;
+    std::mutex mutex;
+    auto logger = logging::nullLogger();
+    metrics::InMemoryStatsReporter statsReporter;
+    constexpr auto kNumWorkers = 4;
+    auto metrics =
+        metrics::Metrics::fromStatsReporter(statsReporter, kNumWorkers);
+    std::vector<std::unique_ptr<Sender>> senders;
+    for (auto i = 0; i < kNumWorkers; ++i) {
+        senders.emplace_back(new FakeTransport(spans, mutex));
+    }
+    constexpr auto kNumReports = 100;
+    {
+        RemoteReporter reporter(std::chrono::milliseconds(1),
+                                kNumReports,
+                                std::move(senders),
+                                *logger,
+                                *metrics);
+        for (auto i = 0; i < kNumReports; ++i) {
+            reporter.report(makeFinishedSpan(
+                i + 1, 1, 0, "op", std::chrono::milliseconds(1)));
+        }
+        reporter.close();
+    }
+    ASSERT_EQ(kNumReports, static_cast<int>(spans.size()));
+    const auto& gauges = statsReporter.gauges();
+    for (auto i = 0; i < kNumWorkers; ++i) {
+        ASSERT_EQ(1,
+                  static_cast<int>(gauges.count(
+                      "jaeger.reporter-worker-queue.worker=" +
+                      std::to_string(i))));
+    }
+}
+
+TEST(Reporter, testRemoteReporterFork)
+{
+    std::vector<Span> spans;
+    std::mutex mutex;
+    auto logger = logging::nullLogger();
+    auto metrics = metrics::Metrics::makeNullMetrics();
+    auto* sender = new ForkTrackingTransport(spans, mutex);
+    RemoteReporter reporter(std::chrono::milliseconds(1),
+                            10,
+                            std::unique_ptr<Sender>(sender),
+                            *logger,
+                            *metrics);
+    reporter.report(span);
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        // The parent's worker thread is gone, the child must send with a
+        // worker of its own, started on first use rather than in the fork
+        // handler.
+        const auto lazy =
+            (sender->numChildForks() == 1 && sender->numResets() == 0);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            spans.clear();
+        }
+        reporter.report(span);
+        reporter.close();
+        std::lock_guard<std::mutex> lock(mutex);
+        std::_Exit(
+            (lazy && sender->numResets() == 1 && spans.size() == 1) ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    ASSERT_EQ(0, sender->numChildForks());
+
+    reporter.report(span);
+    reporter.close();
+    ASSERT_EQ(2, static_cast<int>(spans.size()));
+}
+
+TEST(Reporter, testRemoteReporterRejectedSpanCrashSlot)
+{
+    char path[] = "/tmp/jaeger-crash-XXXXXX";
+    const auto fd = ::mkstemp(path);
+    ASSERT_LE(0, fd);
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        auto logger = logging::nullLogger();
+        auto metrics = metrics::Metrics::makeNullMetrics();
+        auto* sender = new RejectingTransport();
+        RemoteReporter reporter(std::chrono::hours(1),
+                                10,
+                                std::unique_ptr<Sender>(sender),
+                                *logger,
+                                *metrics);
+        reporter.enableCrashFlush(fd, 4, 1024);
+        const std::string names[] = { "batched", "too-large", "after" };
+        for (auto i = 0; i < 3; ++i) {
+            reporter.report(makeFinishedSpan(
+                i + 1, 1, 0, names[i], std::chrono::milliseconds(1)));
+        }
+        // The rejected span was handled before the next one was appended.
+        sender->waitForAppends(3);
+        ::raise(SIGTERM);
+        std::_Exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFSIGNALED(status));
+    ASSERT_EQ(SIGTERM, WTERMSIG(status));
+
+    ::lseek(fd, 0, SEEK_SET);
+    std::string dump;
+    char chunk[256];
+    auto numRead = ::read(fd, chunk, sizeof(chunk));
+    while (numRead > 0) {
+        dump.append(chunk, numRead);
+        numRead = ::read(fd, chunk, sizeof(chunk));
+    }
+    ::close(fd);
+    ::unlink(path);
+    // Only the rejected span's slot is released, the batched one is kept.
+    ASSERT_NE(std::string::npos, dump.find("batched"));
+    ASSERT_NE(std::string::npos, dump.find("after"));
+    ASSERT_EQ(std::string::npos, dump.find("too-large"));
+}
+
 TEST(Reporter, testNullReporter)
 {
     NullReporter reporter;
@@ -115,6 +539,131 @@ TEST(Reporter, testInMemoryReporter)
     reporter.close();
 }
 
+TEST(Reporter, testColumnarReporter)
+{
+    using Footer = ColumnarReporter::Footer;
+    using IndexEntry = ColumnarReporter::IndexEntry;
+
+    const std::string path = "/tmp/jaegertracing-columnar-test";
+    const auto logger = logging::nullLogger();
+    {
+        ColumnarReporter reporter(path, *logger, 2);
+        reporter.report(makeFinishedSpan(
+            1, 1, 0, "root", std::chrono::milliseconds(3)));
+        reporter.report(makeFinishedSpan(
+            1, 2, 1, "child", std::chrono::milliseconds(1)));
+        reporter.report(makeFinishedSpan(
+            2, 1, 0, "root", std::chrono::milliseconds(2)));
+        reporter.close();
+        reporter.report(span);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+    ::unlink(path.c_str());
+    ASSERT_GE(contents.size(), sizeof(Footer));
+    Footer footer;
+    std::memcpy(&footer,
+                &contents[contents.size() - sizeof(Footer)],
+                sizeof(Footer));
+    ASSERT_EQ(ColumnarReporter::kMagic, footer._magic);
+    ASSERT_EQ(2u, footer._numNames);
+    ASSERT_EQ(2u, footer._numBlocks);
+
+    std::vector<IndexEntry> index(footer._numBlocks);
+    std::memcpy(&index[0],
+                &contents[footer._indexOffset],
+                index.size() * sizeof(IndexEntry));
+    ASSERT_EQ(2u, index[0]._numSpans);
+    ASSERT_EQ(1u, index[1]._numSpans);
+    ASSERT_LE(index[0]._minStartTime, index[0]._maxStartTime);
+
+    // Column order: trace ID high and low, span ID, parent ID, start time,
+    // duration and operation ID.
+    const auto column = [&contents](const IndexEntry& entry, int number) {
+        return &contents[entry._offset +
+                         sizeof(ColumnarReporter::BlockHeader) +
+                         number * entry._numSpans * sizeof(uint64_t)];
+    };
+    uint64_t parentIDs[2];
+    std::memcpy(parentIDs, column(index[0], 3), sizeof(parentIDs));
+    ASSERT_EQ(0u, parentIDs[0]);
+    ASSERT_EQ(1u, parentIDs[1]);
+    int64_t duration = 0;
+    std::memcpy(&duration, column(index[1], 5), sizeof(duration));
+    ASSERT_EQ(2000, duration);
+    uint32_t operationIDs[2];
+    std::memcpy(operationIDs, column(index[0], 6), sizeof(operationIDs));
+    ASSERT_EQ(0u, operationIDs[0]);
+    ASSERT_EQ(1u, operationIDs[1]);
+    uint32_t operationID = 1;
+    std::memcpy(&operationID, column(index[1], 6), sizeof(operationID));
+    ASSERT_EQ(0u, operationID);
+
+    uint32_t length = 0;
+    std::memcpy(&length, &contents[footer._namesOffset], sizeof(length));
+    ASSERT_EQ(std::string("root"),
+              contents.substr(footer._namesOffset + sizeof(length), length));
+
+    // The blocks describe themselves without the index.
+    std::vector<std::string> names;
+    const auto blocks = readColumnarBlocks(contents, names);
+    ASSERT_EQ(2u, blocks.size());
+    ASSERT_EQ(2u, blocks[0]._numNames);
+    ASSERT_EQ(0u, blocks[1]._numNames);
+    ASSERT_EQ(index[1]._offset, index[0]._offset + blocks[0]._size);
+    ASSERT_EQ((std::vector<std::string>{ "root", "child" }), names);
+}
+
+TEST(Reporter, testColumnarReporterWithoutClose)
+{
+    const std::string path = "/tmp/jaegertracing-columnar-crash-test";
+    const auto readBlocks = [&path](std::vector<std::string>& names) {
+        std::ifstream file(path, std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(file)),
+                                   std::istreambuf_iterator<char>());
+        return readColumnarBlocks(contents, names);
+    };
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        const auto logger = logging::nullLogger();
+        ColumnarReporter reporter(path, *logger, 1);
+        const std::string operationNames[] = { "root", "child", "root" };
+        for (auto i = 0; i < 3; ++i) {
+            reporter.report(makeFinishedSpan(1,
+                                             i + 1,
+                                             i,
+                                             operationNames[i],
+                                             std::chrono::milliseconds(1)));
+        }
+        // Dies once the blocks are written, without the index.
+        for (auto i = 0; i < 1000; ++i) {
+            std::vector<std::string> names;
+            if (readBlocks(names).size() == 3) {
+                std::_Exit(0);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::_Exit(1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+
+    std::vector<std::string> names;
+    const auto blocks = readBlocks(names);
+    ::unlink(path.c_str());
+    ASSERT_EQ(3u, blocks.size());
+    ASSERT_EQ(1u, blocks[1]._firstNameID);
+    ASSERT_EQ(0u, blocks[2]._numNames);
+    ASSERT_EQ((std::vector<std::string>{ "root", "child" }), names);
+}
+
 TEST(Reporter, testCompositeReporter)
 {
     std::vector<std::shared_ptr<Reporter>> reporters;
@@ -131,5 +680,151 @@ TEST(Reporter, testCompositeReporter)
                   ->spansSubmitted());
 }
 
+TEST(Reporter, testTailSamplingReporter)
+{
+    auto inMemoryReporter = std::make_shared<InMemoryReporter>();
+    TailSamplingReporter reporter(
+        inMemoryReporter,
+        { TailSamplingReporter::errorRule(),
+          TailSamplingReporter::latencyRule(std::chrono::milliseconds(10)),
+          TailSamplingReporter::operationRule("checkout") });
+    const auto fast = std::chrono::milliseconds(1);
+
+    reporter.report(makeFinishedSpan(1, 2, 1, "child", fast));
+    ASSERT_EQ(1, reporter.tracesBuffered());
+    reporter.report(makeFinishedSpan(1, 1, 0, "root", fast));
+    ASSERT_EQ(0, reporter.tracesBuffered());
+    ASSERT_EQ(0, inMemoryReporter->spansSubmitted());
+
+    reporter.report(makeFinishedSpan(2, 2, 1, "child", fast));
+    reporter.report(
+        makeFinishedSpan(2, 3, 1, "child", fast, { Tag("error", true) }));
+    ASSERT_EQ(2, inMemoryReporter->spansSubmitted());
+    reporter.report(makeFinishedSpan(2, 1, 0, "root", fast));
+    ASSERT_EQ(3, inMemoryReporter->spansSubmitted());
+
+    reporter.report(
+        makeFinishedSpan(3, 2, 1, "child", fast, { Tag("error", false) }));
+    reporter.report(
+        makeFinishedSpan(3, 1, 0, "root", std::chrono::milliseconds(20)));
+    ASSERT_EQ(5, inMemoryReporter->spansSubmitted());
+
+    reporter.report(makeFinishedSpan(4, 2, 1, "child", fast));
+    reporter.report(makeFinishedSpan(4, 1, 0, "checkout", fast));
+    ASSERT_EQ(7, inMemoryReporter->spansSubmitted());
+    ASSERT_EQ(0, reporter.tracesBuffered());
+}
+
+TEST(Reporter, testTailSamplingReporterEviction)
+{
+    auto inMemoryReporter = std::make_shared<InMemoryReporter>();
+    const auto fast = std::chrono::milliseconds(1);
+    {
+        constexpr auto kMaxTraces = 2;
+        TailSamplingReporter reporter(inMemoryReporter,
+                                      { TailSamplingReporter::errorRule() },
+                                      kMaxTraces);
+        for (auto traceID = 1; traceID <= 3; ++traceID) {
+            reporter.report(makeFinishedSpan(traceID, 2, 1, "child", fast));
+        }
+        ASSERT_EQ(kMaxTraces, reporter.tracesBuffered());
+
+        // The first trace was evicted, so only the new span is kept.
+        reporter.report(
+            makeFinishedSpan(1, 3, 1, "child", fast, { Tag("error", true) }));
+        ASSERT_EQ(1, inMemoryReporter->spansSubmitted());
+        reporter.report(
+            makeFinishedSpan(3, 3, 1, "child", fast, { Tag("error", true) }));
+        ASSERT_EQ(3, inMemoryReporter->spansSubmitted());
+    }
+
+    inMemoryReporter->reset();
+    {
+        TailSamplingReporter reporter(inMemoryReporter,
+                                      { TailSamplingReporter::errorRule() },
+                                      TailSamplingReporter::kDefaultMaxTraces,
+                                      std::chrono::milliseconds(1));
+        reporter.report(makeFinishedSpan(1, 2, 1, "child", fast));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        reporter.report(makeFinishedSpan(2, 2, 1, "child", fast));
+        ASSERT_EQ(1, reporter.tracesBuffered());
+        reporter.close();
+        ASSERT_EQ(0, reporter.tracesBuffered());
+    }
+    ASSERT_EQ(0, inMemoryReporter->spansSubmitted());
+}
+
+TEST(Reporter, testTailSamplingReporterRemoteParent)
+{
+    auto inMemoryReporter = std::make_shared<InMemoryReporter>();
+    TailSamplingReporter reporter(inMemoryReporter,
+                                  { TailSamplingReporter::errorRule() });
+    const auto fast = std::chrono::milliseconds(1);
+
+    // The server span's parent belongs to the calling process.
+    reporter.report(makeFinishedSpan(1, 3, 2, "child", fast));
+    auto server = makeFinishedSpan(1, 2, 1, "server", fast);
+    server.setLocalRoot(true);
+    reporter.report(server);
+    ASSERT_EQ(0, reporter.tracesBuffered());
+    ASSERT_EQ(0, inMemoryReporter->spansSubmitted());
+}
+
+TEST(Reporter, testTailSamplingReporterAfterLocalRoot)
+{
+    auto inMemoryReporter = std::make_shared<InMemoryReporter>();
+    TailSamplingReporter reporter(inMemoryReporter,
+                                  { TailSamplingReporter::errorRule() });
+    const auto fast = std::chrono::milliseconds(1);
+
+    reporter.report(
+        makeFinishedSpan(1, 2, 1, "child", fast, { Tag("error", true) }));
+    reporter.report(makeFinishedSpan(1, 1, 0, "root", fast));
+    ASSERT_EQ(2, inMemoryReporter->spansSubmitted());
+    ASSERT_EQ(0, reporter.tracesBuffered());
+    // A follows-from child of the kept trace finishing after its root.
+    reporter.report(makeFinishedSpan(1, 3, 1, "async", fast));
+    ASSERT_EQ(3, inMemoryReporter->spansSubmitted());
+    ASSERT_EQ(0, reporter.tracesBuffered());
+
+    // Two requests of one trace served by this process at the same time.
+    auto first = makeFinishedSpan(2, 10, 1, "server", fast);
+    first.setLocalRoot(true);
+    auto second = makeFinishedSpan(
+        2, 20, 1, "server", fast, { Tag("error", true) });
+    second.setLocalRoot(true);
+    reporter.report(makeFinishedSpan(2, 11, 10, "child", fast));
+    reporter.report(makeFinishedSpan(2, 21, 20, "child", fast));
+    reporter.report(first);
+    ASSERT_EQ(1, reporter.tracesBuffered());
+    ASSERT_EQ(3, inMemoryReporter->spansSubmitted());
+    reporter.report(second);
+    ASSERT_EQ(5, inMemoryReporter->spansSubmitted());
+    ASSERT_EQ(0, reporter.tracesBuffered());
+}
+
+TEST(Reporter, testTailSamplingReporterSlowTrace)
+{
+    auto inMemoryReporter = std::make_shared<InMemoryReporter>();
+    constexpr auto kMaxTraces = 2;
+    TailSamplingReporter reporter(
+        inMemoryReporter,
+        { TailSamplingReporter::latencyRule(std::chrono::milliseconds(10)) },
+        kMaxTraces);
+    const auto fast = std::chrono::milliseconds(1);
+
+    reporter.report(makeFinishedSpan(1, 2, 1, "child", fast));
+    // Short traces complete while the slow one is still running.
+    for (auto traceID = 2; traceID < 2 + 5 * kMaxTraces; ++traceID) {
+        reporter.report(makeFinishedSpan(traceID, 1, 0, "root", fast));
+    }
+    ASSERT_EQ(1, reporter.tracesBuffered());
+
+    reporter.report(
+        makeFinishedSpan(1, 1, 0, "root", std::chrono::milliseconds(20)));
+    ASSERT_EQ(2, inMemoryReporter->spansSubmitted());
+    ASSERT_EQ(0, reporter.tracesBuffered());
+}
+
 }  // namespace reporters
 }  // namespace jaegertracing
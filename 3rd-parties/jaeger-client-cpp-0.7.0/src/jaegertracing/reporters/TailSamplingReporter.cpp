@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/reporters/TailSamplingReporter.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace jaegertracing {
+namespace reporters {
+
+constexpr int TailSamplingReporter::kDefaultMaxTraces;
+constexpr size_t TailSamplingReporter::kNoSlot;
+
+TailSamplingReporter::Rule TailSamplingReporter::errorRule()
+{
+    return [](const Span& span) {
+        auto error = false;
+        span.forEachTag([&error](const Tag& tag) {
+            error = tag.key() == "error" && tag.value().is<bool>() &&
+                    tag.value().get<bool>();
+            return !error;
+        });
+        return error;
+    };
+}
+
+TailSamplingReporter::Rule
+TailSamplingReporter::latencyRule(const Clock::duration& threshold)
+{
+    return [threshold](const Span& span) {
+        return span.duration() >= threshold;
+    };
+}
+
+TailSamplingReporter::Rule
+TailSamplingReporter::operationRule(const std::string& operationName)
+{
+    return [operationName](const Span& span) {
+        return span.operationName() == operationName;
+    };
+}
+
+TailSamplingReporter::TailSamplingReporter(
+    const std::shared_ptr<Reporter>& reporter,
+    const std::vector<Rule>& rules,
+    int maxTraces,
+    const Clock::duration& traceTimeout)
+    : _reporter(reporter)
+    , _rules(rules)
+    , _traceTimeout(traceTimeout)
+    , _slots(std::max(maxTraces, 1))
+    , _oldest(kNoSlot)
+    , _newest(kNoSlot)
+    , _free(0)
+    , _index()
+    , _keptOrder()
+    , _keptTraces()
+    , _mutex()
+{
+    for (size_t i = 0; i + 1 < _slots.size(); ++i) {
+        _slots[i]._next = i + 1;
+    }
+    _index.reserve(_slots.size());
+}
+
+void TailSamplingReporter::report(const Span& span) noexcept
+{
+    // Rules lock the span, so they run before taking our lock.
+    const auto matched = matches(span);
+    const auto& context = span.context();
+    std::vector<Span> spans;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto now = Clock::now();
+        evictExpired(now);
+        if (_keptTraces.count(context.traceID()) > 0) {
+            // E.g. a follows-from child finishing after its root.
+            spans.push_back(span);
+        }
+        else {
+            auto& trace = findOrAllocate(context.traceID(), now);
+            if (matched && !trace._kept) {
+                trace._kept = true;
+                spans.swap(trace._spans);
+            }
+            if (trace._kept) {
+                spans.push_back(span);
+            }
+            else {
+                trace._spans.push_back(span);
+            }
+            if (span.isLocalRoot()) {
+                // The local root finishes after the spans under it, so
+                // they are complete.
+                if (!trace._kept) {
+                    dropLocalTree(trace, context.spanID());
+                }
+                if (trace._kept || trace._spans.empty()) {
+                    release(trace);
+                }
+            }
+        }
+    }
+
+    for (auto&& keptSpan : spans) {
+        _reporter->report(keptSpan);
+    }
+}
+
+void TailSamplingReporter::close() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (_oldest != kNoSlot) {
+            release(_slots[_oldest]);
+        }
+    }
+    _reporter->close();
+}
+
+bool TailSamplingReporter::matches(const Span& span) const
+{
+    return std::any_of(std::begin(_rules),
+                       std::end(_rules),
+                       [&span](const Rule& rule) { return rule(span); });
+}
+
+TailSamplingReporter::Trace&
+TailSamplingReporter::findOrAllocate(const TraceID& traceID,
+                                     const Clock::time_point& now)
+{
+    const auto itr = _index.find(traceID);
+    if (itr != std::end(_index)) {
+        return _slots[itr->second];
+    }
+
+    if (_free == kNoSlot) {
+        release(_slots[_oldest]);
+    }
+
+    const auto slot = _free;
+    auto& trace = _slots[slot];
+    _free = trace._next;
+    trace._prev = _newest;
+    trace._next = kNoSlot;
+    if (_newest != kNoSlot) {
+        _slots[_newest]._next = slot;
+    }
+    else {
+        _oldest = slot;
+    }
+    _newest = slot;
+    trace._traceID = traceID;
+    trace._firstSeen = now;
+    trace._kept = false;
+    _index[traceID] = slot;
+    return trace;
+}
+
+void TailSamplingReporter::evictExpired(const Clock::time_point& now)
+{
+    // The live list is in allocation order, so the scan stops at the first
+    // trace that has not expired.
+    while (_oldest != kNoSlot &&
+           now - _slots[_oldest]._firstSeen >= _traceTimeout) {
+        release(_slots[_oldest]);
+    }
+}
+
+void TailSamplingReporter::dropLocalTree(Trace& trace, uint64_t spanID)
+{
+    std::unordered_map<uint64_t, uint64_t> parents;
+    for (auto&& span : trace._spans) {
+        parents[span.context().spanID()] = span.context().parentID();
+    }
+    // Whether each span is under the local root, filled in along the walks
+    // up the parents. Spans of another local root end at a parent that has
+    // not finished yet.
+    std::unordered_map<uint64_t, bool> underRoot;
+    underRoot[spanID] = true;
+    std::vector<uint64_t> path;
+    const auto isUnderRoot = [&](uint64_t id) {
+        path.clear();
+        auto result = false;
+        while (true) {
+            const auto known = underRoot.find(id);
+            if (known != std::end(underRoot)) {
+                result = known->second;
+                break;
+            }
+            const auto parent = parents.find(id);
+            if (parent == std::end(parents) || path.size() > parents.size()) {
+                break;
+            }
+            path.push_back(id);
+            id = parent->second;
+        }
+        for (auto&& pathID : path) {
+            underRoot[pathID] = result;
+        }
+        return result;
+    };
+    trace._spans.erase(std::remove_if(std::begin(trace._spans),
+                                      std::end(trace._spans),
+                                      [&isUnderRoot](const Span& span) {
+                                          return isUnderRoot(
+                                              span.context().spanID());
+                                      }),
+                       std::end(trace._spans));
+}
+
+void TailSamplingReporter::release(Trace& trace)
+{
+    const auto slot = static_cast<size_t>(&trace - &_slots[0]);
+    if (trace._prev != kNoSlot) {
+        _slots[trace._prev]._next = trace._next;
+    }
+    else {
+        _oldest = trace._next;
+    }
+    if (trace._next != kNoSlot) {
+        _slots[trace._next]._prev = trace._prev;
+    }
+    else {
+        _newest = trace._prev;
+    }
+    trace._prev = kNoSlot;
+    trace._next = _free;
+    _free = slot;
+
+    _index.erase(trace._traceID);
+    trace._spans.clear();
+    if (trace._kept) {
+        if (_keptOrder.size() >= _slots.size()) {
+            _keptTraces.erase(_keptOrder.front());
+            _keptOrder.pop_front();
+        }
+        _keptOrder.push_back(trace._traceID);
+        _keptTraces.insert(trace._traceID);
+        trace._kept = false;
+    }
+}
+
+}  // namespace reporters
+}  // namespace jaegertracing
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_REPORTERS_TAILSAMPLINGREPORTER_H
+#define JAEGERTRACING_REPORTERS_TAILSAMPLINGREPORTER_H
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "jaegertracing/Span.h"
+#include "jaegertracing/TraceID.h"
+#include "jaegertracing/reporters/Reporter.h"
+
+namespace jaegertracing {
+namespace reporters {
+
+// Buffers the spans of each trace and forwards a trace to the wrapped
+// reporter only once one of its spans matches a rule. Head sampling must let
+// the candidate traces through (e.g. a const sampler), since spans of
+// unsampled traces never reach a reporter.
+//
+// At most `maxTraces` traces are buffered. The spans under a local root are
+// discarded when it finishes without a match, and a whole trace when it has
+// been buffered for longer than `traceTimeout` or when the buffer is full of
+// live traces and it is the oldest. Spans reported after a trace was kept are
+// forwarded immediately, also once its buffer is released, for as long as it
+// is among the last `maxTraces` kept traces.
+class TailSamplingReporter : public Reporter {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Rule = std::function<bool(const Span&)>;
+
+    static constexpr auto kDefaultMaxTraces = 1000;
+
+    static Clock::duration defaultTraceTimeout()
+    {
+        return std::chrono::seconds(30);
+    }
+
+    // Matches spans tagged with `error` set to true.
+    static Rule errorRule();
+
+    // Matches spans that took at least `threshold`.
+    static Rule latencyRule(const Clock::duration& threshold);
+
+    static Rule operationRule(const std::string& operationName);
+
+    TailSamplingReporter(const std::shared_ptr<Reporter>& reporter,
+                         const std::vector<Rule>& rules,
+                         int maxTraces = kDefaultMaxTraces,
+                         const Clock::duration& traceTimeout =
+                             defaultTraceTimeout());
+
+    ~TailSamplingReporter() { close(); }
+
+    void report(const Span& span) noexcept override;
+
+    void close() noexcept override;
+
+    int tracesBuffered() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _index.size();
+    }
+
+  private:
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1);
+
+    struct Trace {
+        Trace()
+            : _traceID()
+            , _firstSeen()
+            , _spans()
+            , _kept(false)
+            , _prev(kNoSlot)
+            , _next(kNoSlot)
+        {
+        }
+
+        TraceID _traceID;
+        Clock::time_point _firstSeen;
+        std::vector<Span> _spans;
+        bool _kept;
+        // Links of the live list, in allocation order, or of the free list.
+        size_t _prev;
+        size_t _next;
+    };
+
+    struct TraceIDHash {
+        size_t operator()(const TraceID& traceID) const
+        {
+            return std::hash<uint64_t>()(traceID.high() ^ traceID.low());
+        }
+    };
+
+    bool matches(const Span& span) const;
+
+    Trace& findOrAllocate(const TraceID& traceID, const Clock::time_point& now);
+
+    void evictExpired(const Clock::time_point& now);
+
+    // Drops the buffered spans under the local root `spanID`, leaving those
+    // of other local roots of the trace that are still running.
+    void dropLocalTree(Trace& trace, uint64_t spanID);
+
+    void release(Trace& trace);
+
+    std::shared_ptr<Reporter> _reporter;
+    std::vector<Rule> _rules;
+    Clock::duration _traceTimeout;
+    std::vector<Trace> _slots;
+    // Live traces from oldest to newest; released slots go to `_free`.
+    size_t _oldest;
+    size_t _newest;
+    size_t _free;
+    std::unordered_map<TraceID, size_t, TraceIDHash> _index;
+    // Released kept traces, oldest first, bounded by the number of slots.
+    std::deque<TraceID> _keptOrder;
+    std::unordered_set<TraceID, TraceIDHash> _keptTraces;
+    mutable std::mutex _mutex;
+};
+
+}  // namespace reporters
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_REPORTERS_TAILSAMPLINGREPORTER_H
@@ -49,6 +49,7 @@ AdaptiveSampler::AdaptiveSampler(
     const sampling_manager::thrift::PerOperationSamplingStrategies& strategies,
     size_t maxOperations)
     : _samplers(samplersFromStrategies(strategies))
+    , _samplersByID()
     , _defaultSampler(strategies.defaultSamplingProbability)
     , _lowerBound(strategies.defaultLowerBoundTracesPerSecond)
     , _maxOperations(maxOperations)
@@ -60,19 +61,53 @@ SamplingStatus AdaptiveSampler::isSampled(const TraceID& id,
                                           const std::string& operation)
 {
     std::lock_guard<std::mutex> lock(_mutex);
+    const auto sampler = findOrCreateSamplerNoLock(operation);
+    if (!sampler) {
+        return _defaultSampler.isSampled(id, operation);
+    }
+    return sampler->isSampled(id, operation);
+}
+
+SamplingStatus AdaptiveSampler::isSampled(const TraceID& id,
+                                          const OperationName& operation)
+{
+    if (!operation.isInterned()) {
+        return isSampled(id, operation.str());
+    }
+
+    const auto index = static_cast<size_t>(operation.id());
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (index < _samplersByID.size() && _samplersByID[index]) {
+        return _samplersByID[index]->isSampled(id, operation.str());
+    }
+
+    const auto sampler = findOrCreateSamplerNoLock(operation.str());
+    if (!sampler) {
+        return _defaultSampler.isSampled(id, operation.str());
+    }
+    if (index >= _samplersByID.size()) {
+        _samplersByID.resize(index + 1);
+    }
+    _samplersByID[index] = sampler;
+    return sampler->isSampled(id, operation.str());
+}
+
+AdaptiveSampler::SamplerPtr
+AdaptiveSampler::findOrCreateSamplerNoLock(const std::string& operation)
+{
     auto samplerItr = _samplers.find(operation);
     if (samplerItr != std::end(_samplers)) {
-        return samplerItr->second->isSampled(id, operation);
+        return samplerItr->second;
     }
     if (_samplers.size() >= _maxOperations) {
-        return _defaultSampler.isSampled(id, operation);
+        return nullptr;
     }
 
     auto newSampler =
         std::make_shared<GuaranteedThroughputProbabilisticSampler>(
             _lowerBound, _defaultSampler.samplingRate());
     _samplers[operation] = newSampler;
-    return newSampler->isSampled(id, operation);
+    return newSampler;
 }
 
 void AdaptiveSampler::close()
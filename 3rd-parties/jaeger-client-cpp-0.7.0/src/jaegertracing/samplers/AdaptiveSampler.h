@@ -20,6 +20,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "jaegertracing/Compilers.h"
 
@@ -53,6 +54,9 @@ class AdaptiveSampler : public Sampler {
     SamplingStatus isSampled(const TraceID& id,
                              const std::string& operation) override;
 
+    SamplingStatus isSampled(const TraceID& id,
+                             const OperationName& operation) override;
+
     void close() override;
 
     void update(const PerOperationSamplingStrategies& strategies);
@@ -60,7 +64,15 @@ class AdaptiveSampler : public Sampler {
     Type type() const override { return Type::kAdaptiveSampler; }
 
   private:
+    using SamplerPtr =
+        std::shared_ptr<GuaranteedThroughputProbabilisticSampler>;
+
+    SamplerPtr findOrCreateSamplerNoLock(const std::string& operation);
+
     SamplerMap _samplers;
+    // Samplers indexed by interned operation name ID. Entries alias the
+    // samplers in `_samplers`, so updates apply to both.
+    std::vector<SamplerPtr> _samplersByID;
     ProbabilisticSampler _defaultSampler;
     double _lowerBound;
     size_t _maxOperations;
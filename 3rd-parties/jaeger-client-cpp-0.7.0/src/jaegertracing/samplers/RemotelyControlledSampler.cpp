@@ -24,6 +24,7 @@
 #include "jaegertracing/net/IPAddress.h"
 #include "jaegertracing/net/Socket.h"
 #include "jaegertracing/net/URI.h"
+#include "jaegertracing/net/http/ConditionalGet.h"
 #include "jaegertracing/net/http/Response.h"
 #include "jaegertracing/samplers/AdaptiveSampler.h"
 #include "jaegertracing/samplers/RemoteSamplingJSON.h"
@@ -32,15 +33,17 @@
 
 namespace jaegertracing {
 namespace samplers {
-namespace {
 
-class HTTPSamplingManager : public sampling_manager::thrift::SamplingManagerIf {
+class HTTPSamplingManager {
   public:
     using SamplingStrategyResponse =
         sampling_manager::thrift::SamplingStrategyResponse;
 
-    HTTPSamplingManager(const std::string& serverURL, logging::Logger& logger)
-        : _serverURI(net::URI::parse(serverURL))
+    HTTPSamplingManager(const std::string& serverURL,
+                        const std::string& serviceName,
+                        logging::Logger& logger)
+        : _strategyGet(strategyURI(serverURL, serviceName))
+        , _response()
         , _logger(logger)
     {
         try {
@@ -52,36 +55,49 @@ class HTTPSamplingManager : public sampling_manager::thrift::SamplingManagerIf {
         }
     }
 
-    void getSamplingStrategy(SamplingStrategyResponse& result,
-                             const std::string& serviceName) override
+    // Returns false if the strategy is unchanged since the last commit(),
+    // without parsing it again.
+    bool getSamplingStrategy(SamplingStrategyResponse& result)
     {
         if (_serverAddr == net::IPAddress()) {
-            return;
+            return false;
         }
-        auto uri = _serverURI;
-        uri._query = "service=" + net::URI::queryEscape(serviceName);
-        const auto responseHTTP = net::http::get(uri);
-        if (responseHTTP.statusCode() != 200) {
+        if (!_strategyGet.get(_response)) {
+            return false;
+        }
+        if (_response.statusCode() != 200) {
             std::ostringstream oss;
             oss << "Received HTTP error response"
                    ", uri="
-                << uri << ", statusCode=" << responseHTTP.statusCode()
-                << ", reason=" << responseHTTP.reason();
+                << _strategyGet.uri()
+                << ", statusCode=" << _response.statusCode()
+                << ", reason=" << _response.reason();
             _logger.error(oss.str());
-            return;
+            return false;
         }
 
-        result = nlohmann::json::parse(responseHTTP.body());
+        result = nlohmann::json::parse(_response.body());
+        return true;
     }
 
+    // Marks the last strategy as applied.
+    void commit() { _strategyGet.commit(_response); }
+
   private:
-    net::URI _serverURI;
+    static net::URI strategyURI(const std::string& serverURL,
+                                const std::string& serviceName)
+    {
+        auto uri = net::URI::parse(serverURL);
+        uri._query = "service=" + net::URI::queryEscape(serviceName);
+        return uri;
+    }
+
+    net::http::ConditionalGet _strategyGet;
+    net::http::Response _response;
     net::IPAddress _serverAddr;
     logging::Logger& _logger;
 };
 
-}  // anonymous namespace
-
 RemotelyControlledSampler::RemotelyControlledSampler(
     const std::string& serviceName,
     const std::string& samplingServerURL,
@@ -89,7 +105,8 @@ RemotelyControlledSampler::RemotelyControlledSampler(
     int maxOperations,
     const Clock::duration& samplingRefreshInterval,
     logging::Logger& logger,
-    metrics::Metrics& metrics)
+    metrics::Metrics& metrics,
+    utils::Poller& poller)
     : _serviceName(serviceName)
     , _samplingServerURL(samplingServerURL)
     , _sampler(sampler)
@@ -97,12 +114,12 @@ RemotelyControlledSampler::RemotelyControlledSampler(
     , _samplingRefreshInterval(samplingRefreshInterval)
     , _logger(logger)
     , _metrics(metrics)
-    , _manager(
-          std::make_shared<HTTPSamplingManager>(_samplingServerURL, _logger))
-    , _running(true)
+    , _manager(std::make_shared<HTTPSamplingManager>(
+          _samplingServerURL, _serviceName, _logger))
+    , _poller(poller)
     , _mutex()
-    , _shutdownCV()
-    , _thread([this]() { pollController(); })
+    , _pollTask(_poller.add(_samplingRefreshInterval,
+                            [this]() { updateSampler(); }))
 {
     assert(_sampler);
 }
@@ -111,42 +128,35 @@ SamplingStatus
 RemotelyControlledSampler::isSampled(const TraceID& id,
                                      const std::string& operation)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    assert(_sampler);
-    return _sampler->isSampled(id, operation);
+    _poller.restartIfForked();
+    return sampler()->isSampled(id, operation);
 }
 
-void RemotelyControlledSampler::close()
+SamplingStatus
+RemotelyControlledSampler::isSampled(const TraceID& id,
+                                     const OperationName& operation)
 {
-    {
-        std::unique_lock<std::mutex> lock(_mutex);
-        if (!_running) {
-            return;
-        }
-        _running = false;
-        lock.unlock();
-        _shutdownCV.notify_one();
-    }
-    _thread.join();
+    _poller.restartIfForked();
+    return sampler()->isSampled(id, operation);
 }
 
-void RemotelyControlledSampler::pollController()
+void RemotelyControlledSampler::close()
 {
-    while (_running) {
-        updateSampler();
-        std::unique_lock<std::mutex> lock(_mutex);
-        _shutdownCV.wait_for(
-            lock, _samplingRefreshInterval, [this]() { return !_running; });
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pollTask == 0) {
+        return;
     }
+    _poller.remove(_pollTask);
+    _pollTask = 0;
 }
 
 void RemotelyControlledSampler::updateSampler()
 {
     assert(_manager);
     sampling_manager::thrift::SamplingStrategyResponse response;
+    auto changed = false;
     try {
-        assert(_manager);
-        _manager->getSamplingStrategy(response, _serviceName);
+        changed = _manager->getSamplingStrategy(response);
     } catch (const std::exception& ex) {
         _metrics.samplerQueryFailure().inc(1);
         return;
@@ -155,8 +165,10 @@ void RemotelyControlledSampler::updateSampler()
         return;
     }
 
-    std::lock_guard<std::mutex> lock(_mutex);
     _metrics.samplerRetrieved().inc(1);
+    if (!changed) {
+        return;
+    }
 
     if (response.__isset.operationSampling) {
         updateAdaptiveSampler(response.operationSampling);
@@ -172,20 +184,25 @@ void RemotelyControlledSampler::updateSampler()
             return;
         }
     }
+    _manager->commit();
     _metrics.samplerUpdated().inc(1);
 }
 
 void RemotelyControlledSampler::updateAdaptiveSampler(
     const PerOperationSamplingStrategies& strategies)
 {
-    auto sampler = _sampler;
+    auto sampler = this->sampler();
     assert(sampler);
     if (sampler->type() == Type::kAdaptiveSampler) {
+        // The adaptive sampler locks internally, so it is updated in place to
+        // keep its per-operation state.
         static_cast<AdaptiveSampler&>(*sampler).update(strategies);
     }
     else {
-        _sampler =
-            std::make_shared<AdaptiveSampler>(strategies, _maxOperations);
+        std::atomic_store(
+            &_sampler,
+            std::shared_ptr<Sampler>(
+                std::make_shared<AdaptiveSampler>(strategies, _maxOperations)));
     }
 }
 
@@ -206,7 +223,7 @@ void RemotelyControlledSampler::updateRateLimitingOrProbabilisticSampler(
         oss << "Unsupported sampling strategy type " << response.strategyType;
         throw std::runtime_error(oss.str());
     }
-    _sampler = sampler;
+    std::atomic_store(&_sampler, sampler);
 }
 
 }  // namespace samplers
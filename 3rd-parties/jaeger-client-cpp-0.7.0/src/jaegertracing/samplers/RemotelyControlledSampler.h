@@ -18,9 +18,8 @@
 #define JAEGERTRACING_SAMPLERS_REMOTELYCONTROLLEDSAMPLER_H
 
 #include <chrono>
-#include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <thread>
 
 #include "jaegertracing/Compilers.h"
 
@@ -29,6 +28,7 @@
 #include "jaegertracing/metrics/Metrics.h"
 #include "jaegertracing/samplers/ProbabilisticSampler.h"
 #include "jaegertracing/samplers/Sampler.h"
+#include "jaegertracing/utils/Poller.h"
 
 namespace jaegertracing {
 
@@ -42,6 +42,11 @@ class SamplingManagerIf;
 
 namespace samplers {
 
+class HTTPSamplingManager;
+
+// Polls the agent for the sampling strategy on the process-wide poller.
+// Each new strategy is published as a sampler snapshot that isSampled reads
+// without locking the remote sampler.
 class RemotelyControlledSampler : public Sampler {
   public:
     using Clock = std::chrono::steady_clock;
@@ -52,13 +57,17 @@ class RemotelyControlledSampler : public Sampler {
                               int maxOperations,
                               const Clock::duration& samplingRefreshInterval,
                               logging::Logger& logger,
-                              metrics::Metrics& metrics);
+                              metrics::Metrics& metrics,
+                              utils::Poller& poller = utils::Poller::shared());
 
     ~RemotelyControlledSampler() { close(); }
 
     SamplingStatus isSampled(const TraceID& id,
                              const std::string& operation) override;
 
+    SamplingStatus isSampled(const TraceID& id,
+                             const OperationName& operation) override;
+
     void close() override;
 
     Type type() const override { return Type::kRemotelyControlledSampler; }
@@ -69,10 +78,13 @@ class RemotelyControlledSampler : public Sampler {
     using SamplingStrategyResponse =
         sampling_manager::thrift::SamplingStrategyResponse;
 
-    void pollController();
-
     void updateSampler();
 
+    std::shared_ptr<Sampler> sampler() const
+    {
+        return std::atomic_load(&_sampler);
+    }
+
     void
     updateAdaptiveSampler(const PerOperationSamplingStrategies& strategies);
 
@@ -86,11 +98,12 @@ class RemotelyControlledSampler : public Sampler {
     Clock::duration _samplingRefreshInterval;
     logging::Logger& _logger;
     metrics::Metrics& _metrics;
-    std::shared_ptr<sampling_manager::thrift::SamplingManagerIf> _manager;
-    bool _running;
+    std::shared_ptr<HTTPSamplingManager> _manager;
+    utils::Poller& _poller;
     std::mutex _mutex;
-    std::condition_variable _shutdownCV;
-    std::thread _thread;
+    // Registered last, since the task may run before the constructor
+    // returns.
+    utils::Poller::TaskID _pollTask;
 };
 
 }  // namespace samplers
@@ -19,6 +19,7 @@
 
 #include "jaegertracing/Compilers.h"
 
+#include "jaegertracing/OperationName.h"
 #include "jaegertracing/TraceID.h"
 #include "jaegertracing/samplers/SamplingStatus.h"
 
@@ -41,6 +42,14 @@ class Sampler {
     virtual SamplingStatus isSampled(const TraceID& id,
                                      const std::string& operation) = 0;
 
+    // Samplers that keep per-operation state should override this to key on
+    // the interned ID rather than hashing the name on every span.
+    virtual SamplingStatus isSampled(const TraceID& id,
+                                     const OperationName& operation)
+    {
+        return isSampled(id, operation.str());
+    }
+
     virtual void close() = 0;
 
     virtual Type type() const = 0;
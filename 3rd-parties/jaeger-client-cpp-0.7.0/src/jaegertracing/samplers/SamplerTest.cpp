@@ -249,6 +249,42 @@ TEST(Sampler, testAdaptiveSampler)
     CMP_TAGS(testProbablisticExpectedTags, result.tags());
 }
 
+TEST(Sampler, testAdaptiveSamplerInternedOperation)
+{
+    namespace thriftgen = sampling_manager::thrift;
+
+    thriftgen::OperationSamplingStrategy strategy;
+    strategy.__set_operation(kTestOperationName);
+    thriftgen::ProbabilisticSamplingStrategy probabilisticSampling;
+    probabilisticSampling.__set_samplingRate(kTestDefaultSamplingProbability);
+    strategy.__set_probabilisticSampling(probabilisticSampling);
+
+    thriftgen::PerOperationSamplingStrategies strategies;
+    strategies.__set_defaultSamplingProbability(
+        kTestDefaultSamplingProbability);
+    strategies.__set_defaultLowerBoundTracesPerSecond(1.0);
+    strategies.__set_perOperationStrategies({ strategy });
+
+    AdaptiveSampler sampler(strategies, kTestDefaultMaxOperations);
+    const OperationName operationName(kTestOperationName);
+    ASSERT_TRUE(operationName.isInterned());
+    auto result = sampler.isSampled(TraceID(0, kTestMaxID + 10), operationName);
+    ASSERT_TRUE(result.isSampled());
+    CMP_TAGS(testLowerBoundExpectedTags, result.tags());
+
+    // The interned and string lookups must share the same per-operation
+    // sampler, so the lower bound credit is already spent here.
+    result = sampler.isSampled(TraceID(0, kTestMaxID + 10), kTestOperationName);
+    ASSERT_FALSE(result.isSampled());
+    result = sampler.isSampled(TraceID(0, kTestMaxID + 10), operationName);
+    ASSERT_FALSE(result.isSampled());
+
+    result = sampler.isSampled(TraceID(0, kTestMaxID - 20),
+                               OperationName(kTestFirstTimeOperationName));
+    ASSERT_TRUE(result.isSampled());
+    CMP_TAGS(testProbablisticExpectedTags, result.tags());
+}
+
 TEST(Sampler, testAdaptiveSamplerErrors)
 {
     namespace thriftgen = sampling_manager::thrift;
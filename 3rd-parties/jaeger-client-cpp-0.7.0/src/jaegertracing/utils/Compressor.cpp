@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/Compressor.h"
+
+#include <stdexcept>
+
+#include "jaegertracing/Constants.h"
+
+#ifdef JAEGERTRACING_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace jaegertracing {
+namespace utils {
+
+Compression parseCompression(const std::string& name)
+{
+    if (name == "gzip") {
+        return Compression::kGzip;
+    }
+    if (name == "deflate") {
+        return Compression::kDeflate;
+    }
+    return Compression::kNone;
+}
+
+#ifdef JAEGERTRACING_WITH_ZLIB
+
+struct Compressor::Stream {
+    z_stream _zstream;
+};
+
+bool Compressor::isAvailable() { return true; }
+
+Compressor::Compressor(Compression compression)
+    : _compression(compression)
+    , _stream(new Stream())
+{
+    if (_compression == Compression::kNone) {
+        throw std::invalid_argument("No compression format given");
+    }
+    // Window bits above 15 select the gzip wrapper instead of zlib's.
+    constexpr auto kWindowBits = 15;
+    constexpr auto kGzipWindowBits = kWindowBits + 16;
+    constexpr auto kMemLevel = 8;
+    const auto returnCode = ::deflateInit2(
+        &_stream->_zstream,
+        Z_DEFAULT_COMPRESSION,
+        Z_DEFLATED,
+        (_compression == Compression::kGzip) ? kGzipWindowBits : kWindowBits,
+        kMemLevel,
+        Z_DEFAULT_STRATEGY);
+    if (returnCode != Z_OK) {
+        throw std::runtime_error("Failed to initialize zlib");
+    }
+}
+
+Compressor::~Compressor() { ::deflateEnd(&_stream->_zstream); }
+
+void Compressor::compress(const char* data, size_t size, std::string& output)
+{
+    auto& zstream = _stream->_zstream;
+    ::deflateReset(&zstream);
+    output.resize(::deflateBound(&zstream, size));
+    zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zstream.avail_in = static_cast<uInt>(size);
+    zstream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    zstream.avail_out = static_cast<uInt>(output.size());
+    // The output buffer holds the bound for the whole input, so a single
+    // call finishes the stream.
+    if (::deflate(&zstream, Z_FINISH) != Z_STREAM_END) {
+        throw std::runtime_error("Failed to compress data");
+    }
+    output.resize(zstream.total_out);
+}
+
+#else
+
+struct Compressor::Stream {
+};
+
+bool Compressor::isAvailable() { return false; }
+
+Compressor::Compressor(Compression compression)
+    : _compression(compression)
+    , _stream()
+{
+    throw std::logic_error("jaegertracing was built without zlib");
+}
+
+Compressor::~Compressor() = default;
+
+void Compressor::compress(const char* data, size_t size, std::string& output)
+{
+}
+
+#endif  // JAEGERTRACING_WITH_ZLIB
+
+const char* Compressor::contentEncoding() const
+{
+    return (_compression == Compression::kGzip) ? "gzip" : "deflate";
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
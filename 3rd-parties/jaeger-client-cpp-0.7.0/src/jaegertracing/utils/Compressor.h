@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_UTILS_COMPRESSOR_H
+#define JAEGERTRACING_UTILS_COMPRESSOR_H
+
+#include <memory>
+#include <string>
+
+namespace jaegertracing {
+namespace utils {
+
+enum class Compression { kNone, kGzip, kDeflate };
+
+// Parses "gzip" or "deflate", anything else means no compression.
+Compression parseCompression(const std::string& name);
+
+// Compresses request bodies with zlib. The zlib stream is reset rather than
+// reallocated between bodies.
+class Compressor {
+  public:
+    // False if the library was built without zlib.
+    static bool isAvailable();
+
+    // Throws std::invalid_argument for Compression::kNone and
+    // std::logic_error if zlib is not available.
+    explicit Compressor(Compression compression);
+
+    ~Compressor();
+
+    // Replaces the contents of `output` with the compressed data.
+    void compress(const char* data, size_t size, std::string& output);
+
+    // Value of the HTTP Content-Encoding header.
+    const char* contentEncoding() const;
+
+  private:
+    struct Stream;
+
+    Compression _compression;
+    std::unique_ptr<Stream> _stream;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_COMPRESSOR_H
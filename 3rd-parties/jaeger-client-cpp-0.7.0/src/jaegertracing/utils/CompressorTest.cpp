@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/Compressor.h"
+
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "jaegertracing/Constants.h"
+
+#ifdef JAEGERTRACING_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+#ifdef JAEGERTRACING_WITH_ZLIB
+std::string decompress(const std::string& data)
+{
+    z_stream zstream = {};
+    // Adding 32 to the window bits detects the gzip and zlib wrappers.
+    EXPECT_EQ(Z_OK, ::inflateInit2(&zstream, 15 + 32));
+    std::string output(64 * 1024, '\0');
+    zstream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zstream.avail_in = static_cast<uInt>(data.size());
+    zstream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    zstream.avail_out = static_cast<uInt>(output.size());
+    EXPECT_EQ(Z_STREAM_END, ::inflate(&zstream, Z_FINISH));
+    output.resize(zstream.total_out);
+    ::inflateEnd(&zstream);
+    return output;
+}
+#endif  // JAEGERTRACING_WITH_ZLIB
+
+}  // anonymous namespace
+
+TEST(Compressor, testParseCompression)
+{
+    ASSERT_EQ(Compression::kGzip, parseCompression("gzip"));
+    ASSERT_EQ(Compression::kDeflate, parseCompression("deflate"));
+    ASSERT_EQ(Compression::kNone, parseCompression(""));
+    ASSERT_EQ(Compression::kNone, parseCompression("zstd"));
+}
+
+#ifdef JAEGERTRACING_WITH_ZLIB
+
+TEST(Compressor, testRoundTrip)
+{
+    std::string data;
+    for (auto i = 0; i < 1000; ++i) {
+        data += "span-" + std::to_string(i % 10);
+    }
+
+    std::string output;
+    for (auto compression : { Compression::kGzip, Compression::kDeflate }) {
+        Compressor compressor(compression);
+        // The stream is reused, so compress twice.
+        for (auto i = 0; i < 2; ++i) {
+            compressor.compress(data.data(), data.size(), output);
+            ASSERT_LT(output.size(), data.size());
+            ASSERT_EQ(data, decompress(output));
+        }
+    }
+    ASSERT_EQ(std::string("gzip"),
+              Compressor(Compression::kGzip).contentEncoding());
+    ASSERT_EQ(std::string("deflate"),
+              Compressor(Compression::kDeflate).contentEncoding());
+    ASSERT_THROW(Compressor(Compression::kNone), std::invalid_argument);
+}
+
+#else
+
+TEST(Compressor, testUnavailable)
+{
+    ASSERT_FALSE(Compressor::isAvailable());
+    ASSERT_THROW(Compressor(Compression::kGzip), std::logic_error);
+}
+
+#endif  // JAEGERTRACING_WITH_ZLIB
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/CrashBuffer.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+constexpr int kSignals[] = { SIGTERM, SIGINT,  SIGABRT, SIGSEGV,
+                             SIGBUS,  SIGFPE,  SIGILL };
+constexpr auto kNumSignals = sizeof(kSignals) / sizeof(kSignals[0]);
+
+// Read from signal handlers, so only lock-free atomics and plain data.
+std::atomic<CrashBuffer*> installedBuffer(nullptr);
+std::atomic<int> installedFD(-1);
+struct sigaction previousActions[kNumSignals];
+bool handlersInstalled = false;
+std::mutex installMutex;
+
+// Lets the handler run after a stack overflow. Not derived from SIGSTKSZ,
+// which is no longer a constant on newer C libraries.
+constexpr size_t kAlternateStackSize = 64 * 1024;
+alignas(16) char alternateStack[kAlternateStackSize];
+bool alternateStackInstalled = false;
+
+bool writeAll(int fd, const char* data, size_t size) noexcept
+{
+    while (size > 0) {
+        const auto written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void restorePreviousAction(int signal) noexcept
+{
+    for (size_t i = 0; i < kNumSignals; ++i) {
+        if (kSignals[i] == signal) {
+            ::sigaction(signal, &previousActions[i], nullptr);
+        }
+    }
+}
+
+void handleSignal(int signal)
+{
+    const auto savedErrno = errno;
+    // Exchanged so the buffer is written once even if several threads
+    // crash at the same time.
+    auto* buffer = installedBuffer.exchange(nullptr);
+    if (buffer) {
+        buffer->writeTo(installedFD.load());
+    }
+    restorePreviousAction(signal);
+    errno = savedErrno;
+    // Delivered with the previous action once this handler returns.
+    ::raise(signal);
+}
+
+// Installs the alternate stack on the calling thread unless it already has
+// one. Signal stacks are per thread and this one can only serve a single
+// thread, so it is installed once per process.
+void installAlternateStack() noexcept
+{
+    if (alternateStackInstalled) {
+        return;
+    }
+    stack_t current;
+    if (::sigaltstack(nullptr, &current) == 0 &&
+        (current.ss_flags & SS_DISABLE) == 0) {
+        return;
+    }
+    stack_t stack;
+    std::memset(&stack, 0, sizeof(stack));
+    stack.ss_sp = alternateStack;
+    stack.ss_size = kAlternateStackSize;
+    alternateStackInstalled = (::sigaltstack(&stack, nullptr) == 0);
+}
+
+void restoreAllActions()
+{
+    for (size_t i = 0; i < kNumSignals; ++i) {
+        ::sigaction(kSignals[i], &previousActions[i], nullptr);
+    }
+    handlersInstalled = false;
+}
+
+}  // anonymous namespace
+
+constexpr int CrashBuffer::kNoSlot;
+constexpr size_t CrashBuffer::kRecordHeaderSize;
+constexpr uint32_t CrashBuffer::kFree;
+constexpr uint32_t CrashBuffer::kWriting;
+constexpr uint32_t CrashBuffer::kReady;
+
+CrashBuffer::CrashBuffer(size_t numSlots, size_t slotSize)
+    : _numSlots(numSlots)
+    , _slotSize(slotSize)
+    , _data()
+    , _states()
+    , _header()
+    , _headerState(kFree)
+    , _next(0)
+{
+    if (numSlots == 0 || slotSize <= kRecordHeaderSize) {
+        throw std::invalid_argument("Crash buffer needs non-empty slots");
+    }
+    // Zero-filled so the pages are committed before any crash.
+    _data.reset(new char[numSlots * slotSize]());
+    _header.reset(new char[slotSize]());
+    _states.reset(new std::atomic<uint32_t>[numSlots]);
+    for (size_t i = 0; i < numSlots; ++i) {
+        _states[i].store(kFree, std::memory_order_relaxed);
+    }
+}
+
+CrashBuffer::~CrashBuffer() { uninstall(*this); }
+
+bool CrashBuffer::setHeader(const char* data, size_t size) noexcept
+{
+    if (size == 0 || kRecordHeaderSize + size > _slotSize) {
+        return false;
+    }
+    auto expected = kFree;
+    if (!_headerState.compare_exchange_strong(
+            expected, kWriting, std::memory_order_acquire)) {
+        return expected == kReady;
+    }
+    const auto length = static_cast<uint32_t>(size);
+    std::memcpy(_header.get(), &length, sizeof(length));
+    std::memcpy(_header.get() + kRecordHeaderSize, data, size);
+    _headerState.store(kReady, std::memory_order_release);
+    return true;
+}
+
+int CrashBuffer::store(const char* data, size_t size) noexcept
+{
+    if (size == 0 || kRecordHeaderSize + size > _slotSize ||
+        size > std::numeric_limits<uint32_t>::max()) {
+        return kNoSlot;
+    }
+    for (size_t i = 0; i < _numSlots; ++i) {
+        const auto index =
+            _next.fetch_add(1, std::memory_order_relaxed) % _numSlots;
+        auto expected = kFree;
+        if (!_states[index].compare_exchange_strong(
+                expected, kWriting, std::memory_order_acquire)) {
+            continue;
+        }
+        auto* record = slot(index);
+        const auto length = static_cast<uint32_t>(size);
+        std::memcpy(record, &length, sizeof(length));
+        std::memcpy(record + kRecordHeaderSize, data, size);
+        _states[index].store(kReady, std::memory_order_release);
+        return static_cast<int>(index);
+    }
+    return kNoSlot;
+}
+
+void CrashBuffer::release(int slot) noexcept
+{
+    if (slot >= 0 && static_cast<size_t>(slot) < _numSlots) {
+        _states[slot].store(kFree, std::memory_order_release);
+    }
+}
+
+void CrashBuffer::clear() noexcept
+{
+    for (size_t i = 0; i < _numSlots; ++i) {
+        _states[i].store(kFree, std::memory_order_release);
+    }
+}
+
+size_t CrashBuffer::writeTo(int fd) const noexcept
+{
+    // A slot reused during the dump may hold a torn length, so never read
+    // past the slot and skip lengths no `store` could have written.
+    const auto maxLength = _slotSize - kRecordHeaderSize;
+    size_t numWritten = 0;
+    const auto writeRecord = [fd, maxLength, &numWritten](const char* record) {
+        uint32_t length = 0;
+        std::memcpy(&length, record, sizeof(length));
+        if (length == 0 || length > maxLength) {
+            return true;
+        }
+        if (!writeAll(fd, record, kRecordHeaderSize + length)) {
+            return false;
+        }
+        ++numWritten;
+        return true;
+    };
+
+    if (hasHeader() && !writeRecord(_header.get())) {
+        return numWritten;
+    }
+    for (size_t i = 0; i < _numSlots; ++i) {
+        if (_states[i].load(std::memory_order_acquire) != kReady) {
+            continue;
+        }
+        if (!writeRecord(slot(i))) {
+            break;
+        }
+    }
+    return numWritten;
+}
+
+void CrashBuffer::install(CrashBuffer& buffer, int fd)
+{
+    std::lock_guard<std::mutex> lock(installMutex);
+    installedFD.store(fd);
+    installedBuffer.store(&buffer);
+    if (handlersInstalled) {
+        return;
+    }
+    installAlternateStack();
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &handleSignal;
+    action.sa_flags = SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (size_t i = 0; i < kNumSignals; ++i) {
+        ::sigaction(kSignals[i], &action, &previousActions[i]);
+    }
+    handlersInstalled = true;
+}
+
+void CrashBuffer::uninstall(CrashBuffer& buffer)
+{
+    std::lock_guard<std::mutex> lock(installMutex);
+    auto* expected = &buffer;
+    if (installedBuffer.compare_exchange_strong(expected, nullptr) &&
+        handlersInstalled) {
+        restoreAllActions();
+    }
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
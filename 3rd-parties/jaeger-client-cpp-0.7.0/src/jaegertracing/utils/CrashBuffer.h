@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_UTILS_CRASHBUFFER_H
+#define JAEGERTRACING_UTILS_CRASHBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace jaegertracing {
+namespace utils {
+
+// Preallocated slots of pre-serialized records that can be written to a
+// file descriptor from a signal handler. Every slot holds a native-endian
+// uint32_t length followed by the record, the same layout SpoolFile uses,
+// so one write() emits a whole record. The optional header record is
+// written first. Slots are claimed and published with lock-free atomics,
+// so `store` and `release` may be called from any thread. A slot released
+// and reused while a dump is in progress may be written torn, so readers
+// should skip records that do not decode. POSIX only.
+class CrashBuffer {
+  public:
+    static constexpr int kNoSlot = -1;
+
+    static constexpr size_t kRecordHeaderSize = sizeof(uint32_t);
+
+    // `slotSize` bounds each record, including its length prefix.
+    CrashBuffer(size_t numSlots, size_t slotSize);
+
+    ~CrashBuffer();
+
+    CrashBuffer(const CrashBuffer&) = delete;
+
+    CrashBuffer& operator=(const CrashBuffer&) = delete;
+
+    // Sets the record written before all others. Only the first call
+    // takes effect. Returns false if the record does not fit in a slot.
+    bool setHeader(const char* data, size_t size) noexcept;
+
+    bool hasHeader() const
+    {
+        return _headerState.load(std::memory_order_acquire) == kReady;
+    }
+
+    // Copies the record into a free slot and returns its index, or
+    // `kNoSlot` if it is empty, too large or every slot is in use.
+    int store(const char* data, size_t size) noexcept;
+
+    void release(int slot) noexcept;
+
+    // Releases every slot, keeping the header.
+    void clear() noexcept;
+
+    size_t numSlots() const { return _numSlots; }
+
+    size_t slotSize() const { return _slotSize; }
+
+    // Writes the header and every stored record to `fd` and returns the
+    // number of records written. Records whose length is zero or does not
+    // fit in a slot are torn and skipped. Async-signal-safe.
+    size_t writeTo(int fd) const noexcept;
+
+    // Installs handlers for SIGTERM, SIGINT, SIGABRT, SIGSEGV, SIGBUS,
+    // SIGFPE and SIGILL that write `buffer` to `fd` once and then re-raise
+    // the signal with the previously installed action. Only one buffer is
+    // installed per process; installing another replaces it. The handlers
+    // run on an alternate signal stack so that a stack overflow is still
+    // dumped. That stack is set up for the first thread to call `install`
+    // unless it already has one; other threads keep their own stacks.
+    static void install(CrashBuffer& buffer, int fd);
+
+    // Restores the previous handlers if `buffer` is the installed one.
+    static void uninstall(CrashBuffer& buffer);
+
+  private:
+    static constexpr uint32_t kFree = 0;
+    static constexpr uint32_t kWriting = 1;
+    static constexpr uint32_t kReady = 2;
+
+    char* slot(size_t index) const { return _data.get() + index * _slotSize; }
+
+    size_t _numSlots;
+    size_t _slotSize;
+    std::unique_ptr<char[]> _data;
+    std::unique_ptr<std::atomic<uint32_t>[]> _states;
+    std::unique_ptr<char[]> _header;
+    std::atomic<uint32_t> _headerState;
+    std::atomic<size_t> _next;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_CRASHBUFFER_H
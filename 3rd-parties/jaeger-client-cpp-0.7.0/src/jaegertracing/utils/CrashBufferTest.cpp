@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/CrashBuffer.h"
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+std::vector<std::string> readRecords(int fd)
+{
+    std::string bytes;
+    char chunk[256];
+    auto numRead = ::read(fd, chunk, sizeof(chunk));
+    while (numRead > 0) {
+        bytes.append(chunk, numRead);
+        numRead = ::read(fd, chunk, sizeof(chunk));
+    }
+
+    std::vector<std::string> records;
+    size_t offset = 0;
+    while (offset + CrashBuffer::kRecordHeaderSize <= bytes.size()) {
+        uint32_t length = 0;
+        std::memcpy(&length, &bytes[offset], sizeof(length));
+        offset += CrashBuffer::kRecordHeaderSize;
+        records.push_back(bytes.substr(offset, length));
+        offset += length;
+    }
+    return records;
+}
+
+int overflowStack(int depth)
+{
+    if (depth == std::numeric_limits<int>::max()) {
+        return 0;
+    }
+    volatile char frame[1024];
+    frame[0] = static_cast<char>(depth);
+    // Used after the call so the recursion is not turned into a loop.
+    return overflowStack(depth + 1) + frame[0];
+}
+
+}  // anonymous namespace
+
+TEST(CrashBuffer, testStoreAndRelease)
+{
+    CrashBuffer buffer(2, 16);
+    ASSERT_EQ(CrashBuffer::kNoSlot, buffer.store("", 0));
+    ASSERT_EQ(CrashBuffer::kNoSlot,
+              buffer.store("0123456789abcdef", 16));
+    const auto first = buffer.store("a", 1);
+    const auto second = buffer.store("bc", 2);
+    ASSERT_NE(CrashBuffer::kNoSlot, first);
+    ASSERT_NE(CrashBuffer::kNoSlot, second);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(CrashBuffer::kNoSlot, buffer.store("d", 1));
+    buffer.release(first);
+    ASSERT_EQ(first, buffer.store("d", 1));
+}
+
+TEST(CrashBuffer, testWriteTo)
+{
+    CrashBuffer buffer(4, 32);
+    ASSERT_TRUE(buffer.setHeader("process", 7));
+    buffer.store("span-1", 6);
+    buffer.release(buffer.store("sent", 4));
+    buffer.store("span-2", 6);
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+    ASSERT_EQ(3, buffer.writeTo(fds[1]));
+    ::close(fds[1]);
+    const auto records = readRecords(fds[0]);
+    ::close(fds[0]);
+    ASSERT_EQ((std::vector<std::string>{ "process", "span-1", "span-2" }),
+              records);
+}
+
+TEST(CrashBuffer, testSignalHandler)
+{
+    char path[] = "/tmp/jaeger-crash-XXXXXX";
+    const auto fd = ::mkstemp(path);
+    ASSERT_LE(0, fd);
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        CrashBuffer buffer(4, 32);
+        buffer.setHeader("process", 7);
+        buffer.store("pending", 7);
+        CrashBuffer::install(buffer, fd);
+        ::raise(SIGTERM);
+        std::_Exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFSIGNALED(status));
+    ASSERT_EQ(SIGTERM, WTERMSIG(status));
+
+    ::lseek(fd, 0, SEEK_SET);
+    const auto records = readRecords(fd);
+    ::close(fd);
+    ::unlink(path);
+    ASSERT_EQ((std::vector<std::string>{ "process", "pending" }), records);
+}
+
+TEST(CrashBuffer, testStackOverflow)
+{
+    char path[] = "/tmp/jaeger-crash-XXXXXX";
+    const auto fd = ::mkstemp(path);
+    ASSERT_LE(0, fd);
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        CrashBuffer buffer(4, 32);
+        buffer.store("pending", 7);
+        CrashBuffer::install(buffer, fd);
+        std::_Exit(overflowStack(0));
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFSIGNALED(status));
+
+    ::lseek(fd, 0, SEEK_SET);
+    const auto records = readRecords(fd);
+    ::close(fd);
+    ::unlink(path);
+    ASSERT_EQ((std::vector<std::string>{ "pending" }), records);
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/EncodingCache.h"
+
+#include <utility>
+
+namespace jaegertracing {
+namespace utils {
+
+constexpr size_t EncodingCache::kDefaultMaxSize;
+
+EncodingCache::EncodingCache(size_t maxSize)
+    : _maxSize(maxSize)
+    , _entries()
+{
+}
+
+void EncodingCache::insert(uint64_t key, std::string bytes)
+{
+    if (_entries.size() >= _maxSize) {
+        return;
+    }
+    _entries.emplace(key, std::move(bytes));
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
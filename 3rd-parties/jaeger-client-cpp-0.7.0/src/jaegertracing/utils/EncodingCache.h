@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_UTILS_ENCODINGCACHE_H
+#define JAEGERTRACING_UTILS_ENCODINGCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace jaegertracing {
+namespace utils {
+
+// Bounded map from a caller-chosen 64-bit key to bytes a ThriftWriter
+// produced earlier. Encoders that can name a value by key, such as an
+// interned tag by its pool IDs, append the cached bytes instead of
+// serializing the value again. Compact protocol bytes are reusable because
+// every struct restarts its field ID deltas. Not thread-safe: a cache
+// belongs to a single writer.
+class EncodingCache {
+  public:
+    static constexpr size_t kDefaultMaxSize = 4096;
+
+    explicit EncodingCache(size_t maxSize = kDefaultMaxSize);
+
+    // Returns the cached bytes for `key`, or nullptr if there are none.
+    const std::string* find(uint64_t key) const
+    {
+        auto itr = _entries.find(key);
+        return itr == std::end(_entries) ? nullptr : &itr->second;
+    }
+
+    // Stores `bytes` under `key` unless `maxSize` entries are cached already.
+    void insert(uint64_t key, std::string bytes);
+
+    void clear() { _entries.clear(); }
+
+    size_t size() const { return _entries.size(); }
+
+    size_t maxSize() const { return _maxSize; }
+
+  private:
+    size_t _maxSize;
+    std::unordered_map<uint64_t, std::string> _entries;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_ENCODINGCACHE_H
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/EncodingCache.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace jaegertracing {
+namespace utils {
+
+TEST(EncodingCache, testFindAndInsert)
+{
+    EncodingCache cache;
+    ASSERT_EQ(nullptr, cache.find(1));
+    cache.insert(1, "abc");
+    const auto* bytes = cache.find(1);
+    ASSERT_NE(nullptr, bytes);
+    ASSERT_EQ("abc", *bytes);
+    cache.clear();
+    ASSERT_EQ(nullptr, cache.find(1));
+}
+
+TEST(EncodingCache, testMaxSize)
+{
+    EncodingCache cache(1);
+    cache.insert(1, "a");
+    cache.insert(2, "b");
+    ASSERT_EQ(1, cache.size());
+    ASSERT_EQ(nullptr, cache.find(2));
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
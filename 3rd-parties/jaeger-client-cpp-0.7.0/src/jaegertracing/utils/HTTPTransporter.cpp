@@ -15,18 +15,56 @@
  */
 
 #include "jaegertracing/utils/HTTPTransporter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
 #include <thrift/protocol/TBinaryProtocol.h>
 #include <thrift/protocol/TProtocol.h>
 
 namespace jaegertracing {
 namespace utils {
+namespace {
+
+#ifdef MSG_NOSIGNAL
+// A collector closing the connection must not raise SIGPIPE.
+constexpr auto kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr auto kSendFlags = 0;
+#endif
 
-HTTPTransporter::HTTPTransporter(const net::URI& endpoint, int maxPacketSize)
+constexpr auto kReadSize = 4096;
+constexpr auto kMaxHeaderSize = 64 * 1024;
+
+bool equalsIgnoreCase(const char* first,
+                      const char* last,
+                      const std::string& name)
+{
+    return static_cast<size_t>(last - first) == name.size() &&
+           std::equal(first, last, name.begin(), [](char lhs, char rhs) {
+               return std::tolower(static_cast<unsigned char>(lhs)) == rhs;
+           });
+}
+
+}  // anonymous namespace
+
+HTTPTransporter::HTTPTransporter(const net::URI& endpoint,
+                                 int maxPacketSize,
+                                 Compression compression)
     : Transport(maxPacketSize == 0 ? kHttpPacketMaxLength : maxPacketSize)
     , _buffer(new apache::thrift::transport::TMemoryBuffer(_maxPacketSize))
     , _serverAddr(net::IPAddress::v4(endpoint._host, endpoint._port))
-    , _httpClient(new ::apache::thrift::transport::THttpClient(
-        _buffer, endpoint._host, endpoint._path + "?format=jaeger.thrift"))
+    , _host(endpoint._host)
+    , _target(endpoint._path + "?format=jaeger.thrift")
+    , _request()
+    , _protocol()
+    , _response()
+    , _compressed()
+    , _compressor(compression == Compression::kNone
+                      ? nullptr
+                      : new Compressor(compression))
+    , _connected(false)
 {
     using TProtocolFactory = apache::thrift::protocol::TProtocolFactory;
     using TBinaryProtocolFactory =
@@ -34,9 +72,186 @@ HTTPTransporter::HTTPTransporter(const net::URI& endpoint, int maxPacketSize)
 
     _socket.open(AF_INET, SOCK_STREAM);
     _socket.connect(_serverAddr);
+    _connected = true;
     std::shared_ptr<TProtocolFactory> protocolFactory(
         new TBinaryProtocolFactory());
-    _protocol = protocolFactory->getProtocol(_httpClient);
+    _protocol = protocolFactory->getProtocol(_buffer);
+}
+
+HTTPTransporter::~HTTPTransporter() { close(); }
+
+void HTTPTransporter::emitEncodedBatch(const char* data, size_t size)
+{
+    if (_compressor) {
+        _compressor->compress(data, size, _compressed);
+        data = _compressed.data();
+        size = _compressed.size();
+    }
+
+    // Reuses the request buffer, so only the header is formatted here
+    _request.clear();
+    _request += "POST ";
+    _request += _target;
+    _request += " HTTP/1.1\r\nHost: ";
+    _request += _host;
+    _request += "\r\nContent-Type: application/x-thrift\r\n";
+    if (_compressor) {
+        _request += "Content-Encoding: ";
+        _request += _compressor->contentEncoding();
+        _request += "\r\n";
+    }
+    _request += "Content-Length: ";
+    _request += std::to_string(size);
+    _request += "\r\nAccept: application/x-thrift\r\n\r\n";
+    _request.append(data, size);
+
+    send(_request.data(), _request.size());
+}
+
+void HTTPTransporter::connect()
+{
+    _socket.close();
+    _socket.open(AF_INET, SOCK_STREAM);
+    try {
+        _socket.connect(_serverAddr);
+    } catch (const std::runtime_error& ex) {
+        const auto error = errno;
+        _socket.close();
+        throw std::system_error(error, std::system_category(), ex.what());
+    }
+    _connected = true;
+}
+
+void HTTPTransporter::send(const char* data, size_t size)
+{
+    // The collector may have closed an idle connection, so a failure on a
+    // reused connection is retried once on a new one.
+    const auto reused = _connected;
+    auto statusCode = 0;
+    try {
+        if (!_connected) {
+            connect();
+        }
+        write(data, size);
+        statusCode = readResponse();
+    } catch (const std::system_error&) {
+        _socket.close();
+        _connected = false;
+        if (!reused) {
+            throw;
+        }
+        connect();
+        write(data, size);
+        statusCode = readResponse();
+    }
+
+    // Check that the server acknowledged and returned a green status
+    // [200, 201, 202, 203, 204]
+    if (statusCode < 200 || statusCode > 204) {
+        std::ostringstream oss;
+        oss << "Failed to write message, HTTP error " << statusCode;
+        if (statusCode >= 400 && statusCode < 500) {
+            throw StatusError(oss.str(), statusCode);
+        }
+        throw std::system_error(
+            std::make_error_code(std::errc::io_error), oss.str());
+    }
+}
+
+void HTTPTransporter::write(const char* data, size_t size)
+{
+    while (size > 0) {
+        const auto numWritten =
+            ::send(_socket.handle(), data, size, kSendFlags);
+        if (numWritten <= 0) {
+            std::ostringstream oss;
+            oss << "Failed to write message, numWritten=" << numWritten
+                << ", size=" << size;
+            throw std::system_error(errno, std::system_category(), oss.str());
+        }
+        data += numWritten;
+        size -= numWritten;
+    }
+}
+
+int HTTPTransporter::readResponse()
+{
+    _response.clear();
+    auto headerEnd = std::string::npos;
+    while ((headerEnd = _response.find("\r\n\r\n")) == std::string::npos) {
+        if (_response.size() > kMaxHeaderSize) {
+            throw std::system_error(std::make_error_code(std::errc::io_error),
+                                    "HTTP response header too large");
+        }
+        readSome();
+    }
+
+    // Status line, e.g. "HTTP/1.1 202 Accepted".
+    const auto statusStart = _response.find(' ');
+    const auto statusCode =
+        (statusStart < headerEnd)
+            ? std::atoi(_response.c_str() + statusStart + 1)
+            : 0;
+
+    // Only the headers framing the body and the connection matter here.
+    auto contentLength = static_cast<size_t>(0);
+    auto hasContentLength = false;
+    auto keepAlive = true;
+    for (auto lineStart = _response.find("\r\n") + 2; lineStart < headerEnd;) {
+        const auto lineEnd = _response.find("\r\n", lineStart);
+        const auto colon = _response.find(':', lineStart);
+        if (colon < lineEnd) {
+            const auto* key = &_response[lineStart];
+            const auto* keyEnd = &_response[colon];
+            auto valueStart = colon + 1;
+            while (valueStart < lineEnd && _response[valueStart] == ' ') {
+                ++valueStart;
+            }
+            const auto* value = &_response[valueStart];
+            const auto* valueEnd = &_response[lineEnd];
+            if (equalsIgnoreCase(key, keyEnd, "content-length")) {
+                contentLength = std::strtoul(value, nullptr, 10);
+                hasContentLength = true;
+            }
+            else if (equalsIgnoreCase(key, keyEnd, "connection") &&
+                     equalsIgnoreCase(value, valueEnd, "close")) {
+                keepAlive = false;
+            }
+        }
+        lineStart = lineEnd + 2;
+    }
+
+    // Without a length the body ends when the server closes the connection,
+    // which cannot be told apart from a later failure, so start over.
+    if (hasContentLength) {
+        const auto responseSize = headerEnd + 4 + contentLength;
+        while (_response.size() < responseSize) {
+            readSome();
+        }
+    }
+    else {
+        keepAlive = false;
+    }
+
+    if (!keepAlive) {
+        _socket.close();
+        _connected = false;
+    }
+    return statusCode;
+}
+
+void HTTPTransporter::readSome()
+{
+    const auto offset = _response.size();
+    _response.resize(offset + kReadSize);
+    const auto numRead =
+        ::recv(_socket.handle(), &_response[offset], kReadSize, 0);
+    _response.resize(offset + std::max<decltype(numRead)>(numRead, 0));
+    if (numRead <= 0) {
+        throw std::system_error((numRead == 0) ? ECONNRESET : errno,
+                                std::system_category(),
+                                "Failed to read HTTP response");
+    }
 }
 
 }  // namespace utils
@@ -24,58 +24,75 @@
 
 #include "jaegertracing/Compilers.h"
 
+#include "jaegertracing/utils/Compressor.h"
 #include "jaegertracing/utils/Transport.h"
 
 #include "jaegertracing/net/IPAddress.h"
 #include "jaegertracing/net/Socket.h"
-#include "jaegertracing/net/http/Response.h"
 
 #include <thrift/protocol/TBinaryProtocol.h>
 #include <thrift/transport/TBufferTransports.h>
-#include <thrift/transport/THttpClient.h>
 
 namespace jaegertracing {
 namespace utils {
 
 class HTTPTransporter : public Transport {
   public:
-    HTTPTransporter(const net::URI& endpoint, int maxPacketSize);
+    // Thrown when the collector rejects a batch with a 4xx status. Unlike the
+    // std::system_error thrown for connection failures and other statuses,
+    // sending the same batch again cannot succeed.
+    class StatusError : public std::runtime_error {
+      public:
+        StatusError(const std::string& what, int statusCode)
+            : std::runtime_error(what)
+            , _statusCode(statusCode)
+        {
+        }
+
+        int statusCode() const { return _statusCode; }
+
+      private:
+        int _statusCode;
+    };
+
+    // The connection is kept open between batches and reopened when the
+    // collector closes it. Batch bodies are compressed unless `compression`
+    // is Compression::kNone.
+    HTTPTransporter(const net::URI& endpoint,
+                    int maxPacketSize,
+                    Compression compression = Compression::kNone);
 
-    ~HTTPTransporter() { close(); }
+    ~HTTPTransporter();
 
     void emitBatch(const thrift::Batch& batch) override
     {
         // Resets the buffer to write a new batch
         _buffer->resetBuffer();
 
-        // Does the serialisation to Thrift
-        auto oprot = _protocol.get();
-        batch.write(oprot);
-        oprot->writeMessageEnd();
-        oprot->getTransport()->writeEnd();
-        oprot->getTransport()->flush();
+        // Does the serialisation to Thrift. The HTTP framing is added by
+        // emitEncodedBatch so both paths share the connection and encoding.
+        batch.write(_protocol.get());
 
         uint8_t* data = nullptr;
         uint32_t size = 0;
         _buffer->getBuffer(&data, &size);
 
-        // Sends the HTTP message
-        const auto numWritten = ::send(_socket.handle(), reinterpret_cast<char*>(data), sizeof(uint8_t) * size, 0);
+        emitEncodedBatch(reinterpret_cast<const char*>(data), size);
+    }
 
-        if (static_cast<unsigned>(numWritten) != size) {
-            std::ostringstream oss;
-            oss << "Failed to write message, numWritten=" << numWritten << ", size=" << size;
-            throw std::system_error(errno, std::system_category(), oss.str());
-        }
+    void emitEncodedBatch(const char* data, size_t size) override;
 
-        // Waits for response. Check that the server acknowledged
-        // and returned a green status [200, 201, 202, 203, 204]
-        net::http::Response response = net::http::read(_socket);
-        if (response.statusCode() < 200 && response.statusCode() > 204) {
-          std::ostringstream oss;
-          oss << "Failed to write message, HTTP error " << response.statusCode() << response.reason();
-          throw std::system_error(errno, std::system_category(), oss.str());
-        }
+    // The parent keeps its connection; closing the child's descriptor does
+    // not shut it down.
+    void resetAfterFork() override
+    {
+        _socket.close();
+        _connected = false;
+    }
+
+    ThriftWriter::Protocol encodedProtocol() const override
+    {
+        return ThriftWriter::Protocol::kBinary;
     }
 
     std::unique_ptr<apache::thrift::protocol::TProtocolFactory>
@@ -86,10 +103,26 @@ class HTTPTransporter : public Transport {
     }
 
   private:
+    void connect();
+
+    void send(const char* data, size_t size);
+
+    void write(const char* data, size_t size);
+
+    int readResponse();
+
+    void readSome();
+
     std::shared_ptr<apache::thrift::transport::TMemoryBuffer> _buffer;
     net::IPAddress _serverAddr;
-    std::shared_ptr<::apache::thrift::transport::THttpClient> _httpClient;
+    std::string _host;
+    std::string _target;
+    std::string _request;
     std::shared_ptr<apache::thrift::protocol::TProtocol> _protocol;
+    std::string _response;
+    std::string _compressed;
+    std::unique_ptr<Compressor> _compressor;
+    bool _connected;
 
     static constexpr auto kHttpPacketMaxLength = 1024 * 1024; // 1MB
 };
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/net/IPAddress.h"
+#include "jaegertracing/net/Socket.h"
+#include "jaegertracing/net/URI.h"
+#include "jaegertracing/utils/HTTPTransporter.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+// Stand-in for the collector on the loopback interface. It accepts one
+// connection at a time and acknowledges every request, so the benchmarks
+// measure the client side of the exchange.
+class LocalCollector {
+  public:
+    static const LocalCollector& instance()
+    {
+        static const LocalCollector collector;
+        return collector;
+    }
+
+    const net::URI& uri() const { return _uri; }
+
+  private:
+    LocalCollector()
+        : _socket()
+        , _uri()
+    {
+        _socket.open(AF_INET, SOCK_STREAM);
+        _socket.bind(net::IPAddress::v4("127.0.0.1", 0));
+        ::sockaddr_storage addrStorage;
+        ::socklen_t addrLen = sizeof(addrStorage);
+        ::getsockname(_socket.handle(),
+                      reinterpret_cast<::sockaddr*>(&addrStorage),
+                      &addrLen);
+        _socket.listen();
+
+        std::ostringstream oss;
+        oss << "http://127.0.0.1:"
+            << net::IPAddress(addrStorage, addrLen).port() << "/api/traces";
+        _uri = net::URI::parse(oss.str());
+
+        std::thread(&LocalCollector::serve, this).detach();
+    }
+
+    void serve()
+    {
+        for (;;) {
+            auto clientSocket = _socket.accept();
+            std::string buffer;
+            while (readRequest(clientSocket, buffer)) {
+                ::send(clientSocket.handle(),
+                       kResponse.data(),
+                       kResponse.size(),
+                       0);
+            }
+        }
+    }
+
+    static bool readRequest(net::Socket& socket, std::string& buffer)
+    {
+        static const std::string kHeaderEnd("\r\n\r\n");
+        static const std::string kContentLength("Content-Length: ");
+        auto end = std::string::npos;
+        while ((end = buffer.find(kHeaderEnd)) == std::string::npos) {
+            if (!readSome(socket, buffer)) {
+                return false;
+            }
+        }
+        const auto lengthPos = buffer.find(kContentLength);
+        const auto size =
+            end + kHeaderEnd.size() +
+            std::stoul(buffer.substr(lengthPos + kContentLength.size()));
+        while (buffer.size() < size) {
+            if (!readSome(socket, buffer)) {
+                return false;
+            }
+        }
+        buffer.erase(0, size);
+        return true;
+    }
+
+    static bool readSome(net::Socket& socket, std::string& buffer)
+    {
+        char chunk[64 * 1024];
+        const auto numRead = ::recv(socket.handle(), chunk, sizeof(chunk), 0);
+        if (numRead <= 0) {
+            return false;
+        }
+        buffer.append(chunk, numRead);
+        return true;
+    }
+
+    static const std::string kResponse;
+
+    net::Socket _socket;
+    net::URI _uri;
+};
+
+const std::string LocalCollector::kResponse(
+    "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n");
+
+// Encoded spans repeat service, operation and tag names, which is what
+// makes batches compress well.
+std::string makeBatch(size_t size)
+{
+    std::string batch;
+    for (auto i = 0; batch.size() < size; ++i) {
+        batch += "service|operation-";
+        batch += std::to_string(i % 16);
+        batch += "|http.status_code|200|span.kind|server|";
+        batch += std::to_string(i);
+    }
+    batch.resize(size);
+    return batch;
+}
+
+void BM_HTTPTransporterKeepAlive(benchmark::State& state)
+{
+    const auto batch = makeBatch(state.range(0));
+    HTTPTransporter transporter(LocalCollector::instance().uri(), 0);
+    for (auto _ : state) {
+        transporter.emitEncodedBatch(batch.data(), batch.size());
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_HTTPTransporterKeepAlive)->Arg(4 * 1024)->Arg(64 * 1024);
+
+// A connection per batch, as the transporter did before keep-alive.
+void BM_HTTPTransporterConnectionPerBatch(benchmark::State& state)
+{
+    const auto batch = makeBatch(state.range(0));
+    for (auto _ : state) {
+        HTTPTransporter transporter(LocalCollector::instance().uri(), 0);
+        transporter.emitEncodedBatch(batch.data(), batch.size());
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_HTTPTransporterConnectionPerBatch)->Arg(4 * 1024)->Arg(64 * 1024);
+
+void BM_HTTPTransporterGzip(benchmark::State& state)
+{
+    if (!Compressor::isAvailable()) {
+        state.SkipWithError("Built without zlib");
+        return;
+    }
+    const auto batch = makeBatch(state.range(0));
+    HTTPTransporter transporter(
+        LocalCollector::instance().uri(), 0, Compression::kGzip);
+    for (auto _ : state) {
+        transporter.emitEncodedBatch(batch.data(), batch.size());
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_HTTPTransporterGzip)->Arg(4 * 1024)->Arg(64 * 1024);
+
+}  // anonymous namespace
+}  // namespace utils
+}  // namespace jaegertracing
@@ -15,6 +15,8 @@
  */
 
 #include "jaegertracing/net/IPAddress.h"
+#include "jaegertracing/utils/HTTPTransporter.h"
+#include "jaegertracing/utils/SpoolingTransport.h"
 #include "jaegertracing/testutils/TracerUtil.h"
 #include <gtest/gtest.h>
 #include <iterator>
@@ -24,6 +26,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "jaegertracing/net/Socket.h"
 #include "jaegertracing/net/http/Request.h"
@@ -31,9 +34,60 @@
 #include <future>
 #include <thread>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
 namespace jaegertracing {
 
 namespace utils {
+namespace {
+
+// Reads one request from a persistent connection, leaving any bytes of the
+// next request in `buffer`.
+std::string readRequest(net::Socket& socket, std::string& buffer)
+{
+    const std::string headerEnd("\r\n\r\n");
+    const std::string contentLength("Content-Length: ");
+    char chunk[4096];
+    auto end = std::string::npos;
+    while ((end = buffer.find(headerEnd)) == std::string::npos) {
+        const auto numRead = ::recv(socket.handle(), chunk, sizeof(chunk), 0);
+        if (numRead <= 0) {
+            return std::string();
+        }
+        buffer.append(chunk, numRead);
+    }
+    const auto lengthPos = buffer.find(contentLength);
+    const auto size = end + headerEnd.size() +
+                      std::stoul(buffer.substr(lengthPos + contentLength.size()));
+    while (buffer.size() < size) {
+        const auto numRead = ::recv(socket.handle(), chunk, sizeof(chunk), 0);
+        if (numRead <= 0) {
+            return std::string();
+        }
+        buffer.append(chunk, numRead);
+    }
+    const auto request = buffer.substr(0, size);
+    buffer.erase(0, size);
+    return request;
+}
+
+net::Socket listenLocal(net::IPAddress& serverAddr)
+{
+    net::Socket socket;
+    socket.open(AF_INET, SOCK_STREAM);
+    socket.bind(net::IPAddress::v4("127.0.0.1", 0));
+    ::sockaddr_storage addrStorage;
+    ::socklen_t addrLen = sizeof(addrStorage);
+    ::getsockname(socket.handle(),
+                  reinterpret_cast<::sockaddr*>(&addrStorage),
+                  &addrLen);
+    serverAddr = net::IPAddress(addrStorage, addrLen);
+    socket.listen();
+    return socket;
+}
+
+}  // anonymous namespace
 
 TEST(HTTPTransporter, testSpanReporting)
 {
@@ -109,5 +163,161 @@ TEST(HTTPTransporter, testSpanReporting)
     ASSERT_EQ(std::string("application/x-thrift"), acceptType);
 }
 
+TEST(HTTPTransporter, testKeepAlive)
+{
+    net::IPAddress serverAddr;
+    auto socket = listenLocal(serverAddr);
+
+    std::vector<std::string> requests;
+    auto numAccepted = 0;
+    std::thread serverThread([&socket, &requests, &numAccepted]() {
+        const std::string answer(
+            "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n");
+        // The second connection only exists if the first one was closed.
+        while (requests.size() < 3) {
+            auto clientSocket = socket.accept();
+            ++numAccepted;
+            std::string buffer;
+            while (requests.size() < 3) {
+                const auto request = readRequest(clientSocket, buffer);
+                if (request.empty()) {
+                    break;
+                }
+                requests.push_back(request);
+                if (requests.size() == 2) {
+                    // Simulates the collector dropping an idle connection.
+                    const std::string closing(
+                        "HTTP/1.1 200 OK\r\nConnection: close\r\n"
+                        "Content-Length: 0\r\n\r\n");
+                    ::send(clientSocket.handle(),
+                           closing.c_str(),
+                           closing.size(),
+                           0);
+                    break;
+                }
+                ::send(clientSocket.handle(), answer.c_str(), answer.size(), 0);
+            }
+        }
+    });
+
+    std::ostringstream oss;
+    oss << "http://127.0.0.1:" << serverAddr.port() << "/api/traces";
+    HTTPTransporter transporter(net::URI::parse(oss.str()), 0);
+    const std::string batch("batch");
+    for (auto i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(
+            transporter.emitEncodedBatch(batch.data(), batch.size()));
+    }
+    serverThread.join();
+
+    ASSERT_EQ(3, static_cast<int>(requests.size()));
+    ASSERT_EQ(2, numAccepted);
+    for (auto&& request : requests) {
+        ASSERT_EQ(0, request.find("POST /api/traces?format=jaeger.thrift "));
+        ASSERT_EQ(batch, request.substr(request.size() - batch.size()));
+    }
+}
+
+TEST(HTTPTransporter, testRejectedBatchNotSpooled)
+{
+    net::IPAddress serverAddr;
+    auto socket = listenLocal(serverAddr);
+
+    std::thread serverThread([&socket]() {
+        const std::string answers[] = {
+            "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n",
+            "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n"
+        };
+        auto clientSocket = socket.accept();
+        std::string buffer;
+        for (auto&& answer : answers) {
+            if (readRequest(clientSocket, buffer).empty()) {
+                return;
+            }
+            ::send(clientSocket.handle(), answer.c_str(), answer.size(), 0);
+        }
+    });
+
+    std::string path("/tmp/jaegertracing-spool-XXXXXX");
+    ::close(::mkstemp(&path[0]));
+    std::ostringstream oss;
+    oss << "http://127.0.0.1:" << serverAddr.port() << "/api/traces";
+    SpoolingTransport transport(
+        std::unique_ptr<Transport>(
+            new HTTPTransporter(net::URI::parse(oss.str()), 0)),
+        path,
+        1024,
+        std::chrono::hours(1));
+    const std::string batch("batch");
+
+    // A rejected batch is dropped, an unavailable collector is retried.
+    ASSERT_THROW(transport.emitEncodedBatch(batch.data(), batch.size()),
+                 HTTPTransporter::StatusError);
+    ASSERT_EQ(0, static_cast<int>(transport.numSpooled()));
+    ASSERT_NO_THROW(transport.emitEncodedBatch(batch.data(), batch.size()));
+    ASSERT_EQ(1, static_cast<int>(transport.numSpooled()));
+    serverThread.join();
+    ::unlink(path.c_str());
+}
+
+TEST(HTTPTransporter, testResetAfterFork)
+{
+    net::IPAddress serverAddr;
+    auto socket = listenLocal(serverAddr);
+
+    std::vector<std::string> requests;
+    std::thread serverThread([&socket, &requests]() {
+        const std::string answer(
+            "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n");
+        const auto serve = [&requests, &answer](net::Socket& clientSocket,
+                                                std::string& buffer) {
+            requests.push_back(readRequest(clientSocket, buffer));
+            ::send(clientSocket.handle(), answer.c_str(), answer.size(), 0);
+        };
+        auto parentSocket = socket.accept();
+        std::string parentBuffer;
+        serve(parentSocket, parentBuffer);
+        // The child must not write to the parent's connection.
+        auto childSocket = socket.accept();
+        std::string childBuffer;
+        serve(childSocket, childBuffer);
+        serve(parentSocket, parentBuffer);
+    });
+
+    std::ostringstream oss;
+    oss << "http://127.0.0.1:" << serverAddr.port() << "/api/traces";
+    HTTPTransporter transporter(net::URI::parse(oss.str()), 0);
+    const std::string batch("batch");
+    ASSERT_NO_THROW(transporter.emitEncodedBatch(batch.data(), batch.size()));
+
+    transporter.prepareFork();
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        transporter.childAfterFork();
+        transporter.resetAfterFork();
+        try {
+            transporter.emitEncodedBatch(batch.data(), batch.size());
+        } catch (...) {
+            std::_Exit(1);
+        }
+        std::_Exit(0);
+    }
+    transporter.parentAfterFork();
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    // The parent's connection is still open.
+    ASSERT_NO_THROW(transporter.emitEncodedBatch(batch.data(), batch.size()));
+    serverThread.join();
+
+    ASSERT_EQ(3, static_cast<int>(requests.size()));
+    for (auto&& request : requests) {
+        ASSERT_EQ(batch, request.substr(request.size() - batch.size()));
+    }
+}
+
 }  // namespace utils
 }  // namespace jaegertracing
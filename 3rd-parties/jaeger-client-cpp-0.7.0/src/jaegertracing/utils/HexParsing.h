@@ -18,20 +18,29 @@
 #define JAEGERTRACING_UTILS_HEXPARSING_H
 
 #include <cassert>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
-#include <cctype>
+#include <string>
+
+#include <opentracing/string_view.h>
 
 namespace jaegertracing {
 namespace utils {
 namespace HexParsing {
 
-inline bool isHex(char ch)
+// Value of each hex digit indexed by character, -1 for anything else.
+extern const int8_t kHexDigitValues[256];
+
+extern const char kHexDigits[16];
+
+inline int hexDigitValue(char ch)
 {
-    return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F') ||
-           (ch >= 'a' && ch <= 'f');
+    return kHexDigitValues[static_cast<unsigned char>(ch)];
 }
 
+inline bool isHex(char ch) { return hexDigitValue(ch) >= 0; }
+
 inline std::string readSegment(std::istream& in, size_t maxChars, char delim)
 {
     std::string buffer;
@@ -52,33 +61,82 @@ inline std::string readSegment(std::istream& in, size_t maxChars, char delim)
     return buffer;
 }
 
+// Reads a segment of a string held in memory without copying it. Returns a
+// view of the leading hex digits of `str`, or an empty view if a character
+// that is neither hex nor `delim` comes first.
+inline opentracing::string_view
+readSegment(opentracing::string_view str, size_t maxChars, char delim)
+{
+    auto length = static_cast<size_t>(0);
+    for (; length < maxChars && length < str.size(); ++length) {
+        const auto ch = str[length];
+        if (!isHex(ch)) {
+            if (ch == delim) {
+                break;
+            }
+            return opentracing::string_view();
+        }
+    }
+    return opentracing::string_view(str.data(), length);
+}
+
 template <typename ResultType>
-ResultType decodeHex(const std::string& str)
+ResultType decodeHex(opentracing::string_view str)
 {
-    auto first = std::begin(str);
-    auto last = std::end(str);
     ResultType result = 0;
-    for (; first != last; ++first) {
-        const auto ch = *first;
-
+    for (auto&& ch : str) {
         // This condition is guaranteed by `readSegment`.
         assert(isHex(ch));
+        result = (result << 4) | hexDigitValue(ch);
+    }
 
-        auto hexDigit = 0;
-        if (std::isdigit(ch)) {
-            hexDigit = (ch - '0');
-        }
-        else if (std::isupper(ch)) {
-            hexDigit = (ch - 'A') + 10;
-        }
-        else {
-            hexDigit = (ch - 'a') + 10;
-        }
+    return result;
+}
 
-        result = (result << 4) | hexDigit;
+// Fixed-width fast path for exactly 16 digits, the width of a padded span
+// ID or half of a padded trace ID. Validates while decoding, so no
+// `readSegment` pass is needed. Returns false if any character is not hex.
+inline bool decodeHex16(const char* str, uint64_t& result)
+{
+    constexpr auto kNumChars = 16;
+    auto value = static_cast<uint64_t>(0);
+    auto invalid = 0;
+    for (auto i = 0; i < kNumChars; ++i) {
+        const auto digit = hexDigitValue(str[i]);
+        // Invalid digits are negative, so this keeps the sign bit set.
+        invalid |= digit;
+        value = (value << 4) | static_cast<uint64_t>(digit & 0xf);
     }
+    result = value;
+    return invalid >= 0;
+}
 
-    return result;
+// Writes `value` as exactly 16 lowercase hex digits, zero padded, and
+// returns the end of the written range, like std::to_chars.
+inline char* encodeHex16(uint64_t value, char* first)
+{
+    constexpr auto kNumChars = 16;
+    for (auto i = kNumChars - 1; i >= 0; --i) {
+        first[i] = kHexDigits[value & 0xf];
+        value >>= 4;
+    }
+    return first + kNumChars;
+}
+
+// Writes `value` as lowercase hex digits without padding ("0" for zero) and
+// returns the end of the written range. `first` must have room for 16
+// characters.
+inline char* encodeHex(uint64_t value, char* first)
+{
+    auto numChars = 1;
+    for (auto rest = value >> 4; rest != 0; rest >>= 4) {
+        ++numChars;
+    }
+    for (auto i = numChars - 1; i >= 0; --i) {
+        first[i] = kHexDigits[value & 0xf];
+        value >>= 4;
+    }
+    return first + numChars;
 }
 
 }  // namespace HexParsing
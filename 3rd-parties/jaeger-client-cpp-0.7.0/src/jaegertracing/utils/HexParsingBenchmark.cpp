@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/SpanContext.h"
+#include "jaegertracing/TraceID.h"
+#include <benchmark/benchmark.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace jaegertracing {
+namespace {
+
+const std::string kSpanContextString =
+    "0123456789abcdef0123456789abcdef:0123456789abcdef:fedcba9876543210:1";
+
+const SpanContext kSpanContext(TraceID(0x0123456789abcdef, 0x0123456789abcdef),
+                               0x0123456789abcdef,
+                               0xfedcba9876543210,
+                               1,
+                               SpanContext::StrMap());
+
+void BM_SpanContextFromStream(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::istringstream iss(kSpanContextString);
+        benchmark::DoNotOptimize(SpanContext::fromStream(iss));
+    }
+}
+BENCHMARK(BM_SpanContextFromStream);
+
+void BM_SpanContextFromString(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SpanContext::fromString(kSpanContextString));
+    }
+}
+BENCHMARK(BM_SpanContextFromString);
+
+// Formatting as it was done before toChars, through stream manipulators.
+void BM_SpanContextPrintManipulators(benchmark::State& state)
+{
+    const auto& ctx = kSpanContext;
+    for (auto _ : state) {
+        std::ostringstream oss;
+        oss << std::setw(16) << std::setfill('0') << std::hex
+            << ctx.traceID().high() << std::setw(16) << std::setfill('0')
+            << std::hex << ctx.traceID().low() << ':' << std::setw(16)
+            << std::setfill('0') << std::hex << ctx.spanID() << ':'
+            << std::setw(16) << std::setfill('0') << std::hex
+            << ctx.parentID() << ':' << std::hex
+            << static_cast<size_t>(ctx.flags());
+        benchmark::DoNotOptimize(oss.str());
+    }
+}
+BENCHMARK(BM_SpanContextPrintManipulators);
+
+void BM_SpanContextToChars(benchmark::State& state)
+{
+    char buffer[SpanContext::kMaxStringLength];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kSpanContext.toChars(buffer));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SpanContextToChars);
+
+}  // anonymous namespace
+}  // namespace jaegertracing
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/HexParsing.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace jaegertracing {
+namespace utils {
+
+TEST(HexParsing, testDecodeHex)
+{
+    ASSERT_EQ(0xabcdefu, HexParsing::decodeHex<uint64_t>("aBcDeF"));
+    ASSERT_EQ(0x1fu, HexParsing::decodeHex<unsigned char>("1f"));
+    ASSERT_FALSE(HexParsing::isHex('g'));
+    ASSERT_FALSE(HexParsing::isHex('\xff'));
+
+    uint64_t value = 0;
+    ASSERT_TRUE(HexParsing::decodeHex16("0123456789ABCDEF", value));
+    ASSERT_EQ(0x0123456789abcdefu, value);
+    ASSERT_FALSE(HexParsing::decodeHex16("0123456789abcdeg", value));
+    ASSERT_FALSE(HexParsing::decodeHex16("01234567:9abcdef", value));
+}
+
+TEST(HexParsing, testReadSegment)
+{
+    ASSERT_EQ("abc", std::string(HexParsing::readSegment("abc:1", 16, ':')));
+    ASSERT_EQ("ab", std::string(HexParsing::readSegment("abc:1", 2, ':')));
+    ASSERT_TRUE(HexParsing::readSegment("abx:1", 16, ':').empty());
+}
+
+TEST(HexParsing, testEncodeHex)
+{
+    char buffer[16];
+    ASSERT_EQ(buffer + 16, HexParsing::encodeHex16(0xabcdefu, buffer));
+    ASSERT_EQ("0000000000abcdef", std::string(buffer, 16));
+
+    ASSERT_EQ(buffer + 1, HexParsing::encodeHex(0, buffer));
+    ASSERT_EQ('0', buffer[0]);
+    auto last = HexParsing::encodeHex(0x1f, buffer);
+    ASSERT_EQ("1f", std::string(buffer, last));
+    last = HexParsing::encodeHex(UINT64_MAX, buffer);
+    ASSERT_EQ("ffffffffffffffff", std::string(buffer, last));
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
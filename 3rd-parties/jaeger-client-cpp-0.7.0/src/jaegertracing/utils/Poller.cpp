@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/Poller.h"
+
+#include <algorithm>
+
+#include <pthread.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+// Pollers whose threads must be restarted after fork(). Leaked so the atfork
+// handlers never see it destroyed.
+struct PollerRegistry {
+    std::mutex _mutex;
+    std::vector<Poller*> _pollers;
+    std::once_flag _handlersInstalled;
+};
+
+PollerRegistry& pollerRegistry()
+{
+    static auto* registry = new PollerRegistry();
+    return *registry;
+}
+
+}  // anonymous namespace
+
+constexpr double Poller::kDefaultJitter;
+
+Poller& Poller::shared()
+{
+    static auto* poller = new Poller();
+    return *poller;
+}
+
+Poller::Poller(double jitter)
+    : _jitter(jitter)
+    , _entries()
+    , _nextID(1)
+    , _runningID(0)
+    , _threadActive(false)
+    , _forked(false)
+    , _random(std::random_device()())
+    , _mutex()
+    , _cv()
+    , _thread()
+{
+    auto& registry = pollerRegistry();
+    std::lock_guard<std::mutex> lock(registry._mutex);
+    std::call_once(registry._handlersInstalled, []() {
+        ::pthread_atfork(&prepareFork, &parentAfterFork, &childAfterFork);
+    });
+    registry._pollers.push_back(this);
+}
+
+Poller::~Poller()
+{
+    {
+        auto& registry = pollerRegistry();
+        std::lock_guard<std::mutex> lock(registry._mutex);
+        registry._pollers.erase(std::remove(std::begin(registry._pollers),
+                                            std::end(registry._pollers),
+                                            this),
+                                std::end(registry._pollers));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+    _cv.notify_all();
+    if (_thread) {
+        _thread->join();
+    }
+}
+
+Poller::TaskID Poller::add(const Clock::duration& interval, const Task& task)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto id = _nextID++;
+    _entries.push_back(Entry{ id, interval, Clock::now(), task });
+    _forked = false;
+    if (_threadActive) {
+        _cv.notify_all();
+        return id;
+    }
+    startThread();
+    return id;
+}
+
+void Poller::remove(TaskID id)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _entries.erase(std::remove_if(std::begin(_entries),
+                                  std::end(_entries),
+                                  [id](const Entry& entry) {
+                                      return entry._id == id;
+                                  }),
+                   std::end(_entries));
+    _cv.notify_all();
+    _cv.wait(lock, [this, id]() { return _runningID != id; });
+}
+
+size_t Poller::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+void Poller::prepareFork()
+{
+    auto& registry = pollerRegistry();
+    registry._mutex.lock();
+    for (auto* poller : registry._pollers) {
+        poller->_mutex.lock();
+    }
+}
+
+void Poller::parentAfterFork()
+{
+    auto& registry = pollerRegistry();
+    for (auto* poller : registry._pollers) {
+        poller->_mutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void Poller::childAfterFork()
+{
+    auto& registry = pollerRegistry();
+    for (auto* poller : registry._pollers) {
+        // The thread was not copied into the child, so its std::thread can
+        // be neither joined nor destroyed and is leaked. A task it was
+        // running is abandoned.
+        poller->_thread.release();
+        poller->_threadActive = false;
+        poller->_runningID = 0;
+        poller->_forked = true;
+        poller->_mutex.unlock();
+    }
+    registry._mutex.unlock();
+}
+
+void Poller::restartAfterFork() noexcept
+{
+    try {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_forked.exchange(false)) {
+            startThread();
+        }
+    } catch (...) {
+        // Retried by the next add().
+    }
+}
+
+void Poller::startThread()
+{
+    if (_threadActive || _entries.empty()) {
+        return;
+    }
+    // The previous thread exited when its last task was removed.
+    if (_thread && _thread->joinable()) {
+        _thread->join();
+    }
+    _thread.reset(new std::thread([this]() { run(); }));
+    _threadActive = true;
+}
+
+Poller::Clock::duration Poller::jittered(const Clock::duration& interval)
+{
+    std::uniform_real_distribution<double> distribution(-_jitter, _jitter);
+    return std::chrono::duration_cast<Clock::duration>(
+        interval * (1 + distribution(_random)));
+}
+
+void Poller::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_entries.empty()) {
+        const auto next = std::min_element(
+            std::begin(_entries),
+            std::end(_entries),
+            [](const Entry& lhs, const Entry& rhs) {
+                return lhs._nextRun < rhs._nextRun;
+            });
+        if (next->_nextRun > Clock::now()) {
+            // Tasks may be added or removed while waiting, so start over.
+            // The deadline is copied because adding a task may reallocate
+            // the entries.
+            const auto nextRun = next->_nextRun;
+            _cv.wait_until(lock, nextRun);
+            continue;
+        }
+
+        const auto id = next->_id;
+        // Copied so the task survives being removed while it runs.
+        const auto task = next->_task;
+        _runningID = id;
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // Tasks report their own errors, a throw must not end the thread.
+        }
+        lock.lock();
+        _runningID = 0;
+
+        const auto itr = std::find_if(
+            std::begin(_entries), std::end(_entries), [id](const Entry& entry) {
+                return entry._id == id;
+            });
+        if (itr != std::end(_entries)) {
+            itr->_nextRun = Clock::now() + jittered(itr->_interval);
+        }
+        _cv.notify_all();
+    }
+    _threadActive = false;
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
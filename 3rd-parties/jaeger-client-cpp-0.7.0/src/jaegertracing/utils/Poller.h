@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef JAEGERTRACING_UTILS_POLLER_H
+#define JAEGERTRACING_UTILS_POLLER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "jaegertracing/Compilers.h"
+
+namespace jaegertracing {
+namespace utils {
+
+// Runs periodic tasks, such as fetching sampling strategies, on a single
+// thread. Each interval is stretched or shrunk by a random fraction so that
+// processes started together do not poll the agent in lockstep. The thread
+// only runs while there are tasks. In a child process it is started again by
+// the first add() or restartIfForked(), since fork() only copies the calling
+// thread.
+class Poller {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Task = std::function<void()>;
+    using TaskID = uint64_t;
+
+    static constexpr auto kDefaultJitter = 0.1;
+
+    // The poller shared by every tracer in the process. It is never
+    // destroyed, so tracers with static storage may remove their tasks at
+    // exit.
+    static Poller& shared();
+
+    explicit Poller(double jitter = kDefaultJitter);
+
+    ~Poller();
+
+    // Runs `task` as soon as possible and then every `interval`, give or
+    // take the jitter. Tasks run one at a time and must not throw.
+    TaskID add(const Clock::duration& interval, const Task& task);
+
+    // Once this returns the task is neither running nor scheduled. Must not
+    // be called from a task.
+    void remove(TaskID id);
+
+    size_t size() const;
+
+    // Cheap enough for hot paths of the poller's clients.
+    void restartIfForked()
+    {
+        if (_forked.load(std::memory_order_relaxed)) {
+            restartAfterFork();
+        }
+    }
+
+  private:
+    struct Entry {
+        TaskID _id;
+        Clock::duration _interval;
+        Clock::time_point _nextRun;
+        Task _task;
+    };
+
+    // pthread_atfork handlers. The child only marks the pollers.
+    static void prepareFork();
+
+    static void parentAfterFork();
+
+    static void childAfterFork();
+
+    void restartAfterFork() noexcept;
+
+    // Starts the thread unless it is running or there is nothing to run.
+    // Expects `_mutex` to be held.
+    void startThread();
+
+    Clock::duration jittered(const Clock::duration& interval);
+
+    void run();
+
+    double _jitter;
+    std::vector<Entry> _entries;
+    TaskID _nextID;
+    // Task the thread is running, zero between tasks.
+    TaskID _runningID;
+    bool _threadActive;
+    std::atomic<bool> _forked;
+    std::mt19937 _random;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::unique_ptr<std::thread> _thread;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_POLLER_H
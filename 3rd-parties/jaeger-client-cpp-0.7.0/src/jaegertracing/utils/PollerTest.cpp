@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "jaegertracing/utils/Poller.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+
+TEST(Poller, testTasksShareOneThread)
+{
+    Poller poller;
+    std::mutex mutex;
+    std::set<std::thread::id> threadIDs;
+    std::atomic<int> numRunsA(0);
+    std::atomic<int> numRunsB(0);
+    const auto record = [&mutex, &threadIDs](std::atomic<int>& numRuns) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threadIDs.insert(std::this_thread::get_id());
+        ++numRuns;
+    };
+
+    const auto idA = poller.add(std::chrono::milliseconds(5),
+                                [&record, &numRunsA]() { record(numRunsA); });
+    const auto idB = poller.add(std::chrono::milliseconds(5),
+                                [&record, &numRunsB]() { record(numRunsB); });
+    ASSERT_EQ(2, static_cast<int>(poller.size()));
+    for (auto i = 0; i < 200 && (numRunsA < 3 || numRunsB < 3); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    poller.remove(idA);
+    poller.remove(idB);
+    ASSERT_EQ(0, static_cast<int>(poller.size()));
+
+    ASSERT_LE(3, numRunsA.load());
+    ASSERT_LE(3, numRunsB.load());
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(1, static_cast<int>(threadIDs.size()));
+}
+
+TEST(Poller, testRemoveWaitsForRunningTask)
+{
+    Poller poller;
+    std::atomic<bool> started(false);
+    std::atomic<bool> finished(false);
+    const auto id =
+        poller.add(std::chrono::hours(1), [&started, &finished]() {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    poller.remove(id);
+    ASSERT_TRUE(finished);
+
+    // The thread exits once idle and restarts for the next task.
+    std::atomic<int> numRuns(0);
+    const auto nextID =
+        poller.add(std::chrono::hours(1), [&numRuns]() { ++numRuns; });
+    while (numRuns == 0) {
+        std::this_thread::yield();
+    }
+    poller.remove(nextID);
+    ASSERT_EQ(1, numRuns.load());
+}
+
+TEST(Poller, testRestartAfterFork)
+{
+    Poller poller;
+    std::atomic<int> numRuns(0);
+    const auto id =
+        poller.add(std::chrono::milliseconds(1), [&numRuns]() { ++numRuns; });
+    while (numRuns == 0) {
+        std::this_thread::yield();
+    }
+
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        // The parent's thread is gone, the child must poll with its own.
+        const auto numRunsAtFork = numRuns.load();
+        poller.restartIfForked();
+        for (auto i = 0; i < 1000 && numRuns == numRunsAtFork; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::_Exit(numRuns > numRunsAtFork ? 0 : 1);
+    }
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    poller.remove(id);
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/SpoolFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+
+// `_head` and `_tail` grow monotonically; the ring position of an offset is
+// the offset modulo the capacity.
+struct SpoolFile::Header {
+    uint32_t _magic;
+    uint32_t _version;
+    uint64_t _capacity;
+    uint64_t _head;
+    uint64_t _tail;
+    uint64_t _count;
+};
+
+constexpr uint32_t SpoolFile::kMagic;
+constexpr uint32_t SpoolFile::kVersion;
+constexpr size_t SpoolFile::kHeaderSize;
+constexpr size_t SpoolFile::kRecordHeaderSize;
+
+SpoolFile::SpoolFile(const std::string& path, size_t capacity)
+    : _fd(-1)
+    , _capacity(capacity)
+    , _mapping(nullptr)
+    , _data(nullptr)
+    , _numEvicted(0)
+    , _frontSequence(0)
+{
+    static_assert(sizeof(Header) <= kHeaderSize, "Spool header too large");
+    if (_capacity == 0) {
+        throw std::invalid_argument("Spool capacity must be positive");
+    }
+
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (_fd < 0) {
+        throw std::system_error(
+            errno, std::system_category(), "Failed to open spool " + path);
+    }
+
+    // Two writers would corrupt each other's records, e.g. a second
+    // process configured with the same path.
+    if (::flock(_fd, LOCK_EX | LOCK_NB) != 0) {
+        const auto error = errno;
+        ::close(_fd);
+        throw std::system_error(
+            error, std::system_category(), "Failed to lock spool " + path);
+    }
+
+    const auto fileSize = kHeaderSize + _capacity;
+    auto* mapping = MAP_FAILED;
+    if (::ftruncate(_fd, fileSize) == 0) {
+        mapping = ::mmap(
+            nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        const auto error = errno;
+        ::close(_fd);
+        throw std::system_error(
+            error, std::system_category(), "Failed to map spool " + path);
+    }
+    _mapping = static_cast<char*>(mapping);
+    _data = _mapping + kHeaderSize;
+
+    const auto& current = header();
+    const auto valid = current._magic == kMagic &&
+                       current._version == kVersion &&
+                       current._capacity == _capacity &&
+                       current._head <= current._tail &&
+                       current._tail - current._head <= _capacity;
+    if (!valid) {
+        reset();
+    }
+}
+
+SpoolFile::~SpoolFile()
+{
+    ::munmap(_mapping, kHeaderSize + _capacity);
+    ::close(_fd);
+}
+
+bool SpoolFile::push(const char* data, size_t size)
+{
+    const auto recordBytes = kRecordHeaderSize + size;
+    if (size > std::numeric_limits<uint32_t>::max() ||
+        recordBytes > _capacity) {
+        return false;
+    }
+
+    auto& current = header();
+    while (_capacity - usedBytes() < recordBytes) {
+        const auto evictedBytes = kRecordHeaderSize + recordSize(current._head);
+        if (evictedBytes > usedBytes()) {
+            reset();
+            break;
+        }
+        current._head += evictedBytes;
+        --current._count;
+        ++_numEvicted;
+        ++_frontSequence;
+    }
+
+    const auto length = static_cast<uint32_t>(size);
+    write(current._tail, reinterpret_cast<const char*>(&length), sizeof(length));
+    write(current._tail + kRecordHeaderSize, data, size);
+    // Publish the record only once its bytes are in place, so a process that
+    // dies mid-write leaves the previous contents intact.
+    std::atomic_signal_fence(std::memory_order_release);
+    current._tail += recordBytes;
+    ++current._count;
+    return true;
+}
+
+bool SpoolFile::front(std::string& record)
+{
+    if (empty()) {
+        return false;
+    }
+    const auto& current = header();
+    const auto size = recordSize(current._head);
+    if (kRecordHeaderSize + size > usedBytes()) {
+        // Corrupt length, nothing after it can be trusted.
+        reset();
+        return false;
+    }
+    record.resize(size);
+    read(current._head + kRecordHeaderSize, &record[0], size);
+    return true;
+}
+
+void SpoolFile::pop()
+{
+    if (empty()) {
+        return;
+    }
+    auto& current = header();
+    const auto recordBytes = kRecordHeaderSize + recordSize(current._head);
+    if (recordBytes > usedBytes()) {
+        reset();
+        return;
+    }
+    current._head += recordBytes;
+    --current._count;
+    ++_frontSequence;
+}
+
+size_t SpoolFile::size() const
+{
+    return static_cast<size_t>(header()._count);
+}
+
+size_t SpoolFile::usedBytes() const
+{
+    const auto& current = header();
+    return static_cast<size_t>(current._tail - current._head);
+}
+
+SpoolFile::Header& SpoolFile::header() const
+{
+    return *reinterpret_cast<Header*>(_mapping);
+}
+
+void SpoolFile::reset()
+{
+    auto& current = header();
+    ++_frontSequence;
+    current._magic = kMagic;
+    current._version = kVersion;
+    current._capacity = _capacity;
+    current._head = 0;
+    current._tail = 0;
+    current._count = 0;
+}
+
+void SpoolFile::read(uint64_t offset, char* data, size_t size) const
+{
+    const auto position = static_cast<size_t>(offset % _capacity);
+    const auto firstPart = std::min(size, _capacity - position);
+    std::memcpy(data, _data + position, firstPart);
+    std::memcpy(data + firstPart, _data, size - firstPart);
+}
+
+void SpoolFile::write(uint64_t offset, const char* data, size_t size)
+{
+    const auto position = static_cast<size_t>(offset % _capacity);
+    const auto firstPart = std::min(size, _capacity - position);
+    std::memcpy(_data + position, data, firstPart);
+    std::memcpy(_data, data + firstPart, size - firstPart);
+}
+
+uint32_t SpoolFile::recordSize(uint64_t offset) const
+{
+    uint32_t size = 0;
+    read(offset, reinterpret_cast<char*>(&size), sizeof(size));
+    return size;
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_UTILS_SPOOLFILE_H
+#define JAEGERTRACING_UTILS_SPOOLFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace jaegertracing {
+namespace utils {
+
+// Fixed-size ring of length-prefixed records in a memory-mapped file. When a
+// new record does not fit, the oldest records are discarded to make room.
+// Records survive process restarts: reopening the file with the same
+// capacity resumes where the previous process stopped, any other header is
+// reset. The file is locked for exclusive use while open. Not thread safe.
+// POSIX only.
+class SpoolFile {
+  public:
+    static constexpr uint32_t kMagic = 0x4A535046;  // "JSPF"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kRecordHeaderSize = sizeof(uint32_t);
+
+    // Throws std::invalid_argument for a zero capacity and
+    // std::system_error if the file cannot be created, locked or mapped.
+    SpoolFile(const std::string& path, size_t capacity);
+
+    ~SpoolFile();
+
+    SpoolFile(const SpoolFile&) = delete;
+
+    SpoolFile& operator=(const SpoolFile&) = delete;
+
+    // Returns false if the record is larger than the whole ring.
+    bool push(const char* data, size_t size);
+
+    // Copies the oldest record into `record`, returns false if empty.
+    bool front(std::string& record);
+
+    void pop();
+
+    // Identifies the oldest record: the value changes once that record is
+    // popped, evicted or discarded.
+    uint64_t frontSequence() const { return _frontSequence; }
+
+    bool empty() const { return size() == 0; }
+
+    size_t size() const;
+
+    size_t usedBytes() const;
+
+    size_t capacity() const { return _capacity; }
+
+    // Number of records discarded to make room since the file was opened.
+    size_t numEvicted() const { return _numEvicted; }
+
+  private:
+    struct Header;
+
+    Header& header() const;
+
+    void reset();
+
+    void read(uint64_t offset, char* data, size_t size) const;
+
+    void write(uint64_t offset, const char* data, size_t size);
+
+    uint32_t recordSize(uint64_t offset) const;
+
+    int _fd;
+    size_t _capacity;
+    char* _mapping;
+    char* _data;
+    size_t _numEvicted;
+    uint64_t _frontSequence;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_SPOOLFILE_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/SpoolFile.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+class TempFile {
+  public:
+    TempFile()
+        : _path("/tmp/jaegertracing-spool-XXXXXX")
+    {
+        ::close(::mkstemp(&_path[0]));
+    }
+
+    ~TempFile() { ::unlink(_path.c_str()); }
+
+    const std::string& path() const { return _path; }
+
+  private:
+    std::string _path;
+};
+
+}  // anonymous namespace
+
+TEST(SpoolFile, testPushPop)
+{
+    TempFile file;
+    SpoolFile spool(file.path(), 64);
+    ASSERT_TRUE(spool.empty());
+    std::string record;
+    ASSERT_FALSE(spool.front(record));
+
+    ASSERT_TRUE(spool.push("abc", 3));
+    ASSERT_TRUE(spool.push("defgh", 5));
+    ASSERT_EQ(2, static_cast<int>(spool.size()));
+    ASSERT_EQ(16, static_cast<int>(spool.usedBytes()));
+
+    ASSERT_TRUE(spool.front(record));
+    ASSERT_EQ("abc", record);
+    spool.pop();
+    ASSERT_TRUE(spool.front(record));
+    ASSERT_EQ("defgh", record);
+    spool.pop();
+    ASSERT_TRUE(spool.empty());
+}
+
+TEST(SpoolFile, testWrapAndEvict)
+{
+    TempFile file;
+    SpoolFile spool(file.path(), 32);
+    const std::string large(29, 'x');
+    ASSERT_FALSE(spool.push(large.data(), large.size()));
+
+    // Each record takes 14 bytes, so the third evicts the first and wraps
+    // around the end of the ring.
+    const std::string records[] = { std::string(10, 'a'),
+                                    std::string(10, 'b'),
+                                    std::string(10, 'c') };
+    for (auto&& record : records) {
+        ASSERT_TRUE(spool.push(record.data(), record.size()));
+    }
+    ASSERT_EQ(2, static_cast<int>(spool.size()));
+    ASSERT_EQ(1, static_cast<int>(spool.numEvicted()));
+
+    std::string record;
+    ASSERT_TRUE(spool.front(record));
+    ASSERT_EQ(records[1], record);
+    spool.pop();
+    ASSERT_TRUE(spool.front(record));
+    ASSERT_EQ(records[2], record);
+}
+
+TEST(SpoolFile, testReopen)
+{
+    TempFile file;
+    {
+        SpoolFile spool(file.path(), 64);
+        ASSERT_TRUE(spool.push("abc", 3));
+        ASSERT_TRUE(spool.push("def", 3));
+        spool.pop();
+    }
+    {
+        SpoolFile spool(file.path(), 64);
+        ASSERT_EQ(1, static_cast<int>(spool.size()));
+        std::string record;
+        ASSERT_TRUE(spool.front(record));
+        ASSERT_EQ("def", record);
+    }
+    {
+        // A different capacity cannot reuse the old layout.
+        SpoolFile spool(file.path(), 128);
+        ASSERT_TRUE(spool.empty());
+    }
+    ASSERT_THROW(SpoolFile(file.path(), 0), std::invalid_argument);
+    ASSERT_THROW(SpoolFile("/nonexistent/spool", 64), std::system_error);
+}
+
+TEST(SpoolFile, testExclusiveLock)
+{
+    TempFile file;
+    {
+        SpoolFile spool(file.path(), 64);
+        ASSERT_TRUE(spool.push("abc", 3));
+        ASSERT_THROW(SpoolFile(file.path(), 64), std::system_error);
+    }
+    SpoolFile spool(file.path(), 64);
+    ASSERT_EQ(1, static_cast<int>(spool.size()));
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
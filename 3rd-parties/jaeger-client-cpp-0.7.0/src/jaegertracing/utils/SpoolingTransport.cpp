@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/SpoolingTransport.h"
+
+#include <system_error>
+
+namespace jaegertracing {
+namespace utils {
+
+SpoolingTransport::SpoolingTransport(std::unique_ptr<Transport>&& transport,
+                                     const std::string& spoolPath,
+                                     size_t spoolSize,
+                                     const Clock::duration& drainInterval,
+                                     const Clock::duration& replayInterval)
+    : Transport(transport->maxPacketSize())
+    , _spool(new SpoolFile(spoolPath, spoolSize))
+    , _transport(std::move(transport))
+    , _drainInterval(drainInterval)
+    , _replayInterval(replayInterval)
+    , _record()
+    , _lastBatchDeferred(false)
+    , _running(true)
+    , _mutex()
+    , _sendMutex()
+    , _cv()
+    , _thread()
+{
+    _thread.reset(new std::thread([this]() { drain(); }));
+}
+
+SpoolingTransport::~SpoolingTransport()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _cv.notify_one();
+    if (_thread && _thread->joinable()) {
+        _thread->join();
+    }
+}
+
+void SpoolingTransport::emitEncodedBatch(const char* data, size_t size)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lastBatchDeferred = false;
+    if (!_spool) {
+        std::lock_guard<std::mutex> sendLock(_sendMutex);
+        _transport->emitEncodedBatch(data, size);
+        return;
+    }
+    // Queue behind batches waiting to be replayed so they stay in order.
+    if (!_spool->empty() && _spool->push(data, size)) {
+        _lastBatchDeferred = true;
+        return;
+    }
+    try {
+        std::lock_guard<std::mutex> sendLock(_sendMutex);
+        _transport->emitEncodedBatch(data, size);
+    } catch (const std::system_error&) {
+        if (!_spool->push(data, size)) {
+            throw;
+        }
+        _lastBatchDeferred = true;
+    }
+}
+
+void SpoolingTransport::prepareFork()
+{
+    // Waits for the drain thread to finish a replay.
+    _mutex.lock();
+    _sendMutex.lock();
+    _transport->prepareFork();
+}
+
+void SpoolingTransport::parentAfterFork()
+{
+    _transport->parentAfterFork();
+    _sendMutex.unlock();
+    _mutex.unlock();
+}
+
+void SpoolingTransport::childAfterFork()
+{
+    _transport->childAfterFork();
+    _sendMutex.unlock();
+    _mutex.unlock();
+}
+
+void SpoolingTransport::resetAfterFork()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The drain thread was not copied into the child, so it can be neither
+    // joined nor destroyed.
+    _thread.release();
+    // Unmaps and closes the child's copy only. The parent keeps its lock,
+    // which is released when its descriptor is closed.
+    _spool.reset();
+    _lastBatchDeferred = false;
+    std::lock_guard<std::mutex> sendLock(_sendMutex);
+    _transport->resetAfterFork();
+}
+
+void SpoolingTransport::drain() noexcept
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        _cv.wait_for(lock, _drainInterval, [this]() { return !_running; });
+        while (_running && _spool->front(_record)) {
+            // The record stays spooled while it is sent, so new batches keep
+            // queueing behind it and nothing is lost if the send fails.
+            const auto sequence = _spool->frontSequence();
+            lock.unlock();
+            const auto sent = replay();
+            lock.lock();
+            if (!sent) {
+                // Still unavailable, retry on the next interval.
+                break;
+            }
+            // Unless it was evicted to make room in the meantime.
+            if (_spool->frontSequence() == sequence) {
+                _spool->pop();
+            }
+            _cv.wait_for(
+                lock, _replayInterval, [this]() { return !_running; });
+        }
+    }
+}
+
+bool SpoolingTransport::replay() noexcept
+{
+    std::lock_guard<std::mutex> sendLock(_sendMutex);
+    try {
+        _transport->emitEncodedBatch(_record.data(), _record.size());
+    } catch (const std::system_error&) {
+        return false;
+    } catch (...) {
+        // The batch itself is rejected, so retrying cannot help.
+    }
+    return true;
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
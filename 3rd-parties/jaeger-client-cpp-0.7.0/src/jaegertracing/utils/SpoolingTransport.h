@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_UTILS_SPOOLINGTRANSPORT_H
+#define JAEGERTRACING_UTILS_SPOOLINGTRANSPORT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "jaegertracing/utils/SpoolFile.h"
+#include "jaegertracing/utils/Transport.h"
+
+namespace jaegertracing {
+namespace utils {
+
+// Wraps a transport and writes encoded batches to a spool file when the
+// transport fails with a system error, e.g. while the agent is down. A
+// background thread replays spooled batches in order once the transport
+// accepts them again, paced so a backlog does not overflow the agent's
+// receive buffer. Batches spooled by a previous process are replayed too.
+// A forked child does not spool; the spool file stays with the parent.
+class SpoolingTransport : public Transport {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static Clock::duration defaultDrainInterval()
+    {
+        return std::chrono::seconds(1);
+    }
+
+    static Clock::duration defaultReplayInterval()
+    {
+        return std::chrono::milliseconds(10);
+    }
+
+    // Throws if the spool file cannot be opened, leaving `transport` intact.
+    SpoolingTransport(std::unique_ptr<Transport>&& transport,
+                      const std::string& spoolPath,
+                      size_t spoolSize,
+                      const Clock::duration& drainInterval =
+                          defaultDrainInterval(),
+                      const Clock::duration& replayInterval =
+                          defaultReplayInterval());
+
+    ~SpoolingTransport();
+
+    void emitBatch(const thrift::Batch& batch) override
+    {
+        std::lock_guard<std::mutex> lock(_sendMutex);
+        _transport->emitBatch(batch);
+    }
+
+    void emitEncodedBatch(const char* data, size_t size) override;
+
+    bool lastBatchDeferred() const override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _lastBatchDeferred;
+    }
+
+    ThriftWriter::Protocol encodedProtocol() const override
+    {
+        return _transport->encodedProtocol();
+    }
+
+    void writeBatchPrefix(ThriftWriter& writer) const override
+    {
+        _transport->writeBatchPrefix(writer);
+    }
+
+    void writeBatchSuffix(ThriftWriter& writer) const override
+    {
+        _transport->writeBatchSuffix(writer);
+    }
+
+    std::unique_ptr<apache::thrift::protocol::TProtocolFactory>
+    protocolFactory() const override
+    {
+        return _transport->protocolFactory();
+    }
+
+    void prepareFork() override;
+
+    void parentAfterFork() override;
+
+    void childAfterFork() override;
+
+    void resetAfterFork() override;
+
+    size_t numSpooled() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _spool ? _spool->size() : 0;
+    }
+
+  private:
+    void drain() noexcept;
+
+    // Returns false if the transport is still unavailable.
+    bool replay() noexcept;
+
+    // Null in a forked child.
+    std::unique_ptr<SpoolFile> _spool;
+    std::unique_ptr<Transport> _transport;
+    Clock::duration _drainInterval;
+    Clock::duration _replayInterval;
+    // Only used by the drain thread.
+    std::string _record;
+    bool _lastBatchDeferred;
+    bool _running;
+    // Guards the spool. Never held while replaying, so reporting only waits
+    // on the network when it sends a batch itself.
+    mutable std::mutex _mutex;
+    // Serializes calls into `_transport`. Acquired after `_mutex`.
+    std::mutex _sendMutex;
+    std::condition_variable _cv;
+    std::unique_ptr<std::thread> _thread;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_SPOOLINGTRANSPORT_H
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/SpoolingTransport.h"
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+class FakeTransport : public Transport {
+  public:
+    FakeTransport(std::vector<std::string>& batches,
+                  bool& available,
+                  std::mutex& mutex)
+        : Transport(1024)
+        , _batches(batches)
+        , _available(available)
+        , _mutex(mutex)
+    {
+    }
+
+    void emitBatch(const thrift::Batch& batch) override {}
+
+    void emitEncodedBatch(const char* data, size_t size) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_available) {
+            throw std::system_error(
+                ECONNREFUSED, std::system_category(), "agent down");
+        }
+        _batches.emplace_back(data, size);
+    }
+
+    ThriftWriter::Protocol encodedProtocol() const override
+    {
+        return ThriftWriter::Protocol::kCompact;
+    }
+
+    std::unique_ptr<apache::thrift::protocol::TProtocolFactory>
+    protocolFactory() const override
+    {
+        return nullptr;
+    }
+
+  private:
+    std::vector<std::string>& _batches;
+    bool& _available;
+    std::mutex& _mutex;
+};
+
+// Blocks each send until released, to hold the drain thread mid-replay.
+class GatedTransport : public Transport {
+  public:
+    GatedTransport()
+        : Transport(1024)
+        , _available(false)
+        , _open(false)
+        , _numWaiting(0)
+        , _batches()
+        , _mutex()
+        , _cv()
+    {
+    }
+
+    void emitBatch(const thrift::Batch& batch) override {}
+
+    void emitEncodedBatch(const char* data, size_t size) override
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_available) {
+            throw std::system_error(
+                ECONNREFUSED, std::system_category(), "agent down");
+        }
+        ++_numWaiting;
+        _cv.notify_all();
+        _cv.wait(lock, [this]() { return _open; });
+        --_numWaiting;
+        _batches.emplace_back(data, size);
+    }
+
+    ThriftWriter::Protocol encodedProtocol() const override
+    {
+        return ThriftWriter::Protocol::kCompact;
+    }
+
+    std::unique_ptr<apache::thrift::protocol::TProtocolFactory>
+    protocolFactory() const override
+    {
+        return nullptr;
+    }
+
+    void setAvailable()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _available = true;
+    }
+
+    void waitForSend()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this]() { return _numWaiting > 0; });
+    }
+
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _open = true;
+        }
+        _cv.notify_all();
+    }
+
+    std::vector<std::string> batches()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _batches;
+    }
+
+  private:
+    bool _available;
+    bool _open;
+    int _numWaiting;
+    std::vector<std::string> _batches;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+};
+
+}  // anonymous namespace
+
+TEST(SpoolingTransport, testReplayAfterOutage)
+{
+    std::string path("/tmp/jaegertracing-spool-XXXXXX");
+    ::close(::mkstemp(&path[0]));
+
+    std::vector<std::string> batches;
+    auto available = false;
+    std::mutex mutex;
+    {
+        SpoolingTransport transport(
+            std::unique_ptr<Transport>(
+                new FakeTransport(batches, available, mutex)),
+            path,
+            1024,
+            std::chrono::milliseconds(1));
+        ASSERT_EQ(1024, transport.maxPacketSize());
+        transport.emitEncodedBatch("first", 5);
+        transport.emitEncodedBatch("second", 6);
+        ASSERT_EQ(2, static_cast<int>(transport.numSpooled()));
+    }
+
+    // A new process picks up the spooled batches once the agent is back.
+    SpoolingTransport transport(
+        std::unique_ptr<Transport>(
+            new FakeTransport(batches, available, mutex)),
+        path,
+        1024,
+        std::chrono::milliseconds(1));
+    ASSERT_EQ(2, static_cast<int>(transport.numSpooled()));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        available = true;
+    }
+    for (auto i = 0; i < 1000 && transport.numSpooled() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(0, static_cast<int>(transport.numSpooled()));
+    transport.emitEncodedBatch("third", 5);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::vector<std::string> expected = { "first", "second", "third" };
+    ASSERT_EQ(expected, batches);
+    ::unlink(path.c_str());
+}
+
+TEST(SpoolingTransport, testEmitWhileReplaying)
+{
+    std::string path("/tmp/jaegertracing-spool-XXXXXX");
+    ::close(::mkstemp(&path[0]));
+
+    auto* gated = new GatedTransport();
+    SpoolingTransport transport(std::unique_ptr<Transport>(gated),
+                                path,
+                                1024,
+                                std::chrono::milliseconds(1),
+                                std::chrono::milliseconds(0));
+    transport.emitEncodedBatch("first", 5);
+    ASSERT_TRUE(transport.lastBatchDeferred());
+    gated->setAvailable();
+    gated->waitForSend();
+
+    // The drain thread is stuck sending "first", reporting must not wait.
+    transport.emitEncodedBatch("second", 6);
+    ASSERT_TRUE(transport.lastBatchDeferred());
+    ASSERT_EQ(2, static_cast<int>(transport.numSpooled()));
+
+    gated->open();
+    for (auto i = 0; i < 1000 && transport.numSpooled() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(0, static_cast<int>(transport.numSpooled()));
+    transport.emitEncodedBatch("third", 5);
+    ASSERT_FALSE(transport.lastBatchDeferred());
+
+    const std::vector<std::string> expected = { "first", "second", "third" };
+    ASSERT_EQ(expected, gated->batches());
+    ::unlink(path.c_str());
+}
+
+TEST(SpoolingTransport, testFork)
+{
+    std::string path("/tmp/jaegertracing-spool-XXXXXX");
+    ::close(::mkstemp(&path[0]));
+
+    std::vector<std::string> batches;
+    auto available = false;
+    std::mutex mutex;
+    std::unique_ptr<SpoolingTransport> transport(new SpoolingTransport(
+        std::unique_ptr<Transport>(
+            new FakeTransport(batches, available, mutex)),
+        path,
+        1024,
+        std::chrono::hours(1)));
+    transport->emitEncodedBatch("first", 5);
+    ASSERT_EQ(1, static_cast<int>(transport->numSpooled()));
+
+    transport->prepareFork();
+    const auto pid = ::fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        transport->childAfterFork();
+        transport->resetAfterFork();
+        // The spool stays with the parent, so a failed batch is dropped.
+        auto dropped = false;
+        try {
+            transport->emitEncodedBatch("second", 6);
+        } catch (const std::system_error&) {
+            dropped = true;
+        }
+        const auto spooled = transport->numSpooled();
+        // Must not wait for the parent's drain thread.
+        transport.reset();
+        std::_Exit((dropped && spooled == 0) ? 0 : 1);
+    }
+    transport->parentAfterFork();
+
+    int status = 0;
+    ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+    ASSERT_EQ(1, static_cast<int>(transport->numSpooled()));
+    // The child closing its copy does not release the parent's lock.
+    ASSERT_THROW(SpoolFile(path, 1024), std::system_error);
+    transport.reset();
+    ::unlink(path.c_str());
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/StringPool.h"
+
+namespace jaegertracing {
+namespace utils {
+
+constexpr StringPool::ID StringPool::kNotInterned;
+constexpr size_t StringPool::kDefaultMaxSize;
+
+uint64_t StringPool::hash(opentracing::string_view str) noexcept
+{
+    // 64-bit FNV-1a. Operation names and tag keys are short, so this is
+    // cheaper than materializing a std::string for std::hash.
+    uint64_t hash = 14695981039346656037ull;
+    for (auto ch : str) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+StringPool::StringPool(size_t maxSize)
+    : _maxSize(maxSize)
+    , _mask(0)
+    , _slots()
+    , _size(0)
+    , _strings()
+    , _mutex()
+{
+    // At most half full, so probe sequences stay short and always end at
+    // an empty slot.
+    size_t numSlots = 16;
+    while (numSlots < 2 * maxSize) {
+        numSlots *= 2;
+    }
+    _mask = numSlots - 1;
+    _slots.reset(new Slot[numSlots]());
+}
+
+StringPool::Entry StringPool::intern(opentracing::string_view str)
+{
+    const auto strHash = hash(str);
+    const auto entry = find(str, strHash);
+    if (entry.first != kNotInterned) {
+        return entry;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Another thread may have inserted `str` since the lookup.
+    const auto inserted = find(str, strHash);
+    if (inserted.first != kNotInterned || _strings.size() >= _maxSize) {
+        return inserted;
+    }
+    _strings.emplace_back(str.data(), str.size());
+    const auto id = static_cast<ID>(_strings.size());
+    auto index = strHash & _mask;
+    while (_slots[index]._hashAndID.load(std::memory_order_relaxed) != 0) {
+        index = (index + 1) & _mask;
+    }
+    auto& slot = _slots[index];
+    slot._str = &_strings.back();
+    slot._hashAndID.store((strHash & 0xFFFFFFFF00000000ull) | id,
+                          std::memory_order_release);
+    _size.store(_strings.size(), std::memory_order_release);
+    return std::make_pair(id, slot._str);
+}
+
+StringPool::Entry StringPool::find(opentracing::string_view str,
+                                   uint64_t strHash) const
+{
+    const auto hashBits = strHash & 0xFFFFFFFF00000000ull;
+    for (auto index = strHash & _mask;; index = (index + 1) & _mask) {
+        const auto& slot = _slots[index];
+        const auto hashAndID =
+            slot._hashAndID.load(std::memory_order_acquire);
+        if (hashAndID == 0) {
+            return std::make_pair(kNotInterned, nullptr);
+        }
+        if ((hashAndID & 0xFFFFFFFF00000000ull) == hashBits &&
+            slot._str->size() == str.size() &&
+            slot._str->compare(0, str.size(), str.data(), str.size()) == 0) {
+            return std::make_pair(static_cast<ID>(hashAndID), slot._str);
+        }
+    }
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
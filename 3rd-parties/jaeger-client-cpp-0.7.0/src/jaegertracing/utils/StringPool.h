@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_UTILS_STRINGPOOL_H
+#define JAEGERTRACING_UTILS_STRINGPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <opentracing/string_view.h>
+
+namespace jaegertracing {
+namespace utils {
+
+// Thread-safe pool of immutable strings. Every distinct string is stored once
+// and given a small, dense numeric ID. Interned strings are never released,
+// so the references returned by `intern` stay valid as long as the pool
+// does. Once `maxSize` strings are interned the pool stops growing, which
+// keeps high-cardinality input from leaking memory.
+//
+// Lookups of interned strings take no lock: the index is a fixed-size open
+// addressing table sized for `maxSize` strings, whose slots are published
+// with release stores. Only inserts take the mutex.
+class StringPool {
+  public:
+    using ID = uint32_t;
+
+    static constexpr ID kNotInterned = 0;
+
+    static constexpr size_t kDefaultMaxSize = 10000;
+
+    using Entry = std::pair<ID, const std::string*>;
+
+    explicit StringPool(size_t maxSize = kDefaultMaxSize);
+
+    // Returns the ID and the pooled copy of `str`, or
+    // `{ kNotInterned, nullptr }` if `str` is new and the pool is full.
+    Entry intern(opentracing::string_view str);
+
+    size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    size_t maxSize() const { return _maxSize; }
+
+  private:
+    struct Slot {
+        // Upper half the string's hash, lower half its ID, zero if empty.
+        std::atomic<uint64_t> _hashAndID;
+        // Written before `_hashAndID` is published.
+        const std::string* _str;
+    };
+
+    static uint64_t hash(opentracing::string_view str) noexcept;
+
+    Entry find(opentracing::string_view str, uint64_t strHash) const;
+
+    size_t _maxSize;
+    size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<size_t> _size;
+    // Owns the pooled strings, only touched with `_mutex` held.
+    std::deque<std::string> _strings;
+    std::mutex _mutex;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_STRINGPOOL_H
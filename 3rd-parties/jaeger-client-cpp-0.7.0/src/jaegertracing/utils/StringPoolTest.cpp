@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/OperationName.h"
+#include "jaegertracing/utils/StringPool.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace jaegertracing {
+namespace utils {
+
+TEST(StringPool, testIntern)
+{
+    StringPool pool;
+    const auto first = pool.intern("op");
+    const auto second = pool.intern(std::string("op"));
+    ASSERT_NE(StringPool::kNotInterned, first.first);
+    ASSERT_EQ(first.first, second.first);
+    ASSERT_EQ(first.second, second.second);
+    ASSERT_EQ("op", *first.second);
+
+    const auto other = pool.intern("other");
+    ASSERT_NE(first.first, other.first);
+    ASSERT_EQ("other", *other.second);
+    ASSERT_EQ(2, pool.size());
+}
+
+TEST(StringPool, testMaxSize)
+{
+    StringPool pool(1);
+    ASSERT_NE(StringPool::kNotInterned, pool.intern("a").first);
+    ASSERT_NE(StringPool::kNotInterned, pool.intern("a").first);
+    const auto rejected = pool.intern("b");
+    ASSERT_EQ(StringPool::kNotInterned, rejected.first);
+    ASSERT_EQ(nullptr, rejected.second);
+    ASSERT_EQ(1, pool.size());
+}
+
+TEST(StringPool, testFullPoolLookup)
+{
+    constexpr auto kMaxSize = 1000;
+    StringPool pool(kMaxSize);
+    std::vector<StringPool::ID> ids;
+    for (auto i = 0; i < kMaxSize; ++i) {
+        ids.push_back(pool.intern("name-" + std::to_string(i)).first);
+        ASSERT_NE(StringPool::kNotInterned, ids.back());
+    }
+    for (auto i = 0; i < kMaxSize; ++i) {
+        const auto entry = pool.intern("name-" + std::to_string(i));
+        ASSERT_EQ(ids[i], entry.first);
+        ASSERT_EQ("name-" + std::to_string(i), *entry.second);
+    }
+    ASSERT_EQ(StringPool::kNotInterned, pool.intern("name-x").first);
+}
+
+TEST(StringPool, testConcurrentIntern)
+{
+    constexpr auto kNumThreads = 4;
+    constexpr auto kNumNames = 100;
+    StringPool pool;
+    std::vector<std::vector<StringPool::ID>> ids(kNumThreads);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&pool, &ids, i]() {
+            for (auto j = 0; j < kNumNames; ++j) {
+                ids[i].push_back(pool.intern(std::to_string(j)).first);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(kNumNames, pool.size());
+    for (auto i = 1; i < kNumThreads; ++i) {
+        ASSERT_EQ(ids[0], ids[i]);
+    }
+}
+
+}  // namespace utils
+
+TEST(OperationName, testHandle)
+{
+    const OperationName first("handle-op");
+    const OperationName second(std::string("handle-op"));
+    ASSERT_TRUE(first.isInterned());
+    ASSERT_EQ(first.id(), second.id());
+    ASSERT_EQ(&first.str(), &second.str());
+    ASSERT_EQ(first, second);
+    ASSERT_NE(first, OperationName("other-handle-op"));
+    ASSERT_EQ("handle-op", first.view());
+
+    const OperationName empty;
+    ASSERT_FALSE(empty.isInterned());
+    ASSERT_TRUE(empty.str().empty());
+}
+
+}  // namespace jaegertracing
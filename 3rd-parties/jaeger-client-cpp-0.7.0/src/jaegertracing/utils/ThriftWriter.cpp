@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/utils/ThriftWriter.h"
+
+#include <cassert>
+
+namespace jaegertracing {
+namespace utils {
+
+constexpr uint8_t ThriftWriter::kCompactTrue;
+constexpr uint8_t ThriftWriter::kCompactFalse;
+
+void ThriftWriter::writeMessageBegin(opentracing::string_view name,
+                                     MessageType type,
+                                     int32_t seqID)
+{
+    if (_protocol == Protocol::kCompact) {
+        constexpr uint8_t kProtocolID = 0x82;
+        constexpr uint8_t kVersion = 1;
+        constexpr auto kTypeShift = 5;
+        writeByte(kProtocolID);
+        writeByte(kVersion | (static_cast<uint8_t>(type) << kTypeShift));
+        writeVarint(static_cast<uint32_t>(seqID));
+        writeString(name);
+    }
+    else {
+        constexpr uint32_t kVersion1 = 0x80010000;
+        writeBigEndian(kVersion1 | static_cast<uint32_t>(type));
+        writeString(name);
+        writeBigEndian(static_cast<uint32_t>(seqID));
+    }
+}
+
+uint8_t ThriftWriter::compactType(Type type)
+{
+    switch (type) {
+    case Type::kBool:
+        return kCompactTrue;
+    case Type::kByte:
+        return 3;
+    case Type::kI16:
+        return 4;
+    case Type::kI32:
+        return 5;
+    case Type::kI64:
+        return 6;
+    case Type::kDouble:
+        return 7;
+    case Type::kString:
+        return 8;
+    case Type::kList:
+        return 9;
+    default:
+        assert(type == Type::kStruct);
+        return 12;
+    }
+}
+
+uint8_t ThriftWriter::binaryType(Type type)
+{
+    switch (type) {
+    case Type::kBool:
+        return 2;
+    case Type::kByte:
+        return 3;
+    case Type::kDouble:
+        return 4;
+    case Type::kI16:
+        return 6;
+    case Type::kI32:
+        return 8;
+    case Type::kI64:
+        return 10;
+    case Type::kString:
+        return 11;
+    case Type::kList:
+        return 15;
+    default:
+        assert(type == Type::kStruct);
+        return 12;
+    }
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JAEGERTRACING_UTILS_THRIFTWRITER_H
+#define JAEGERTRACING_UTILS_THRIFTWRITER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <opentracing/string_view.h>
+
+namespace jaegertracing {
+namespace utils {
+
+class EncodingCache;
+
+// Serializes Thrift values straight into a byte buffer using either the
+// compact or the binary protocol. It writes the same bytes as the generated
+// code driving TCompactProtocol/TBinaryProtocol, but needs no intermediate
+// thrift:: objects and never copies the buffer, so callers can encode
+// directly into the batch they are about to send.
+class ThriftWriter {
+  public:
+    enum class Protocol { kBinary, kCompact };
+
+    enum class Type {
+        kBool,
+        kByte,
+        kI16,
+        kI32,
+        kI64,
+        kDouble,
+        kString,
+        kStruct,
+        kList
+    };
+
+    enum class MessageType { kCall = 1, kReply = 2, kException = 3, kOneway = 4 };
+
+    ThriftWriter(Protocol protocol, std::string& buffer)
+        : _protocol(protocol)
+        , _buffer(&buffer)
+        , _lastFieldID(0)
+        , _fieldIDStack()
+        , _cache(nullptr)
+    {
+    }
+
+    Protocol protocol() const { return _protocol; }
+
+    std::string& buffer() { return *_buffer; }
+
+    const std::string& buffer() const { return *_buffer; }
+
+    // Optional cache of previously encoded values, owned by the caller.
+    // Encoders that find their value in it append the cached bytes.
+    void setCache(EncodingCache* cache) { _cache = cache; }
+
+    EncodingCache* cache() const { return _cache; }
+
+    void writeMessageBegin(opentracing::string_view name,
+                           MessageType type,
+                           int32_t seqID);
+
+    void writeStructBegin()
+    {
+        if (_protocol == Protocol::kCompact) {
+            _fieldIDStack.push_back(_lastFieldID);
+            _lastFieldID = 0;
+        }
+    }
+
+    // Writes the field stop marker and closes the struct.
+    void writeStructEnd()
+    {
+        writeByte(0);
+        if (_protocol == Protocol::kCompact) {
+            _lastFieldID = _fieldIDStack.back();
+            _fieldIDStack.pop_back();
+        }
+    }
+
+    void writeFieldBegin(Type type, int16_t id)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeCompactFieldHeader(compactType(type), id);
+        }
+        else {
+            writeByte(binaryType(type));
+            writeBigEndian(static_cast<uint16_t>(id));
+        }
+    }
+
+    // Booleans are folded into the field header by the compact protocol,
+    // so they get their own field writer.
+    void writeBoolField(int16_t id, bool value)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeCompactFieldHeader(value ? kCompactTrue : kCompactFalse, id);
+        }
+        else {
+            writeFieldBegin(Type::kBool, id);
+            writeByte(value ? 1 : 0);
+        }
+    }
+
+    void writeListBegin(Type elementType, uint32_t size)
+    {
+        if (_protocol == Protocol::kCompact) {
+            const auto type = compactType(elementType);
+            if (size < 15) {
+                writeByte(static_cast<uint8_t>(size << 4) | type);
+            }
+            else {
+                writeByte(0xf0 | type);
+                writeVarint(size);
+            }
+        }
+        else {
+            writeByte(binaryType(elementType));
+            writeBigEndian(size);
+        }
+    }
+
+    // Number of bytes `writeListBegin` emits for a list of `size` elements.
+    size_t listHeaderSize(uint32_t size) const
+    {
+        if (_protocol == Protocol::kBinary) {
+            return 1 + sizeof(uint32_t);
+        }
+        return size < 15 ? 1 : 1 + varintSize(size);
+    }
+
+    void writeBool(bool value)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeByte(value ? kCompactTrue : kCompactFalse);
+        }
+        else {
+            writeByte(value ? 1 : 0);
+        }
+    }
+
+    void writeByte(uint8_t value) { _buffer->push_back(static_cast<char>(value)); }
+
+    void writeI16(int16_t value)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeVarint(zigzag(static_cast<int32_t>(value)));
+        }
+        else {
+            writeBigEndian(static_cast<uint16_t>(value));
+        }
+    }
+
+    void writeI32(int32_t value)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeVarint(zigzag(value));
+        }
+        else {
+            writeBigEndian(static_cast<uint32_t>(value));
+        }
+    }
+
+    void writeI64(int64_t value)
+    {
+        if (_protocol == Protocol::kCompact) {
+            writeVarint(zigzag(value));
+        }
+        else {
+            writeBigEndian(static_cast<uint64_t>(value));
+        }
+    }
+
+    void writeDouble(double value)
+    {
+        static_assert(sizeof(double) == sizeof(uint64_t),
+                      "Thrift requires 64-bit doubles");
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (_protocol == Protocol::kCompact) {
+            for (auto i = 0; i < 8; ++i) {
+                writeByte(static_cast<uint8_t>(bits >> (8 * i)));
+            }
+        }
+        else {
+            writeBigEndian(bits);
+        }
+    }
+
+    void writeString(opentracing::string_view value)
+    {
+        const auto size = static_cast<uint32_t>(value.size());
+        if (_protocol == Protocol::kCompact) {
+            writeVarint(size);
+        }
+        else {
+            writeBigEndian(size);
+        }
+        _buffer->append(value.data(), value.size());
+    }
+
+  private:
+    static constexpr uint8_t kCompactTrue = 1;
+    static constexpr uint8_t kCompactFalse = 2;
+
+    static uint8_t compactType(Type type);
+
+    static uint8_t binaryType(Type type);
+
+    static uint32_t zigzag(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^
+               static_cast<uint32_t>(value >> 31);
+    }
+
+    static uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63);
+    }
+
+    static size_t varintSize(uint64_t value)
+    {
+        auto size = static_cast<size_t>(1);
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    void writeVarint(uint64_t value)
+    {
+        char bytes[10];
+        auto size = 0;
+        while (value >= 0x80) {
+            bytes[size++] = static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        bytes[size++] = static_cast<char>(value);
+        _buffer->append(bytes, size);
+    }
+
+    template <typename UnsignedType>
+    void writeBigEndian(UnsignedType value)
+    {
+        char bytes[sizeof(UnsignedType)];
+        for (auto i = sizeof(UnsignedType); i > 0; --i) {
+            bytes[i - 1] = static_cast<char>(value & 0xff);
+            value = static_cast<UnsignedType>(value >> 8);
+        }
+        _buffer->append(bytes, sizeof(bytes));
+    }
+
+    void writeCompactFieldHeader(uint8_t type, int16_t id)
+    {
+        const auto delta = static_cast<int>(id) - _lastFieldID;
+        if (delta > 0 && delta <= 15) {
+            writeByte(static_cast<uint8_t>(delta << 4) | type);
+        }
+        else {
+            writeByte(type);
+            writeI16(id);
+        }
+        _lastFieldID = id;
+    }
+
+    Protocol _protocol;
+    std::string* _buffer;
+    int16_t _lastFieldID;
+    std::vector<int16_t> _fieldIDStack;
+    EncodingCache* _cache;
+};
+
+}  // namespace utils
+}  // namespace jaegertracing
+
+#endif  // JAEGERTRACING_UTILS_THRIFTWRITER_H
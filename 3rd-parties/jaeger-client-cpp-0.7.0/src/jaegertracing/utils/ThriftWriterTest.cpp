@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jaegertracing/Span.h"
+#include "jaegertracing/Tracer.h"
+#include "jaegertracing/testutils/TracerUtil.h"
+#include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/ThriftWriter.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thrift/protocol/TBinaryProtocol.h>
+#include <thrift/protocol/TCompactProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+
+namespace jaegertracing {
+namespace utils {
+namespace {
+
+template <typename ThriftType>
+std::string serialize(const ThriftType& value,
+                      apache::thrift::protocol::TProtocolFactory& factory)
+{
+    std::shared_ptr<apache::thrift::transport::TMemoryBuffer> buffer(
+        new apache::thrift::transport::TMemoryBuffer());
+    auto protocol = factory.getProtocol(buffer);
+    value.write(protocol.get());
+    return buffer->getBufferAsString();
+}
+
+}  // anonymous namespace
+
+TEST(ThriftWriter, testCompactPrimitives)
+{
+    std::string buffer;
+    ThriftWriter writer(ThriftWriter::Protocol::kCompact, buffer);
+    writer.writeI32(-1);
+    writer.writeI64(150);
+    writer.writeString("ab");
+    writer.writeListBegin(ThriftWriter::Type::kStruct, 3);
+    writer.writeListBegin(ThriftWriter::Type::kStruct, 20);
+    ASSERT_EQ(std::string("\x01\xac\x02\x02" "ab" "\x3c\xfc\x14"), buffer);
+    ASSERT_EQ(1, static_cast<int>(writer.listHeaderSize(14)));
+    ASSERT_EQ(2, static_cast<int>(writer.listHeaderSize(15)));
+    ASSERT_EQ(3, static_cast<int>(writer.listHeaderSize(128)));
+}
+
+TEST(ThriftWriter, testSpanMatchesGeneratedCode)
+{
+    const auto handle = testutils::TracerUtil::installGlobalTracer();
+    const auto tracer =
+        std::static_pointer_cast<const Tracer>(opentracing::Tracer::Global());
+
+    auto parent = tracer->StartSpan("parent");
+    auto other = tracer->StartSpan("other");
+    auto span = tracer->StartSpan(
+        "test-span",
+        { opentracing::ChildOf(&parent->context()),
+          opentracing::FollowsFrom(&other->context()) });
+    span->SetTag("string", std::string("value"));
+    span->SetTag("literal", "value");
+    span->SetTag("double", 1.5);
+    span->SetTag("bool", false);
+    span->SetTag("int64", static_cast<int64_t>(-42));
+    span->SetTag("uint64", static_cast<uint64_t>(42));
+    span->SetTag("null", nullptr);
+    for (auto i = 0; i < 20; ++i) {
+        span->Log({ { "event", "test" }, { "index", i } });
+    }
+    span->Finish();
+    const auto& jaegerSpan = static_cast<const Span&>(*span);
+
+    thrift::Span thriftSpan;
+    jaegerSpan.thrift(thriftSpan);
+
+    apache::thrift::protocol::TCompactProtocolFactory compactFactory;
+    std::string compact;
+    ThriftWriter compactWriter(ThriftWriter::Protocol::kCompact, compact);
+    jaegerSpan.encode(compactWriter);
+    ASSERT_EQ(serialize(thriftSpan, compactFactory), compact);
+
+    apache::thrift::protocol::TBinaryProtocolFactory binaryFactory;
+    std::string binary;
+    ThriftWriter binaryWriter(ThriftWriter::Protocol::kBinary, binary);
+    jaegerSpan.encode(binaryWriter);
+    ASSERT_EQ(serialize(thriftSpan, binaryFactory), binary);
+}
+
+}  // namespace utils
+}  // namespace jaegertracing
@@ -19,6 +19,7 @@
 
 #include "jaegertracing/net/Socket.h"
 #include "jaegertracing/thrift-gen/jaeger_types.h"
+#include "jaegertracing/utils/ThriftWriter.h"
 
 namespace jaegertracing {
 namespace utils {
@@ -34,8 +35,34 @@ class Transport {
 
     virtual void emitBatch(const thrift::Batch& batch) = 0;
 
+    // Sends a batch already serialized with `encodedProtocol()`, framed by
+    // `writeBatchPrefix` and `writeBatchSuffix`.
+    virtual void emitEncodedBatch(const char* data, size_t size) = 0;
+
+    // True if the last batch passed to `emitEncodedBatch` was stored for a
+    // later retry instead of being sent.
+    virtual bool lastBatchDeferred() const { return false; }
+
+    virtual ThriftWriter::Protocol encodedProtocol() const = 0;
+
+    virtual void writeBatchPrefix(ThriftWriter& writer) const {}
+
+    virtual void writeBatchSuffix(ThriftWriter& writer) const {}
+
     int maxPacketSize() const { return _maxPacketSize; }
 
+    // fork() handlers, see Sender. A transport shared with its own threads
+    // holds their locks from prepareFork() until the handler after fork.
+    virtual void prepareFork() {}
+
+    virtual void parentAfterFork() {}
+
+    virtual void childAfterFork() {}
+
+    // Called in a forked child before the next batch. Datagram sockets may
+    // be shared with the parent, connections and files must not be.
+    virtual void resetAfterFork() {}
+
     void close() { _socket.close(); }
 
     virtual std::unique_ptr<apache::thrift::protocol::TProtocolFactory>
@@ -62,14 +62,38 @@ class UDPTransporter : public Transport {
                 << batch.spans.size();
             throw std::logic_error(oss.str());
         }
-        const auto numWritten = ::send(_socket.handle(), reinterpret_cast<char*>(data), sizeof(uint8_t) * size, 0);
-        if (static_cast<unsigned>(numWritten) != size) {
+        send(reinterpret_cast<char*>(data), size);
+    }
+
+    void emitEncodedBatch(const char* data, size_t size) override
+    {
+        if (size > static_cast<size_t>(_maxPacketSize)) {
             std::ostringstream oss;
-            oss << "Failed to write message"
-                   ", numWritten="
-                << numWritten << ", size=" << size;
-            throw std::system_error(errno, std::system_category(), oss.str());
+            oss << "Data does not fit within one UDP packet"
+                   ", size "
+                << size << ", max " << _maxPacketSize;
+            throw std::logic_error(oss.str());
         }
+        send(data, size);
+    }
+
+    ThriftWriter::Protocol encodedProtocol() const override
+    {
+        return ThriftWriter::Protocol::kCompact;
+    }
+
+    // Frames the batch as a oneway Agent.emitBatch call.
+    void writeBatchPrefix(ThriftWriter& writer) const override
+    {
+        writer.writeMessageBegin(
+            "emitBatch", ThriftWriter::MessageType::kOneway, 0);
+        writer.writeStructBegin();
+        writer.writeFieldBegin(ThriftWriter::Type::kStruct, 1);
+    }
+
+    void writeBatchSuffix(ThriftWriter& writer) const override
+    {
+        writer.writeStructEnd();
     }
 
   std::unique_ptr< apache::thrift::protocol::TProtocolFactory > protocolFactory() const override {
@@ -77,6 +101,18 @@ class UDPTransporter : public Transport {
   }
 
   private:
+    void send(const char* data, size_t size)
+    {
+        const auto numWritten = ::send(_socket.handle(), data, size, 0);
+        if (static_cast<size_t>(numWritten) != size) {
+            std::ostringstream oss;
+            oss << "Failed to write message"
+                   ", numWritten="
+                << numWritten << ", size=" << size;
+            throw std::system_error(errno, std::system_category(), oss.str());
+        }
+    }
+
     std::shared_ptr<apache::thrift::transport::TMemoryBuffer> _buffer;
     net::IPAddress _serverAddr;
     std::unique_ptr<agent::thrift::AgentClient> _client;